@@ -5,52 +5,70 @@
 #include <fstream>
 #include <stdlib.h>
 #include <algorithm>
+#include <cctype>
 
+#include "bdddump.h"
 #include "dddmp.h"
 
 Certificate::Certificate(Task *task)
-    : task(task), manager(Cudd(task->get_number_of_facts()*2,0)) {
+    : task(task), manager(Cudd(task->get_number_of_facts()*2,0)),
+      next_bdd_file(0), bdd_stream(NULL) {
     if(g_timeout > 0) {
         manager.SetTimeLimit(g_timeout*1000 - timer());
     }
     manager.setTimeoutHandler(exit_timeout);
 
-    permutation.resize(task->get_number_of_facts()*2, -1);
     manager.InstallOutOfMemoryHandler(exit_oom);
 
+    std::vector<int> varorder(task->get_number_of_facts());
+    for (int i = 0; i < task->get_number_of_facts(); ++i) {
+        varorder[i] = i;
+    }
+    // move variables so the primed versions are in between
+    compose = interleaved_compose(varorder);
+    transitions = BDDTransitionRelation(manager, varorder);
     for (size_t i = 0; i < task->get_number_of_actions(); ++i) {
         const Action &action = task->get_action(i);
-        BDD pre = manager.bddOne();
-        for (int var : action.pre) {
-            pre *= manager.bddVar(var*2);
-        }
-        BDD eff = manager.bddOne();
-        for (size_t var = 0; var < action.change.size(); ++var) {
-            if (action.change[var] == 0) {
-                continue;
-            } else if (action.change[var] == 1) {
-                eff *= manager.bddVar(var*2);
-            } else {
-                eff *= !manager.bddVar(var*2);
-            }
-        }
-        bdd_actions.emplace_back(BDDAction(pre, eff));
+        transitions.add_action(action.pre, action.change);
     }
 }
 
 Certificate::~Certificate() {
-
+    if(bdd_stream) {
+        fclose(bdd_stream);
+    }
 }
 
 
-void Certificate::parse_bdd_file(std::string bddfile) {
-    print_info("reading in bdd file " + bddfile);
+bool Certificate::read_bdd_block(FILE *fp, std::vector<int> &indices) {
+    int amount = -1;
+    if(fscanf(fp, "%d", &amount) != 1) {
+        return false;
+    }
+    assert(amount > 0);
+    indices.assign(amount, -1);
+    for(int i = 0; i < amount; ++i) {
+        int res = fscanf(fp, "%d", &indices[i]);
+        assert(res == 1);
+        assert(indices[i] >= 0 && certificate.find(indices[i]) == certificate.end());
+    }
+    long size = -1;
+    if(read_binary_dump_header(fp, size) && size < 0) {
+        std::cout << "invalid binary dump in bdd file" << std::endl;
+        exit_with(ExitCode::CRITICAL_ERROR);
+    }
 
-    // move variables so the primed versions are in between
-    int compose[task->get_number_of_facts()];
-    for(int i = 0; i < task->get_number_of_facts(); ++i) {
-        compose[i] = 2*i;
+    std::vector<DdNode *> roots = load_bdd_dump(manager.getManager(), fp, size, compose);
+    assert(roots.size() == amount);
+    for (size_t i = 0; i < roots.size(); i++) {
+        certificate[indices[i]] = CertEntry(BDD(manager, roots[i]), false);
+        Cudd_RecursiveDeref(manager.getManager(), roots[i]);
     }
+    return true;
+}
+
+void Certificate::parse_bdd_file(std::string bddfile) {
+    print_info("reading in bdd file " + bddfile);
 
     FILE *fp;
     fp = fopen(bddfile.c_str(), "r");
@@ -59,29 +77,45 @@ void Certificate::parse_bdd_file(std::string bddfile) {
         exit_with(ExitCode::CRITICAL_ERROR);
     }
 
-    int amount = -1;
-    while(fscanf(fp, "%d", &amount) == 1) {
-        assert(amount > 0);
-        std::vector<int> indices = std::vector<int>(amount, -1);
-        for(int i = 0; i < amount; ++i) {
-            int res = fscanf(fp, "%d", &indices[i]);
-            assert(res == 1);
-            assert(indices[i] >= 0 && certificate.find(indices[i]) == certificate.end());
+    std::vector<int> indices;
+    while(read_bdd_block(fp, indices)) {}
+    fclose(fp);
+
+    print_info("finished reading in bdd file " + bddfile);
+}
+
+void Certificate::restart_bdd_stream() {
+    if(bdd_stream) {
+        fclose(bdd_stream);
+        bdd_stream = NULL;
+    }
+    next_bdd_file = 0;
+}
+
+bool Certificate::load_next_bdds(std::vector<int> &indices) {
+    while(!bdd_stream || !read_bdd_block(bdd_stream, indices)) {
+        if(bdd_stream) {
+            fclose(bdd_stream);
+            bdd_stream = NULL;
+        }
+        if(next_bdd_file == bdd_files.size()) {
+            return false;
         }
-        DdNode **tmpArray;
-        int nRoots = Dddmp_cuddBddArrayLoad(manager.getManager(),DDDMP_ROOT_MATCHLIST,NULL,
-            DDDMP_VAR_COMPOSEIDS,NULL,NULL,&compose[0],DDDMP_MODE_TEXT,NULL,fp,&tmpArray);
-        assert(nRoots == amount);
-
-        for (int i=0; i<nRoots; i++) {
-            certificate[indices[i]] = CertEntry(BDD(manager, tmpArray[i]), false);
-            Cudd_RecursiveDeref(manager.getManager(), tmpArray[i]);
+        const std::string &bddfile = bdd_files[next_bdd_file++];
+        print_info("streaming bdd file " + bddfile);
+        bdd_stream = fopen(bddfile.c_str(), "r");
+        if(!bdd_stream) {
+            std::cout << "could not open bdd file" << std::endl;
+            exit_with(ExitCode::CRITICAL_ERROR);
         }
-        FREE(tmpArray);
-        amount = -1;
     }
+    return true;
+}
 
-    print_info("finished reading in bdd file " + bddfile);
+void Certificate::transfer_certificate(const Certificate &other) {
+    for(CertMap::const_iterator it = other.certificate.begin(); it != other.certificate.end(); ++it) {
+        certificate[it->first] = CertEntry(it->second.bdd.Transfer(manager), it->second.covered);
+    }
 }
 
 //TODO: move?
@@ -95,6 +129,49 @@ BDD Certificate::build_bdd_from_cube(const Cube &cube) {
 }
 
 
+bool Certificate::is_covered_by_union(const BDD &set, int r, bool complement) {
+    if(set.IsZero()) {
+        return true;
+    } else if(r == 0) {
+        return false;
+    }
+
+    std::vector<char> cube(manager.ReadSize());
+    Cudd_bddPickOneCube(manager.getManager(), set.getNode(), cube.data());
+    std::vector<int> state(cube.size());
+    for(size_t i = 0; i < cube.size(); ++i) {
+        state[i] = (cube[i] == 1) ? 1 : 0;
+    }
+    DdNode *one = Cudd_ReadOne(manager.getManager());
+
+    // pairs of the amount of covered states and the bdd
+    std::vector<std::pair<double, BDD>> candidates;
+    for(CertMap::iterator it = certificate.begin(); it != certificate.end(); ++it) {
+        BDD candidate = complement ? !it->second.bdd : it->second.bdd;
+        if(Cudd_Eval(manager.getManager(), candidate.getNode(), state.data()) != one) {
+            continue;
+        }
+        if(r == 1) {
+            if(set.Leq(candidate)) {
+                return true;
+            }
+            continue;
+        }
+        double covered = (set * candidate).CountMinterm(task->get_number_of_facts());
+        candidates.push_back(std::make_pair(covered, candidate));
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const std::pair<double, BDD> &c1, const std::pair<double, BDD> &c2) {
+        return c1.first > c2.first;
+    });
+    for(const std::pair<double, BDD> &candidate : candidates) {
+        if(is_covered_by_union(set * !candidate.second, r-1, complement)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 bool Certificate::is_certificate_for(const Cube &s) {
     print_info("checking if certificate contains state");
     bool has_s = contains_state(s);
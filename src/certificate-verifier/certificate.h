@@ -9,6 +9,7 @@
 #include "global_funcs.h"
 
 #include "cuddObj.hh"
+#include "bddtransitionrelation.h"
 
 struct CertEntry {
     BDD bdd;
@@ -17,12 +18,6 @@ struct CertEntry {
     CertEntry(BDD _bdd, bool _covered) : bdd(_bdd), covered(_covered) {}
 };
 
-struct BDDAction {
-    BDD pre;
-    BDD eff;
-    BDDAction(BDD pre, BDD eff) : pre(pre), eff(eff) {}
-};
-
 typedef std::unordered_map<int, CertEntry> CertMap;
 
 class Certificate {
@@ -30,11 +25,38 @@ protected:
   Task* task;
   Cudd manager;
   CertMap certificate;
-  // array needed for permuting bdds to primed version
-  std::vector<int> permutation;
+  // loads the dumped bdds such that the primed variables are in between
+  std::vector<int> compose;
+  // reads the next block of bdds of fp into the certificate; returns false at the end of the file
+  bool read_bdd_block(FILE *fp, std::vector<int> &indices);
   void parse_bdd_file(std::string bddfile);
-  std::vector<BDDAction> bdd_actions;
+
+  /*
+   * When streaming, the bdd files are not parsed up front. Instead, the bdds
+   * are loaded block by block (in the order of bdd_files) and the caller
+   * erases them from the certificate once they are not needed anymore, so
+   * only a window of the certificate is in memory at any time.
+   */
+  std::vector<std::string> bdd_files;
+  size_t next_bdd_file;
+  FILE *bdd_stream;
+  // starts reading bdd_files from the beginning again
+  void restart_bdd_stream();
+  // returns false if all bdd files have been read
+  bool load_next_bdds(std::vector<int> &indices);
+  // copies all bdds of other into the manager of this certificate
+  void transfer_certificate(const Certificate &other);
+  BDDTransitionRelation transitions;
   BDD build_bdd_from_cube(const Cube &cube);
+  /*
+   * Checks if set is contained in the union of at most r sets, each of which
+   * is a bdd of the certificate (or its complement if complement is true).
+   * Instead of enumerating all combinations of r bdds, we pick one state of
+   * the part of set that is not covered yet: since some set of the union must
+   * contain it, only the bdds containing this state need to be tried as next
+   * set. These are tried in the order of how much of set they cover.
+   */
+  bool is_covered_by_union(const BDD &set, int r, bool complement);
 public:
   Certificate(Task *task);
   virtual ~Certificate();
@@ -3,7 +3,9 @@
 #include "dddmp.h"
 #include "cudd.h"
 
+#include <algorithm>
 #include <iostream>
+#include <iterator>
 #include <fstream>
 #include <stdio.h>
 #include <cassert>
@@ -11,7 +13,7 @@
 #include <sstream>
 
 ConjunctiveCertificate::ConjunctiveCertificate(Task *task, std::ifstream &stream, int r_)
-    :  Certificate(task), r(r_) {
+    :  Certificate(task), r(r_), relevant_actions_computed(false) {
 
     //oftenly used variables
     std::string line;
@@ -41,81 +43,39 @@ ConjunctiveCertificate::ConjunctiveCertificate(Task *task, std::ifstream &stream
         std::cout << "Hint file: " << hint_file << std::endl;
         hint_stream.open(hint_file);
     }
-
-    //initialize lastits (stores the last r map iterators)
-    lastits.resize(r);
-    CertMap::iterator it = certificate.begin();
-    for(int i = 0; i < certificate.size() - r; ++i) {
-        it++;
-    }
-    for(int i = 0; i < r; ++i) {
-        lastits[i] = it++;
-    }
-
 }
 
-void ConjunctiveCertificate::initialize_itvec(std::vector<CertMap::iterator> &itvec) {
-    CertMap::iterator it = certificate.begin();
-    itvec.resize(r, it);
-    for(int i = 0; i < r; ++i) {
-        itvec[i] = it++;
-    }
+/*
+ * The successors of a conjunction under a are contained in bdd iff the conjunction
+ * excludes all states whose successor under a lies outside of bdd. Each conjunct
+ * excludes the states in its complement.
+ */
+bool ConjunctiveCertificate::is_covered_by_r(BDD &bdd, int a) {
+    BDD leaving = transitions.preimage(!bdd, a);
+    return is_covered_by_union(leaving, r, true);
 }
 
 /*
- * This function returns the next ordered permutation of itvec. It returns false if there
- * is no next permutation. One can think of it as "counting up":
- * It checks starting from the end of itvec if the iterator has the highest possible "value"
- * (lastit stores this "value" - for the last element it is the last iterator etc).
- * When it has found a position where this is not the case it increments this iterator by one
- * and sets all subsequent iterator to one higher than the preceeding one.
- * Example with numbers instead of iterators:
- * Input: itvec: 1 5 6 7, lastits: 4 5 6 7 -> itvec changed to 2 3 4 5 and return true
- *
- * sidenote: itvec and lastits must have size r!
+ * An action that is not applicable in some bdd of the certificate is not
+ * applicable in their conjunction, so it has no successors to check.
  */
-bool ConjunctiveCertificate::next_permutation(std::vector<CertMap::iterator>& itvec, std::vector<CertMap::iterator>& lastits) {
-    int pos = r-1;
-    while(itvec[pos] == lastits[pos]) {
-        pos--;
+const std::vector<int> &ConjunctiveCertificate::get_relevant_actions() {
+    if(!relevant_actions_computed) {
+        relevant_actions.resize(task->get_number_of_actions());
+        for(size_t i = 0; i < relevant_actions.size(); ++i) {
+            relevant_actions[i] = i;
         }
-    if(pos < 0) {
-        return false;
-    } else {
-        itvec[pos]++;
-        for(pos = pos+1; pos < r; pos++) {
-            itvec[pos] = itvec[pos-1];
-            itvec[pos]++;
+        for(CertMap::iterator it = certificate.begin(); it != certificate.end(); ++it) {
+            std::vector<int> applicable = transitions.get_applicable_actions(it->second.bdd);
+            std::vector<int> intersection;
+            std::set_intersection(relevant_actions.begin(), relevant_actions.end(),
+                                  applicable.begin(), applicable.end(),
+                                  std::back_inserter(intersection));
+            relevant_actions.swap(intersection);
         }
+        relevant_actions_computed = true;
     }
-    return true;
-}
-
-bool ConjunctiveCertificate::is_covered_by_r(BDD &bdd, int a) {
-    std::vector<CertMap::iterator> itvec;
-    initialize_itvec(itvec);
-    const Action &action = task->get_action(a);
-    do {
-        BDD conjunction = manager.bddOne();
-        for(int i = 0; i < itvec.size(); ++i) {
-            conjunction = conjunction * itvec[i]->second.bdd;
-        }
-        BDD succ = conjunction * bdd_actions[a].pre;
-        for (int var = 0; var < task->get_number_of_facts(); ++var) {
-            if (action.change[var] != 0) {
-                permutation[2*var] = 2*var+1;
-                permutation[2*var+1] = 2*var;
-            } else {
-                permutation[2*var] = 2*var;
-                permutation[2*var+1] = 2*var+1;
-            }
-        }
-        succ = succ.Permute(&permutation[0])*bdd_actions[a].eff;
-        if(succ.Leq(bdd)) {
-            return true;
-        }
-    } while(next_permutation(itvec, lastits));
-    return false;
+    return relevant_actions;
 }
 
 bool ConjunctiveCertificate::contains_state(const Cube &state) {
@@ -131,23 +91,10 @@ bool ConjunctiveCertificate::contains_state(const Cube &state) {
 
 bool ConjunctiveCertificate::contains_goal() {
     BDD goalbdd = build_bdd_from_cube(task->get_goal());
-    BDD notgoal = !goalbdd;
 
     //TODO: figure out how we can add hint for this!
-    std::vector<CertMap::iterator> itvec;
-    initialize_itvec(itvec);
-
-    do {
-        BDD conjunction = manager.bddOne();
-        for(int i = 0; i < itvec.size(); ++i) {
-            conjunction = conjunction * itvec[i]->second.bdd;
-        }
-        if (conjunction.Leq(notgoal)) {
-            return false;
-        }
-    } while(next_permutation(itvec, lastits));
-
-    return true;
+    // some r-conjunction refutes goal inclusion iff the complements of its bdds cover the goal
+    return !is_covered_by_union(goalbdd, r, true);
 }
 
 bool ConjunctiveCertificate::check_hints() {
@@ -157,6 +104,7 @@ bool ConjunctiveCertificate::check_hints() {
     int action = -1;
     int index = -1;
     std::vector<int> hints = std::vector<int>(task->get_number_of_actions(), -1);
+    std::vector<int> hinted_actions;
 
     std::getline(hint_stream, line);
     while(line.compare("end hints") != 0) {
@@ -171,38 +119,31 @@ bool ConjunctiveCertificate::check_hints() {
             assert(action >=0);
             ss >> hints[action];
             assert(hints[action] >= 0);
+            hinted_actions.push_back(action);
             action = -1;
         }
         hint_amount = -1;
 
         // check inductivity for the bdd with given index
         BDD cert_i = certificate[index].bdd;
-        for(size_t i = 0; i < task->get_number_of_actions(); ++i) {
-            const Action &action = task->get_action(i);
+        for(int i : get_relevant_actions()) {
             // if a hint is given, the sucessor of the hint must be included by bdd[index]
             if(hints[i] >= 0) {
-                BDD succ = certificate[hints[i]].bdd * bdd_actions[i].pre;
-                for (int var = 0; var < task->get_number_of_facts(); ++var) {
-                    if (action.change[var] != 0) {
-                        permutation[2*var] = 2*var+1;
-                        permutation[2*var+1] = 2*var;
-                    } else {
-                        permutation[2*var] = 2*var;
-                        permutation[2*var+1] = 2*var+1;
-                    }
-                }
-                succ = succ.Permute(&permutation[0])*bdd_actions[i].eff;
+                BDD succ = transitions.image(certificate[hints[i]].bdd, i);
                 if(!succ.Leq(cert_i)) {
                     return false;
                 }
-                // reset hint vector
-                hints[i] = -1;
             // if no hint is given, check if the bdd is r-inductive
             // if not, the certificate is not valid
             } else if (!(is_covered_by_r(cert_i, i))) {
                 return false;
             }
         }
+        // reset hint vector
+        for(int a : hinted_actions) {
+            hints[a] = -1;
+        }
+        hinted_actions.clear();
         // set bdd as covered
         certificate[index].covered = true;
         index = -1;
@@ -230,8 +171,8 @@ bool ConjunctiveCertificate::is_inductive() {
             continue;
         }
 
-        // bdd is not covered -> loop over all actions and check if its r-inductive
-        for(size_t i = 0; i < task->get_number_of_actions(); ++i) {
+        // bdd is not covered -> loop over all relevant actions and check if its r-inductive
+        for(int i : get_relevant_actions()) {
             if(!(is_covered_by_r(it->second.bdd, i))) {
                 return false;
             }
@@ -15,14 +15,14 @@ private:
    int r;
    std::ifstream hint_stream;
    bool has_hints;
-   std::vector<CertMap::iterator> lastits;
+   std::vector<int> relevant_actions;
+   bool relevant_actions_computed;
 
    bool check_hints();
+   // the (sorted) actions applicable in all bdds of the certificate
+   const std::vector<int> &get_relevant_actions();
 
-   void initialize_itvec(std::vector<CertMap::iterator>& itvec);
-   bool next_permutation(std::vector<CertMap::iterator>& itvec, std::vector<CertMap::iterator>& lastits);
-
-   // checks if any disjunction over r BDDs coveres the successor_bdd
+   // checks if the successors of any conjunction over r BDDs under action a are contained in bdd
    bool is_covered_by_r(BDD &bdd, int a);
 public:
   ConjunctiveCertificate(Task *task, std::ifstream &stream, int r);
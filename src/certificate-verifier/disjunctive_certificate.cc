@@ -9,9 +9,15 @@
 #include <cassert>
 #include <stdlib.h>
 #include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <unordered_map>
 
-DisjunctiveCertificate::DisjunctiveCertificate(Task *task, std::ifstream &stream, int r_)
-    :  Certificate(task), r(r_) {
+DisjunctiveCertificate::DisjunctiveCertificate(Task *task, std::ifstream &stream, int r_, int threads,
+                                               bool streaming)
+    :  Certificate(task), r(r_), threads(threads), streaming(streaming) {
 
     //oftenly used variables
     std::string line;
@@ -27,7 +33,14 @@ DisjunctiveCertificate::DisjunctiveCertificate(Task *task, std::ifstream &stream
     for(int i = 0; i < amount; ++i) {
         std::string certificate_file;
         std::getline(stream, certificate_file);
-        parse_bdd_file(certificate_file);
+        if(streaming) {
+            bdd_files.push_back(certificate_file);
+        } else {
+            parse_bdd_file(certificate_file);
+        }
+    }
+    if(streaming && threads > 1) {
+        std::cout << "streaming the certificate, ignoring threads" << std::endl;
     }
 
     if(std::getline(stream, line)) {
@@ -42,165 +55,358 @@ DisjunctiveCertificate::DisjunctiveCertificate(Task *task, std::ifstream &stream
         hint_stream.open(hint_file);
     }
 
-    //initialize lastits (stores the last r map iterators)
-    lastits.resize(r);
-    CertMap::iterator it = certificate.begin();
-    for(int i = 0; i < certificate.size() - r; ++i) {
-        it++;
+}
+
+DisjunctiveCertificate::DisjunctiveCertificate(const DisjunctiveCertificate &other)
+    : Certificate(other.task), r(other.r), threads(1), streaming(false), has_hints(false) {
+    transfer_certificate(other);
+}
+
+bool DisjunctiveCertificate::is_covered_by_r(BDD &successor_bdd) {
+    return is_covered_by_union(successor_bdd, r, false);
+}
+
+bool DisjunctiveCertificate::some_bdd(const std::function<bool(const BDD &)> &property) {
+    if(!streaming) {
+        for(CertMap::iterator it = certificate.begin(); it != certificate.end(); ++it) {
+            if(property(it->second.bdd)) {
+                return true;
+            }
+        }
+        return false;
     }
-    for(int i = 0; i < r; ++i) {
-        lastits[i] = it++;
+
+    restart_bdd_stream();
+    std::vector<int> loaded;
+    bool found = false;
+    while(!found && load_next_bdds(loaded)) {
+        for(int index : loaded) {
+            found = found || property(certificate[index].bdd);
+        }
+        for(int index : loaded) {
+            certificate.erase(index);
+        }
     }
+    return found;
+}
 
+bool DisjunctiveCertificate::contains_state(const Cube &state) {
+    BDD statebdd = build_bdd_from_cube(state);
+    return some_bdd([&statebdd](const BDD &bdd) {
+        return statebdd.Leq(bdd);
+    });
 }
 
-void DisjunctiveCertificate::initialize_itvec(std::vector<CertMap::iterator> &itvec) {
-    CertMap::iterator it = certificate.begin();
-    itvec.resize(r, it);
-    for(int i = 0; i < r; ++i) {
-        itvec[i] = it++;
-    }
+bool DisjunctiveCertificate::contains_goal() {
+    BDD goalbdd = build_bdd_from_cube(task->get_goal());
+    BDD notgoal = !goalbdd;
+    //each part of the union must contain no goal states
+    return some_bdd([&notgoal](const BDD &bdd) {
+        return !bdd.Leq(notgoal);
+    });
 }
 
 /*
- * This function returns the next ordered permutation of itvec. It returns false if there
- * is no next permutation. One can think of it as "counting up":
- * It checks starting from the end of itvec if the iterator has the highest possible "value"
- * (lastit stores this "value" - for the last element it is the last iterator etc).
- * When it has found a position where this is not the case it increments this iterator by one
- * and sets all subsequent iterator to one higher than the preceeding one.
- * Example with numbers instead of iterators:
- * Input: itvec: 1 5 6 7, lastits: 4 5 6 7 -> itvec changed to 2 3 4 5 and return true
- *
- * sidenote: itvec and lastits must have size r!
+ * Hint files start with a line "grouped hints" if the hints are given for bdds
+ * representing several states. Each following line up to "end hints" then has
+ * the form
+ * <index> <#actions> (<action> <#targets> <target>*)*
+ * and states that the successors of bdd[index] under action are contained in the
+ * union of the target bdds. Otherwise, each line has the form
+ * <index> <#actions> (<action> <target>)*
+ * with exactly one target per action. A target of -1 (or a hint that does not
+ * hold) means that we need to check self- or r-inductivity for this action as
+ * without hint.
  */
-bool DisjunctiveCertificate::next_permutation(std::vector<CertMap::iterator>& itvec, std::vector<CertMap::iterator>& lastits) {
-    int pos = r-1;
-    while(itvec[pos] == lastits[pos]) {
-        pos--;
-        }
-    if(pos < 0) {
+bool DisjunctiveCertificate::read_hint_line(bool grouped, Hints &hints) {
+    // reset the targets of the last line
+    for(int a : hints.hinted_actions) {
+        hints.targets[a].clear();
+    }
+    hints.hinted_actions.clear();
+
+    std::string line;
+    if(!std::getline(hint_stream, line) || line.compare("end hints") == 0) {
         return false;
-    } else {
-        itvec[pos]++;
-        for(pos = pos+1; pos < r; pos++) {
-            itvec[pos] = itvec[pos-1];
-            itvec[pos]++;
+    }
+    std::stringstream ss(line);
+    int hint_amount = -1;
+    int action = -1;
+    int target_amount = 1;
+    ss >> hints.index;
+    assert(hints.index >= 0);
+    ss >> hint_amount;
+    assert(hint_amount >= 0);
+    for(int i = 0; i < hint_amount; ++i) {
+        ss >> action;
+        assert(action >= 0);
+        if(grouped) {
+            ss >> target_amount;
+            assert(target_amount >= 0);
         }
+        hints.targets[action].resize(target_amount);
+        for(int j = 0; j < target_amount; ++j) {
+            ss >> hints.targets[action][j];
+        }
+        hints.hinted_actions.push_back(action);
     }
     return true;
 }
 
-bool DisjunctiveCertificate::is_covered_by_r(BDD &successor_bdd) {
-    std::vector<CertMap::iterator> itvec;
-    initialize_itvec(itvec);
-    int count = 0;
-    do {
-        count++;
-        BDD disjunction = manager.bddZero();
-        for(int i = 0; i < itvec.size(); ++i) {
-            disjunction = disjunction + itvec[i]->second.bdd;
-        }
-        disjunction.Permute(&permutation[0]);
-        if(successor_bdd.Leq(disjunction)) {
-            return true;
+bool DisjunctiveCertificate::check_hint_line(const Hints &hints) {
+    BDD cert_i = certificate[hints.index].bdd;
+    // loop over actions (the others have no successors)
+    for(int i : transitions.get_applicable_actions(cert_i)) {
+        BDD succ = transitions.image(cert_i, i);
+        bool hint_holds = !hints.targets[i].empty();
+        BDD target_union = manager.bddZero();
+        for(int target : hints.targets[i]) {
+            if(target < 0) {
+                hint_holds = false;
+                break;
+            }
+            target_union = target_union + certificate[target].bdd;
+        }
+        hint_holds = hint_holds && succ.Leq(target_union);
+        if (!hint_holds && !(succ.Leq(cert_i)) && !(is_covered_by_r(succ))) {
+            return false;
         }
-    } while(next_permutation(itvec, lastits));
-    return false;
+    }
+    return true;
 }
 
-bool DisjunctiveCertificate::contains_state(const Cube &state) {
-    BDD statebdd = build_bdd_from_cube(state);
+bool DisjunctiveCertificate::read_hint_header() {
+    std::string line;
+    std::streampos start = hint_stream.tellg();
+    std::getline(hint_stream, line);
+    bool grouped = (line.compare("grouped hints") == 0);
+    if(!grouped) {
+        hint_stream.seekg(start);
+    }
+    return grouped;
+}
 
-    for(CertMap::iterator it = certificate.begin(); it != certificate.end(); ++it) {
-        if(statebdd.Leq(it->second.bdd)) {
-            return true;
+bool DisjunctiveCertificate::check_hints() {
+    bool grouped = read_hint_header();
+    Hints hints(task->get_number_of_actions());
+    while(read_hint_line(grouped, hints)) {
+        if(!check_hint_line(hints)) {
+            return false;
         }
+        // set bdd as covered
+        certificate[hints.index].covered = true;
     }
-    return false;
+    hint_stream.close();
+    return true;
 }
 
-bool DisjunctiveCertificate::contains_goal() {
-    BDD goalbdd = build_bdd_from_cube(task->get_goal());
-    BDD notgoal = !goalbdd;
-
-    for(CertMap::iterator it = certificate.begin(); it != certificate.end(); ++it) {
-        //each part of the union must contain no goal states
-        if(!it->second.bdd.Leq(notgoal)) {
+bool DisjunctiveCertificate::is_entry_inductive(int index) {
+    /*
+     * Successors are first computed for whole groups of actions; only if they
+     * are not self-inductive we need to check r-inductivity for each action.
+     * Actions that are not applicable in the bdd are skipped.
+     */
+    BDD cert_i = certificate[index].bdd;
+    return transitions.check_applicable_images(cert_i,
+        [this, &cert_i](const BDD &succ, const std::vector<int> &actions) {
+            if (succ.Leq(cert_i)) {
+                return true;
+            }
+            if (actions.size() == 1) {
+                BDD single_succ = succ;
+                return is_covered_by_r(single_succ);
+            }
+            for (int a : actions) {
+                BDD single_succ = transitions.image(cert_i, a);
+                if(!(single_succ.Leq(cert_i)) && !(is_covered_by_r(single_succ))) {
+                    return false;
+                }
+            }
             return true;
+        });
+}
+
+bool DisjunctiveCertificate::check_entries_in_parallel(const std::vector<int> &indices) {
+    int amount = std::min<size_t>(threads, indices.size());
+    print_info("checking " + std::to_string(indices.size()) + " bdds on "
+               + std::to_string(amount) + " threads");
+    // the copies are made here since transferring reads from our manager
+    std::vector<std::unique_ptr<DisjunctiveCertificate>> copies;
+    for(int i = 0; i < amount; ++i) {
+        copies.emplace_back(new DisjunctiveCertificate(*this));
+    }
+
+    std::atomic<size_t> next(0);
+    std::atomic<bool> failed(false);
+    std::vector<std::thread> workers;
+    for(int i = 0; i < amount; ++i) {
+        DisjunctiveCertificate *copy = copies[i].get();
+        workers.emplace_back([this, copy, &indices, &next, &failed]() {
+            size_t pos;
+            while(!failed && (pos = next++) < indices.size()) {
+                if(!copy->is_entry_inductive(indices[pos])) {
+                    failed = true;
+                } else {
+                    // each entry is only written by one thread
+                    certificate.find(indices[pos])->second.covered = true;
+                }
+            }
+        });
+    }
+    for(std::thread &worker : workers) {
+        worker.join();
+    }
+    return !failed;
+}
+
+void DisjunctiveCertificate::check_and_release(const std::vector<int> &indices,
+                                               std::vector<int> &unresolved) {
+    // all bdds are checked before releasing any, since they can cover each other
+    for(int index : indices) {
+        if(!certificate[index].covered) {
+            if(!is_entry_inductive(index)) {
+                unresolved.push_back(index);
+            }
+            certificate[index].covered = true;
         }
     }
-    return false;
+    for(int index : indices) {
+        certificate.erase(index);
+    }
 }
 
-bool DisjunctiveCertificate::check_hints() {
-    // oftenly used variables
-    std::string line;
-    int hint_amount = -1;
-    int action = -1;
-    int index = -1;
-    std::vector<int> hints = std::vector<int>(task->get_number_of_actions(), -1);
+bool DisjunctiveCertificate::check_unresolved(const std::vector<int> &unresolved,
+                                              const std::vector<Hints> &unresolved_hints) {
+    if(unresolved.empty() && unresolved_hints.empty()) {
+        return true;
+    }
+    print_info(std::to_string(unresolved.size() + unresolved_hints.size())
+               + " bdds are not inductive within the streaming window,"
+               + " loading the whole certificate");
+    restart_bdd_stream();
+    std::vector<int> loaded;
+    while(load_next_bdds(loaded)) {
+    }
+    for(const Hints &hints : unresolved_hints) {
+        if(!check_hint_line(hints)) {
+            return false;
+        }
+    }
+    for(int index : unresolved) {
+        if(!is_entry_inductive(index)) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    std::getline(hint_stream, line);
-    while(line.compare("end hints") != 0) {
-        // read index and hints
-        std::stringstream ss(line);
-        ss >> index;
-        assert(index >= 0);
-        ss >> hint_amount;
-        assert(hint_amount >= 0);
-        for(int i = 0; i < hint_amount; ++i) {
-            ss >> action;
-            assert(action >=0);
-            ss >> hints[action];
-            assert(hints[action] >= 0);
-            action = -1;
-        }
-        hint_amount = -1;
-
-        // check inductivity for the bdd with given index
-        BDD cert_i = certificate[index].bdd;
-        // loop over actions
-        for(size_t i = 0; i < task->get_number_of_actions(); ++i) {
-            const Action &action = task->get_action(i);
-            BDD succ = cert_i * bdd_actions[i].pre;
-            for (int var = 0; var < task->get_number_of_facts(); ++var) {
-                if (action.change[var] != 0) {
-                    permutation[2*var] = 2*var+1;
-                    permutation[2*var+1] = 2*var;
-                } else {
-                    permutation[2*var] = 2*var;
-                    permutation[2*var+1] = 2*var+1;
+/*
+ * A first pass over the hints determines for each bdd the last hint line using
+ * it. In the second pass, bdd blocks are loaded until all bdds of the current
+ * line are there, and after checking the line, the bdds used for the last time
+ * are released. Bdds not used by any hint line are released after the line
+ * during which they were loaded.
+ * Before releasing a bdd that was not checked by a hint line, it is checked for
+ * self- or r-inductivity, where the r bdds can only be chosen among the bdds
+ * that are loaded at this time. The same holds for actions without a valid
+ * hint (such as target -1). Bdds and hint lines that fail within the window
+ * are checked again over the whole certificate at the end, so valid
+ * certificates are not rejected; in that case, the whole certificate is in
+ * memory. The window itself is not bounded either, since the bdds of a hint
+ * line and all bdds in between are loaded; its largest size is reported.
+ */
+bool DisjunctiveCertificate::is_inductive_streamed() {
+    std::unordered_map<int, int> last_use;
+    Hints hints(task->get_number_of_actions());
+    bool grouped = false;
+    std::streampos start;
+    if(hint_stream.is_open()) {
+        grouped = read_hint_header();
+        start = hint_stream.tellg();
+        for(int n = 0; read_hint_line(grouped, hints); ++n) {
+            last_use[hints.index] = n;
+            for(int a : hints.hinted_actions) {
+                for(int target : hints.targets[a]) {
+                    if(target >= 0) {
+                        last_use[target] = n;
+                    }
+                }
+            }
+        }
+        hint_stream.clear();
+        hint_stream.seekg(start);
+    }
+
+    restart_bdd_stream();
+    std::vector<int> loaded;
+    std::vector<int> unused;
+    std::vector<int> used;
+    std::vector<int> released;
+    std::vector<int> unresolved;
+    std::vector<Hints> unresolved_hints;
+    size_t max_window = 0;
+    for(int n = 0; hint_stream.is_open() && read_hint_line(grouped, hints); ++n) {
+        used.assign(1, hints.index);
+        for(int a : hints.hinted_actions) {
+            for(int target : hints.targets[a]) {
+                if(target >= 0) {
+                    used.push_back(target);
                 }
             }
-            succ = succ.Permute(&permutation[0])*bdd_actions[i].eff;
-            // if a hint is given, the sucessors must be included in the bdd with
-            // index given by then hint
-            if(hints[i] >= 0) {
-                if(!succ.Leq(certificate[hints[i]].bdd)) {
+        }
+        for(int index : used) {
+            while(certificate.find(index) == certificate.end()) {
+                if(!load_next_bdds(loaded)) {
+                    std::cout << "hint refers to bdd " << index
+                              << " which is not part of the certificate" << std::endl;
                     return false;
                 }
-                // reset hint vector
-                hints[i] = -1;
-            // if no hint is given, check if the bdd is self- or r-inductive
-            // if not, the certificate is not valid
-            // TODO: ask if it is guaranteed that the first part will get evaluated first!
-            } else if (!(succ.Leq(cert_i)) && !(is_covered_by_r(succ))) {
-                return false;
+                for(int i : loaded) {
+                    if(last_use.find(i) == last_use.end()) {
+                        unused.push_back(i);
+                    }
+                }
             }
         }
-        // set bdd as covered
-        certificate[index].covered = true;
-        index = -1;
+        max_window = std::max(max_window, certificate.size());
+
+        if(!check_hint_line(hints)) {
+            unresolved_hints.push_back(hints);
+        }
+        certificate[hints.index].covered = true;
 
-        // read in next line
-        std::getline(hint_stream, line);
+        released.swap(unused);
+        for(int index : used) {
+            if(last_use[index] == n
+                    && std::find(released.begin(), released.end(), index) == released.end()) {
+                released.push_back(index);
+            }
+        }
+        check_and_release(released, unresolved);
+        released.clear();
+        unused.clear();
     }
     hint_stream.close();
-    return true;
+
+    // bdds that are still loaded or come after the last hint
+    std::vector<int> remaining;
+    for(CertMap::iterator it = certificate.begin(); it != certificate.end(); ++it) {
+        remaining.push_back(it->first);
+    }
+    check_and_release(remaining, unresolved);
+    while(load_next_bdds(loaded)) {
+        max_window = std::max(max_window, certificate.size());
+        check_and_release(loaded, unresolved);
+    }
+    print_info("at most " + std::to_string(max_window) + " bdds were loaded at the same time");
+    return check_unresolved(unresolved, unresolved_hints);
 }
 
 bool DisjunctiveCertificate::is_inductive() {
+    if(streaming) {
+        return is_inductive_streamed();
+    }
+
     // read in hints and check if the corresponding bdds are inductive
     // if not, we can return false already, if they are we need to check the rest
     if(hint_stream.is_open()) {
@@ -210,32 +416,23 @@ bool DisjunctiveCertificate::is_inductive() {
     }
 
     // check over all bdds that are not covered yet
+    std::vector<int> uncovered;
     for (CertMap::iterator it = certificate.begin(); it != certificate.end(); ++it) {
-        // bdd is covered
-        if(it->second.covered) {
-            continue;
-        }
-
-        // bdd is not covered -> loop over all actions and check if its self- or r-inductive
-        BDD cert_i = it->second.bdd;
-        for(size_t i = 0; i < task->get_number_of_actions(); ++i) {
-            const Action &action = task->get_action(i);
-            BDD succ = cert_i * bdd_actions[i].pre;
-            for (int var = 0; var < task->get_number_of_facts(); ++var) {
-                if (action.change[var] != 0) {
-                    permutation[2*var] = 2*var+1;
-                    permutation[2*var+1] = 2*var;
-                } else {
-                    permutation[2*var] = 2*var;
-                    permutation[2*var+1] = 2*var+1;
-                }
-            }
-            succ = succ.Permute(&permutation[0])*bdd_actions[i].eff;
-            if(!(succ.Leq(cert_i)) && !(is_covered_by_r(succ))) {
+        if(!it->second.covered) {
+            uncovered.push_back(it->first);
+        }
+    }
+    if(threads > 1 && uncovered.size() > 1) {
+        if(!check_entries_in_parallel(uncovered)) {
+            return false;
+        }
+    } else {
+        for (int index : uncovered) {
+            if(!is_entry_inductive(index)) {
                 return false;
             }
+            certificate[index].covered = true;
         }
-        it->second.covered = true;
     }
 
     // sanity check
@@ -3,28 +3,71 @@
 
 #include <iostream>
 #include <fstream>
+#include <functional>
 
 #include "cudd.h"
 
 #include "certificate.h"
 
 
+/*
+ * With threads > 1, the bdds not covered by hints are checked on that many
+ * worker threads. Each worker uses a copy of the certificate in its own Cudd
+ * manager (which also builds its own transition relation), since a manager
+ * cannot be used by several threads. The bdds are handed out one by one and
+ * the check stops as soon as one worker finds a bdd that is not inductive.
+ *
+ * With streaming, the bdds are loaded and released in a sliding window along
+ * the hints (see is_inductive_streamed). This is only useful if the bdd files
+ * list the bdds in the order of the hints. The window is not bounded, and bdds
+ * that are not inductive within it cause the whole certificate to be loaded.
+ * Threads are not used in this mode.
+ */
 class DisjunctiveCertificate : public Certificate {
 private:
+   // the hints of one hint line: the successors of bdd[index] under action a
+   // are contained in the union of the bdds in targets[a]
+   struct Hints {
+       int index;
+       std::vector<std::vector<int>> targets;
+       std::vector<int> hinted_actions;
+       Hints(int number_of_actions) : index(-1), targets(number_of_actions) {}
+   };
+
    int r;
+   int threads;
+   bool streaming;
    std::ifstream hint_stream;
    bool has_hints;
-   std::vector<CertMap::iterator> lastits;
 
-   bool check_hints();
+   // copies the certificate into a new manager (used for the worker threads)
+   DisjunctiveCertificate(const DisjunctiveCertificate &other);
 
-   void initialize_itvec(std::vector<CertMap::iterator>& itvec);
-   bool next_permutation(std::vector<CertMap::iterator>& itvec, std::vector<CertMap::iterator>& lastits);
+   // reads the first line if it is "grouped hints" and returns whether it was
+   bool read_hint_header();
+   // returns false if there are no more hint lines
+   bool read_hint_line(bool grouped, Hints &hints);
+   bool check_hint_line(const Hints &hints);
+   bool check_hints();
 
    // checks if any disjunction over r BDDs coveres the successor_bdd
    bool is_covered_by_r(BDD &successor_bdd);
+   // checks if the bdd with the given index is self- or r-inductive for all actions
+   bool is_entry_inductive(int index);
+   bool check_entries_in_parallel(const std::vector<int> &indices);
+
+   // checks if property holds for any bdd of the certificate
+   bool some_bdd(const std::function<bool(const BDD &)> &property);
+   // checks the given bdds that were not checked by a hint and removes them from the certificate;
+   // bdds that are not inductive over the loaded bdds are added to unresolved
+   void check_and_release(const std::vector<int> &indices, std::vector<int> &unresolved);
+   // checks the bdds and hint lines that failed within the window over the whole certificate
+   bool check_unresolved(const std::vector<int> &unresolved,
+                         const std::vector<Hints> &unresolved_hints);
+   bool is_inductive_streamed();
 public:
-  DisjunctiveCertificate(Task *task, std::ifstream &stream, int r);
+  DisjunctiveCertificate(Task *task, std::ifstream &stream, int r, int threads = 1,
+                         bool streaming = false);
   bool contains_state(const Cube &state);
   bool contains_goal();
   // WARNING: this returns false if it is not r-inductive for the specified r
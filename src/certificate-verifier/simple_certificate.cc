@@ -54,23 +54,9 @@ bool SimpleCertificate::contains_goal() {
 }
 
 bool SimpleCertificate::is_inductive() {
-    // loop over all actions
-    for(size_t i = 0; i < task->get_number_of_actions(); ++i) {
-        const Action &action = task->get_action(i);
-        BDD res = bdd_certificate*bdd_actions[i].pre;
-        for (int var = 0; var < task->get_number_of_facts(); ++var) {
-            if (action.change[var] != 0) {
-                permutation[2*var] = 2*var+1;
-                permutation[2*var+1] = 2*var;
-            } else {
-                permutation[2*var] = 2*var;
-                permutation[2*var+1] = 2*var+1;
-            }
-        }
-        res = res.Permute(&permutation[0])*bdd_actions[i].eff;
-        if (!(res.Leq(bdd_certificate))) {
-            return false;
-        }
-    }
-    return true;
+    // the successors under each group of applicable actions must be contained in the certificate
+    return transitions.check_applicable_images(bdd_certificate,
+        [this](const BDD &succ, const std::vector<int> &) {
+            return succ.Leq(bdd_certificate);
+        });
 }
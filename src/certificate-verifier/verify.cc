@@ -14,7 +14,7 @@
 #include "task.h"
 #include "timer.h"
 
-Certificate* build_certificate(std::string certificate_file, Task* task) {
+Certificate* build_certificate(std::string certificate_file, Task* task, int threads, bool streaming) {
     std::ifstream stream;
     stream.open(certificate_file);
     if(!stream.is_open()) {
@@ -31,13 +31,16 @@ Certificate* build_certificate(std::string certificate_file, Task* task) {
     int r = stoi(linevec[2]);
 
     Certificate *certificate = NULL;
+    if(streaming && type.compare("disjunctive") != 0) {
+        std::cout << "streaming is only supported for disjunctive certificates" << std::endl;
+    }
 
     if(type.compare("simple") == 0) {
         std::cout << "reading in simple certificate" << std::endl;
         certificate = new SimpleCertificate(task, stream);
     } else if(type.compare("disjunctive") == 0) {
         std::cout << "reading in disjunctive certificate (bound:" << r << ")" << std::endl;
-        certificate = new DisjunctiveCertificate(task, stream, r);
+        certificate = new DisjunctiveCertificate(task, stream, r, threads, streaming);
     } else if(type.compare("conjunctive") == 0) {
         std::cout << "reading in conjunctive certificate";
         certificate = new ConjunctiveCertificate(task, stream, r);
@@ -49,12 +52,22 @@ Certificate* build_certificate(std::string certificate_file, Task* task) {
 }
 
 
+void print_usage_and_exit() {
+    std::cout << "Usage: verify <task-file> <certificate-file> [--timeout=x] [--threads=n] [--stream]" << std::endl;
+    std::cout << "timeout is an optional parameter in seconds" << std::endl;
+    std::cout << "threads is the amount of threads for checking disjunctive certificates "
+              << "(each thread holds its own copy of the certificate)" << std::endl;
+    std::cout << "stream only keeps the part of a disjunctive certificate in memory that is "
+              << "needed for the current hint (the bdd files should follow the order of the hints); "
+              << "the memory is not bounded: all bdds between a hint and its targets are loaded, "
+              << "and if a bdd is not inductive within the loaded part, the whole certificate "
+              << "is loaded to check it" << std::endl;
+    exit(0);
+}
 
 int main(int argc, char** argv) {
-    if(argc < 3 || argc > 4) {
-        std::cout << "Usage: verify <task-file> <certificate-file> [--timeout=x]" << std::endl;
-        std::cout << "timeout is an optional parameter in seconds" << std::endl;
-        exit(0);
+    if(argc < 3 || argc > 6) {
+        print_usage_and_exit();
     }
     register_event_handlers();
     initialize_timer();
@@ -98,23 +111,32 @@ int main(int argc, char** argv) {
     }
 
     int x = 0;
-    if(argc == 4) {
-        std::string arg = argv[3];
+    int threads = 1;
+    bool streaming = false;
+    for(int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
         if (arg.substr(0,10).compare("--timeout=") == 0) {
             std::istringstream ss(arg.substr(10));
-                if (!(ss >> x) || x < 0) {
-                    std::cout << "Usage: verify <task-file> <certificate-file> [--timeout=x] [--discard_formulas]" << std::endl;
-                    std::cout << "timeout is an optional parameter in seconds" << std::endl;
-                    exit(0);
-                }
+            if (!(ss >> x) || x < 0) {
+                print_usage_and_exit();
+            }
             std::cout << "using timeout of " << x << " seconds" << std::endl;
+        } else if (arg.substr(0,10).compare("--threads=") == 0) {
+            std::istringstream ss(arg.substr(10));
+            if (!(ss >> threads) || threads < 1) {
+                print_usage_and_exit();
+            }
+            std::cout << "using " << threads << " threads" << std::endl;
+        } else if (arg.compare("--stream") == 0) {
+            streaming = true;
+            std::cout << "streaming the certificate" << std::endl;
         }
     }
     set_timeout(x);
     print_info("Starting parsing");
     double parsing_start = timer();
     Task* task = new Task(task_file);
-    Certificate* certificate = build_certificate(certificate_file, task);
+    Certificate* certificate = build_certificate(certificate_file, task, threads, streaming);
     double parsing_end = timer();
     print_info("Finished parsing");
     std::cout << "Amount of Actions: " << task->get_number_of_actions() << std::endl;
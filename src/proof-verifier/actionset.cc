@@ -1,25 +1,92 @@
 #include "actionset.h"
 
+#include <algorithm>
+
 ActionSet::ActionSet()
-{
+    : bitset_built(false) {
 
 }
+bool ActionSet::is_subset(ActionSet *other) {
+    const std::vector<uint64_t> &bits = get_bitset();
+    const std::vector<uint64_t> &other_bits = other->get_bitset();
+    for(size_t i = 0; i < bits.size(); ++i) {
+        uint64_t other_word = (i < other_bits.size() ? other_bits[i] : 0);
+        if((bits[i] & ~other_word) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+const std::vector<uint64_t> &ActionSet::get_bitset() {
+    if(!bitset_built) {
+        build_bitset(bitset);
+        bitset_built = true;
+    }
+    return bitset;
+}
+const std::unordered_set<int> &ActionSet::get_actions() {
+    if(!actions) {
+        actions = std::unique_ptr<std::unordered_set<int>>(new std::unordered_set<int>());
+        build_actions(*actions);
+    }
+    return *actions;
+}
 
 ActionSetBasic::ActionSetBasic(std::unordered_set<int> &action_indices)
-    : action_indices(action_indices) {
-
+    : sorted_indices(action_indices.begin(), action_indices.end()) {
+    std::sort(sorted_indices.begin(), sorted_indices.end());
+    size_t words = (sorted_indices.empty() ? 0 : sorted_indices.back()/64 + 1);
+    dense = (words*sizeof(uint64_t) <= sorted_indices.size()*sizeof(int));
+    if(dense) {
+        dense_bits.resize(words, 0);
+        for(int ai : sorted_indices) {
+            dense_bits[ai/64] |= (uint64_t(1) << (ai%64));
+        }
+        sorted_indices.clear();
+        sorted_indices.shrink_to_fit();
+    }
+}
+void ActionSetBasic::build_bitset(std::vector<uint64_t> &bitset) {
+    if(dense) {
+        bitset = dense_bits;
+        return;
+    }
+    bitset.assign(sorted_indices.empty() ? 0 : sorted_indices.back()/64 + 1, 0);
+    for(int ai : sorted_indices) {
+        bitset[ai/64] |= (uint64_t(1) << (ai%64));
+    }
+}
+void ActionSetBasic::build_actions(std::unordered_set<int> &set) {
+    if(!dense) {
+        set.insert(sorted_indices.begin(), sorted_indices.end());
+        return;
+    }
+    for(size_t i = 0; i < dense_bits.size(); ++i) {
+        for(int bit = 0; bit < 64; ++bit) {
+            if(dense_bits[i] & (uint64_t(1) << bit)) {
+                set.insert(i*64 + bit);
+            }
+        }
+    }
 }
 bool ActionSetBasic::contains(int ai) {
-    return action_indices.find(ai) != action_indices.end();
+    if(dense) {
+        return ai >= 0 && static_cast<size_t>(ai)/64 < dense_bits.size()
+                && (dense_bits[ai/64] & (uint64_t(1) << (ai%64)));
+    }
+    return std::binary_search(sorted_indices.begin(), sorted_indices.end(), ai);
 }
+// for few actions, looking them up is cheaper than comparing whole bitsets
 bool ActionSetBasic::is_subset(ActionSet *other) {
-    int ret = true;
-    for(int elem : action_indices) {
-        ret = other->contains(elem);
+    if(dense) {
+        return ActionSet::is_subset(other);
     }
-}
-void ActionSetBasic::get_actions(std::unordered_set<int> &set) {
-    set.insert(action_indices.begin(), action_indices.end());
+    for(int ai : sorted_indices) {
+        if(!other->contains(ai)) {
+            return false;
+        }
+    }
+    return true;
 }
 bool ActionSetBasic::is_constantall() {
     return false;
@@ -29,15 +96,28 @@ ActionSetUnion::ActionSetUnion(ActionSet *left, ActionSet *right)
     : left(left), right(right) {
 
 }
-bool ActionSetUnion::contains(int ai) {
-    return (left->contains(ai) || right->contains(ai));
+void ActionSetUnion::build_bitset(std::vector<uint64_t> &bitset) {
+    const std::vector<uint64_t> &left_bits = left->get_bitset();
+    const std::vector<uint64_t> &right_bits = right->get_bitset();
+    bitset.assign(std::max(left_bits.size(), right_bits.size()), 0);
+    for(size_t i = 0; i < left_bits.size(); ++i) {
+        bitset[i] |= left_bits[i];
+    }
+    for(size_t i = 0; i < right_bits.size(); ++i) {
+        bitset[i] |= right_bits[i];
+    }
 }
-bool ActionSetUnion::is_subset(ActionSet *other) {
-    return (left->is_subset(other) && right->is_subset(other));
+void ActionSetUnion::build_actions(std::unordered_set<int> &set) {
+    const std::unordered_set<int> &left_actions = left->get_actions();
+    const std::unordered_set<int> &right_actions = right->get_actions();
+    set.reserve(left_actions.size() + right_actions.size());
+    set.insert(left_actions.begin(), left_actions.end());
+    set.insert(right_actions.begin(), right_actions.end());
 }
-void ActionSetUnion::get_actions(std::unordered_set<int> &set) {
-    left->get_actions(set);
-    right->get_actions(set);
+bool ActionSetUnion::contains(int ai) {
+    const std::vector<uint64_t> &bits = get_bitset();
+    return ai >= 0 && static_cast<size_t>(ai)/64 < bits.size()
+            && (bits[ai/64] & (uint64_t(1) << (ai%64)));
 }
 bool ActionSetUnion::is_constantall() {
     return false;
@@ -47,20 +127,21 @@ ActionSetConstantAll::ActionSetConstantAll(Task *task)
     : action_amount(task->get_number_of_actions()) {
 
 }
-bool ActionSetConstantAll::contains(int ai) {
-    return true;
-}
-bool ActionSetConstantAll::is_subset(ActionSet *other) {
-    int ret = true;
-    for(int i = 0; i < action_amount; ++i) {
-        ret = other->contains(i);
+void ActionSetConstantAll::build_bitset(std::vector<uint64_t> &bitset) {
+    bitset.assign((action_amount+63)/64, ~uint64_t(0));
+    if(action_amount % 64 != 0) {
+        bitset.back() = (uint64_t(1) << (action_amount%64)) - 1;
     }
 }
-void ActionSetConstantAll::get_actions(std::unordered_set<int> &set) {
+void ActionSetConstantAll::build_actions(std::unordered_set<int> &set) {
+    set.reserve(action_amount);
     for(int i = 0; i < action_amount; ++i) {
         set.insert(i);
     }
 }
+bool ActionSetConstantAll::contains(int ai) {
+    return ai >= 0 && ai < action_amount;
+}
 bool ActionSetConstantAll::is_constantall() {
     return true;
 }
@@ -3,28 +3,54 @@
 
 #include "task.h"
 
+#include <cstdint>
+#include <memory>
 #include <unordered_set>
+#include <vector>
 
+/*
+ * Action sets are compared via dense bitsets with one bit per action index.
+ * Both the bitset and the set of action indices handed to the subset checks
+ * are computed on first use and then kept, such that unions are only
+ * materialized once no matter how often they occur in B2/B3 statements.
+ */
 class ActionSet
 {
+private:
+    std::vector<uint64_t> bitset;
+    bool bitset_built;
+    std::unique_ptr<std::unordered_set<int>> actions;
+protected:
+    virtual void build_bitset(std::vector<uint64_t> &bitset) = 0;
+    virtual void build_actions(std::unordered_set<int> &set) = 0;
 public:
     ActionSet();
     virtual ~ActionSet() {}
     virtual bool contains(int ai) = 0;
-    virtual bool is_subset(ActionSet *other) = 0;
-    virtual void get_actions(std::unordered_set<int> &set) = 0;
+    virtual bool is_subset(ActionSet *other);
+    const std::vector<uint64_t> &get_bitset();
+    const std::unordered_set<int> &get_actions();
     virtual bool is_constantall() = 0;
 };
 
+/*
+ * If the actions are sparse, ie the sorted indices need less memory than a
+ * bitset up to the largest index, the indices are kept as sorted vector and
+ * the bitset is only built if another action set needs it.
+ */
 class ActionSetBasic : public ActionSet
 {
 private:
-    std::unordered_set<int> action_indices;
+    std::vector<int> sorted_indices;
+    std::vector<uint64_t> dense_bits;
+    bool dense;
+protected:
+    virtual void build_bitset(std::vector<uint64_t> &bitset);
+    virtual void build_actions(std::unordered_set<int> &set);
 public:
     ActionSetBasic(std::unordered_set<int> &action_indices);
     virtual bool contains(int ai);
     virtual bool is_subset(ActionSet *other);
-    virtual void get_actions(std::unordered_set<int> &set);
     virtual bool is_constantall();
 };
 
@@ -33,22 +59,24 @@ class ActionSetUnion : public ActionSet
 private:
     ActionSet *left;
     ActionSet *right;
+protected:
+    virtual void build_bitset(std::vector<uint64_t> &bitset);
+    virtual void build_actions(std::unordered_set<int> &set);
 public:
     ActionSetUnion(ActionSet *left, ActionSet *right);
     virtual bool contains(int ai);
-    virtual bool is_subset(ActionSet *other);
-    virtual void get_actions(std::unordered_set<int> &set);
     virtual bool is_constantall();
 };
 
 class ActionSetConstantAll : public ActionSet
 {
     int action_amount;
+protected:
+    virtual void build_bitset(std::vector<uint64_t> &bitset);
+    virtual void build_actions(std::unordered_set<int> &set);
 public:
     ActionSetConstantAll(Task *task);
     virtual bool contains(int ai);
-    virtual bool is_subset(ActionSet *other);
-    virtual void get_actions(std::unordered_set<int> &set);
     virtual bool is_constantall();
 };
 
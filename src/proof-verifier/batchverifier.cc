@@ -0,0 +1,224 @@
+#include "batchverifier.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <csignal>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "global_funcs.h"
+#include "setformulabdd.h"
+
+static bool write_all(int fd, const void *data, size_t size) {
+    const char *buf = static_cast<const char *>(data);
+    while (size > 0) {
+        ssize_t written = write(fd, buf, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        } else if (written <= 0) {
+            return false;
+        }
+        buf += written;
+        size -= written;
+    }
+    return true;
+}
+
+// returns false if the other end was closed before size bytes could be read
+static bool read_all(int fd, void *data, size_t size) {
+    char *buf = static_cast<char *>(data);
+    while (size > 0) {
+        ssize_t amount = read(fd, buf, size);
+        if (amount < 0 && errno == EINTR) {
+            continue;
+        } else if (amount <= 0) {
+            return false;
+        }
+        buf += amount;
+        size -= amount;
+    }
+    return true;
+}
+
+static bool read_line(int fd, std::string &line) {
+    line.clear();
+    char c;
+    while (read_all(fd, &c, 1)) {
+        if (c == '\n') {
+            return true;
+        }
+        line.push_back(c);
+    }
+    return false;
+}
+
+static int get_exit_code(int status) {
+    if (WIFEXITED(status)) {
+        return WEXITSTATUS(status);
+    }
+    return static_cast<int>(ExitCode::CRITICAL_ERROR);
+}
+
+BatchVerifier::BatchVerifier(TaskPreparation prepare, CertificateVerification verify)
+    : prepare(prepare), verify(verify) {
+}
+
+BatchVerifier::~BatchVerifier() {
+    while (!worker_order.empty()) {
+        stop_worker(worker_order.front());
+    }
+}
+
+BatchVerifier::TaskWorker BatchVerifier::start_worker(const std::string &task_file) {
+    int jobs[2];
+    int results[2];
+    if (pipe(jobs) != 0 || pipe(results) != 0) {
+        std::cerr << "could not create pipes for batch worker" << std::endl;
+        exit_with(ExitCode::CRITICAL_ERROR);
+    }
+    std::cout.flush();
+    std::cerr.flush();
+    pid_t pid = fork();
+    if (pid < 0) {
+        std::cerr << "could not start batch worker" << std::endl;
+        exit_with(ExitCode::CRITICAL_ERROR);
+    } else if (pid == 0) {
+        close(jobs[1]);
+        close(results[0]);
+        // otherwise, the other workers would not notice when they are stopped
+        for (auto &entry : workers) {
+            close(entry.second.job_fd);
+            close(entry.second.result_fd);
+        }
+        run_worker(task_file, jobs[0], results[1]);
+    }
+    close(jobs[0]);
+    close(results[1]);
+    return {pid, jobs[1], results[0]};
+}
+
+int BatchVerifier::stop_worker(const std::string &task_content) {
+    auto it = workers.find(task_content);
+    assert(it != workers.end());
+    // closing the job pipe tells the worker to exit
+    close(it->second.job_fd);
+    close(it->second.result_fd);
+    int status;
+    while (waitpid(it->second.pid, &status, 0) < 0 && errno == EINTR) {}
+    workers.erase(it);
+    worker_order.erase(std::find(worker_order.begin(), worker_order.end(), task_content));
+    return get_exit_code(status);
+}
+
+void BatchVerifier::run_worker(const std::string &task_file, int job_fd, int result_fd) {
+    // stdout of the batch verifier only contains the results
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+    Task *task = new Task(task_file);
+    prepare(task);
+
+    std::string certificate_file;
+    while (read_line(job_fd, certificate_file)) {
+        int code = run_job(task, certificate_file);
+        if (!write_all(result_fd, &code, sizeof(code))) {
+            break;
+        }
+    }
+    exit(0);
+}
+
+int BatchVerifier::run_job(Task *task, const std::string &certificate_file) {
+    int report[2];
+    if (pipe(report) != 0) {
+        std::cerr << "could not create pipe for batch job" << std::endl;
+        return static_cast<int>(ExitCode::CRITICAL_ERROR);
+    }
+    std::cout.flush();
+    std::cerr.flush();
+    pid_t pid = fork();
+    if (pid < 0) {
+        std::cerr << "could not start batch job" << std::endl;
+        close(report[0]);
+        close(report[1]);
+        return static_cast<int>(ExitCode::CRITICAL_ERROR);
+    } else if (pid == 0) {
+        close(report[0]);
+        BDDFile::set_varorder_report_fd(report[1]);
+        initialize_timer();
+        verify(task, certificate_file);
+        // verify is expected to exit
+        exit_with(ExitCode::CRITICAL_ERROR);
+    }
+    close(report[1]);
+
+    // precompile the BDD variable orders of this job for the next jobs on this task
+    int size;
+    while (read_all(report[0], &size, sizeof(size))) {
+        std::vector<int> varorder(size);
+        if (!read_all(report[0], varorder.data(), size*sizeof(int))) {
+            break;
+        }
+        BDDFile::precompile_util(task, varorder);
+    }
+    close(report[0]);
+
+    int status;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+    return get_exit_code(status);
+}
+
+int BatchVerifier::verify_job(const std::string &task_file, const std::string &certificate_file) {
+    std::ifstream task_stream(task_file);
+    if (!task_stream.is_open()) {
+        return static_cast<int>(ExitCode::NO_TASK_FILE);
+    }
+    std::stringstream task_content;
+    task_content << task_stream.rdbuf();
+    const std::string &key = task_content.str();
+
+    auto it = workers.find(key);
+    if (it == workers.end()) {
+        if (workers.size() >= MAX_CACHED_TASKS) {
+            stop_worker(worker_order.front());
+        }
+        it = workers.emplace(key, start_worker(task_file)).first;
+        worker_order.push_back(key);
+    }
+
+    std::string job = certificate_file + "\n";
+    int code;
+    if (!write_all(it->second.job_fd, job.data(), job.size())
+            || !read_all(it->second.result_fd, &code, sizeof(code))) {
+        // the worker died, for example because the task could not be parsed
+        code = stop_worker(key);
+        if (code == static_cast<int>(ExitCode::CERTIFICATE_VALID)) {
+            code = static_cast<int>(ExitCode::CRITICAL_ERROR);
+        }
+    }
+    return code;
+}
+
+void BatchVerifier::run(std::istream &jobs) {
+    // writing to a worker that died must not terminate the batch verifier
+    signal(SIGPIPE, SIG_IGN);
+
+    std::string line;
+    while (std::getline(jobs, line)) {
+        std::istringstream job(line);
+        std::string task_file, certificate_file;
+        if (!(job >> task_file) || task_file.at(0) == '#') {
+            continue;
+        }
+        int code;
+        if (job >> certificate_file) {
+            code = verify_job(task_file, certificate_file);
+        } else {
+            std::cerr << "batch job without certificate file: " << line << std::endl;
+            code = static_cast<int>(ExitCode::NO_CERTIFICATE_FILE);
+        }
+        std::cout << task_file << " " << certificate_file << " " << code << std::endl;
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef BATCHVERIFIER_H
+#define BATCHVERIFIER_H
+
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <sys/types.h>
+
+#include "task.h"
+
+/*
+ * Verifies a stream of certificates. Each line of the input is a job of the
+ * form "<task-file> <certificate-file>"; for each job, a line
+ * "<task-file> <certificate-file> <exit code>" is written to stdout, where
+ * the exit code is the one verify would exit with for this job (see ExitCode).
+ *
+ * For each distinct task (identified by the content of the task file), a
+ * worker process parses the task once and prepares it (creating the Cudd
+ * manager and the action formulas of all formalisms). Each certificate is then
+ * checked in a child process forked from the worker, which inherits the
+ * prepared task. Since the verification of a certificate always ends by
+ * exiting the process, a failing job cannot affect later jobs.
+ * The output of the verification itself is redirected to stderr.
+ *
+ * At most MAX_CACHED_TASKS workers are kept alive; if a new task needs to be
+ * prepared, the worker that was started first is stopped.
+ */
+class BatchVerifier
+{
+public:
+    typedef std::function<void(Task *)> TaskPreparation;
+    // must not return but exit with the result of the verification
+    typedef std::function<void(Task *, const std::string &)> CertificateVerification;
+private:
+    struct TaskWorker {
+        pid_t pid;
+        // certificate files are sent on job_fd, exit codes are received on result_fd
+        int job_fd;
+        int result_fd;
+    };
+    static const size_t MAX_CACHED_TASKS = 8;
+
+    TaskPreparation prepare;
+    CertificateVerification verify;
+    std::unordered_map<std::string, TaskWorker> workers;
+    std::deque<std::string> worker_order;
+
+    TaskWorker start_worker(const std::string &task_file);
+    // returns the exit code of the worker
+    int stop_worker(const std::string &task_content);
+    void run_worker(const std::string &task_file, int job_fd, int result_fd);
+    int run_job(Task *task, const std::string &certificate_file);
+    int verify_job(const std::string &task_file, const std::string &certificate_file);
+public:
+    BatchVerifier(TaskPreparation prepare, CertificateVerification verify);
+    ~BatchVerifier();
+
+    void run(std::istream &jobs);
+};
+
+#endif // BATCHVERIFIER_H
@@ -0,0 +1,113 @@
+#include "bddprefetcher.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+std::shared_ptr<BDDPrefetcher::SharedBuffer> BDDPrefetcher::get_shared_buffer() {
+    static std::shared_ptr<SharedBuffer> shared_buffer(new SharedBuffer());
+    return shared_buffer;
+}
+
+BDDPrefetcher::BDDPrefetcher(FILE *fp, std::string filename)
+    : fp(fp), filename(filename), finished(false), stopped(false),
+      buffer(get_shared_buffer()) {
+    worker = std::thread(&BDDPrefetcher::work, this);
+}
+
+BDDPrefetcher::~BDDPrefetcher() {
+    {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        stopped = true;
+    }
+    buffer->cv.notify_all();
+    worker.join();
+    fclose(fp);
+    // blocks that were never taken do not count against the other files anymore
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    for (const Block &block : blocks) {
+        buffer->buffered_bytes -= block.dump.size();
+    }
+    buffer->cv.notify_all();
+}
+
+bool BDDPrefetcher::read_block(Block &block, char *&line, size_t &line_capacity) {
+    ssize_t length;
+    // skip empty lines before the index line
+    do {
+        length = getline(&line, &line_capacity, fp);
+        if (length < 0) {
+            return false;
+        }
+    } while (strspn(line, " \t\r\n") == static_cast<size_t>(length));
+
+    std::istringstream index_line(line);
+    int index;
+    while (index_line >> index) {
+        block.indices.push_back(index);
+    }
+
+    block.binary = false;
+    length = getline(&line, &line_capacity, fp);
+    if (length >= 0 && strncmp(line, "bin ", 4) == 0) {
+        block.binary = true;
+        size_t size = strtoull(line + 4, nullptr, 10);
+        block.dump.resize(size);
+        if (fread(&block.dump[0], 1, size, fp) != size) {
+            std::cerr << "BDD file " << filename << " ends within a DDDMP dump" << std::endl;
+        }
+        return true;
+    }
+    while (length >= 0) {
+        block.dump.append(line, length);
+        if (strncmp(line, ".end", 4) == 0) {
+            return true;
+        }
+        length = getline(&line, &line_capacity, fp);
+    }
+    std::cerr << "BDD file " << filename << " ends within a DDDMP dump" << std::endl;
+    return true;
+}
+
+void BDDPrefetcher::work() {
+    char *line = nullptr;
+    size_t line_capacity = 0;
+    while (true) {
+        Block block;
+        bool read = read_block(block, line, line_capacity);
+        std::unique_lock<std::mutex> lock(buffer->mutex);
+        if (!read) {
+            finished = true;
+            buffer->cv.notify_all();
+            break;
+        }
+        size_t block_size = block.dump.size();
+        blocks.push_back(std::move(block));
+        buffer->buffered_bytes += block_size;
+        buffer->cv.notify_all();
+        buffer->cv.wait(lock, [this] {
+            return stopped || blocks.empty()
+                    || buffer->buffered_bytes < MAX_BUFFERED_BYTES;
+        });
+        if (stopped) {
+            break;
+        }
+    }
+    free(line);
+}
+
+bool BDDPrefetcher::next_block(std::vector<int> &indices, std::string &dump, bool &binary) {
+    std::unique_lock<std::mutex> lock(buffer->mutex);
+    buffer->cv.wait(lock, [this] { return finished || !blocks.empty(); });
+    if (blocks.empty()) {
+        return false;
+    }
+    indices = std::move(blocks.front().indices);
+    dump = std::move(blocks.front().dump);
+    binary = blocks.front().binary;
+    blocks.pop_front();
+    buffer->buffered_bytes -= dump.size();
+    buffer->cv.notify_all();
+    return true;
+}
@@ -0,0 +1,67 @@
+#ifndef BDDPREFETCHER_H
+#define BDDPREFETCHER_H
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Reads the blocks of a BDD file ahead on a background thread. A block
+ * consists of a line with the indices of the BDDs it contains, followed by
+ * their DDDMP dump. Text dumps end with the ".end" line, binary dumps are
+ * preceded by a line "bin <size in bytes>".
+ *
+ * The worker only reads and splits the file; decoding the dump creates nodes
+ * in the global Cudd manager and thus must happen on the main thread (see
+ * BDDFile::get_ddnode). The amount of buffered text of all prefetchers
+ * together is bounded by MAX_BUFFERED_BYTES. A prefetcher without buffered
+ * blocks still reads its next block, so a file never waits for the blocks of
+ * other files to be taken (the bound is exceeded by at most one block per
+ * file).
+ */
+class BDDPrefetcher
+{
+private:
+    struct Block {
+        std::vector<int> indices;
+        std::string dump;
+        bool binary;
+    };
+
+    // the blocks of all prefetchers are guarded by one mutex to share the bound
+    struct SharedBuffer {
+        std::mutex mutex;
+        std::condition_variable cv;
+        size_t buffered_bytes = 0;
+    };
+
+    static const size_t MAX_BUFFERED_BYTES = 64*1024*1024;
+
+    // each prefetcher keeps the buffer alive, since they are destroyed at exit
+    static std::shared_ptr<SharedBuffer> get_shared_buffer();
+
+    FILE *fp;
+    std::string filename;
+    std::deque<Block> blocks;
+    bool finished;
+    bool stopped;
+    std::shared_ptr<SharedBuffer> buffer;
+    std::thread worker;
+
+    bool read_block(Block &block, char *&line, size_t &line_capacity);
+    void work();
+public:
+    // fp must be positioned after the variable order line; it is closed by the prefetcher
+    BDDPrefetcher(FILE *fp, std::string filename);
+    ~BDDPrefetcher();
+
+    // waits for the next block; returns false if the file has no more blocks
+    bool next_block(std::vector<int> &indices, std::string &dump, bool &binary);
+};
+
+#endif // BDDPREFETCHER_H
@@ -0,0 +1,442 @@
+#include "binaryproof.h"
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "global_funcs.h"
+#include "setformulaconstant.h"
+#include "setformulahorn.h"
+#include "setformulatwocnf.h"
+#include "setformulabdd.h"
+#include "setformulaexplicit.h"
+
+namespace {
+const char HEADER_MAGIC[] = "UPRF";
+const char FOOTER_MAGIC[] = "UPRE";
+const unsigned char FORMAT_VERSION = 1;
+// header magic + version
+const size_t HEADER_SIZE = 5;
+// footer offset + footer magic
+const size_t TRAILER_SIZE = 12;
+// 5 varint bytes hold 35 bits, enough for any int
+const int MAX_VARINT_LENGTH = 5;
+}
+
+MemoryBuffer::MemoryBuffer(const char *begin, size_t length) {
+    // the get area is never written to, the const_cast is only needed for the interface
+    char *b = const_cast<char *>(begin);
+    setg(b, b, b + length);
+}
+
+BinaryProofReader::BinaryProofReader(std::string filename)
+    : fd(-1), data(nullptr), size(0), pos(HEADER_SIZE), footer_pos(0),
+      formula_amount(0), last_occ_pos(0), knowledge_amount(0) {
+    fd = open(filename.c_str(), O_RDONLY);
+    if(fd == -1) {
+        exit_with(ExitCode::NO_CERTIFICATE_FILE);
+    }
+    struct stat st;
+    if(fstat(fd, &st) == -1 || st.st_size < (off_t) (HEADER_SIZE + TRAILER_SIZE)) {
+        std::cerr << "binary proof file " << filename << " is too small" << std::endl;
+        exit_with(ExitCode::PARSING_ERROR);
+    }
+    size = st.st_size;
+    void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(mapped == MAP_FAILED) {
+        std::cerr << "could not map binary proof file " << filename << std::endl;
+        exit_with(ExitCode::CRITICAL_ERROR);
+    }
+    data = static_cast<const char *>(mapped);
+    // the records are read exactly once from front to back
+    madvise(mapped, size, MADV_SEQUENTIAL);
+
+    if(std::memcmp(data + size - 4, FOOTER_MAGIC, 4) != 0) {
+        std::cerr << "binary proof file " << filename
+                  << " is incomplete (no footer found)" << std::endl;
+        exit_with(ExitCode::PARSING_ERROR);
+    }
+    uint64_t offset = 0;
+    for(int i = 7; i >= 0; --i) {
+        offset = (offset << 8) | (unsigned char) data[size - TRAILER_SIZE + i];
+    }
+    footer_pos = offset;
+    if(footer_pos < HEADER_SIZE || footer_pos > size - TRAILER_SIZE) {
+        std::cerr << "binary proof file " << filename << " has a corrupt footer" << std::endl;
+        exit_with(ExitCode::PARSING_ERROR);
+    }
+
+    // each last occurence takes at least one byte
+    size_t record_end = footer_pos;
+    pos = footer_pos;
+    footer_pos = size - TRAILER_SIZE;
+    formula_amount = read_varint();
+    if(static_cast<size_t>(formula_amount) > footer_pos - pos) {
+        std::cerr << "binary proof file " << filename << " has a corrupt footer" << std::endl;
+        exit_with(ExitCode::PARSING_ERROR);
+    }
+    last_occ_pos = pos;
+    footer_pos = record_end;
+    pos = HEADER_SIZE;
+}
+
+BinaryProofReader::~BinaryProofReader() {
+    if(data) {
+        munmap(const_cast<char *>(data), size);
+    }
+    if(fd != -1) {
+        close(fd);
+    }
+}
+
+bool BinaryProofReader::is_binary_proof(std::string filename) {
+    std::ifstream in(filename, std::ios::binary);
+    char magic[HEADER_SIZE];
+    if(!in.read(magic, HEADER_SIZE)) {
+        return false;
+    }
+    if(std::memcmp(magic, HEADER_MAGIC, 4) != 0) {
+        return false;
+    }
+    if((unsigned char) magic[4] != FORMAT_VERSION) {
+        std::cerr << "unsupported binary proof version " << (int) magic[4] << std::endl;
+        exit_with(ExitCode::PARSING_ERROR);
+    }
+    return true;
+}
+
+unsigned char BinaryProofReader::read_byte() {
+    if(pos >= footer_pos) {
+        std::cerr << "unexpected end of binary proof" << std::endl;
+        exit_with(ExitCode::PARSING_ERROR);
+    }
+    return data[pos++];
+}
+
+int BinaryProofReader::read_varint() {
+    uint64_t value = 0;
+    int length = 0;
+    unsigned char byte;
+    do {
+        if(length == MAX_VARINT_LENGTH) {
+            std::cerr << "varint in binary proof is longer than "
+                      << MAX_VARINT_LENGTH << " bytes" << std::endl;
+            exit_with(ExitCode::PARSING_ERROR);
+        }
+        byte = read_byte();
+        value |= (uint64_t) (byte & 0x7f) << (7*length);
+        length++;
+    } while(byte & 0x80);
+    if(value > INT_MAX) {
+        std::cerr << "varint " << value << " in binary proof is too large" << std::endl;
+        exit_with(ExitCode::PARSING_ERROR);
+    }
+    return value;
+}
+
+FormulaIndex BinaryProofReader::read_new_formula_index(ProofChecker &proofchecker) {
+    FormulaIndex fi = read_varint();
+    if(fi >= formula_amount || proofchecker.is_formula_declared(fi)) {
+        std::cerr << "set expression #" << fi << " is declared twice or exceeds the "
+                  << formula_amount << " set expressions of the binary proof" << std::endl;
+        exit_with(ExitCode::PARSING_ERROR);
+    }
+    return fi;
+}
+
+FormulaIndex BinaryProofReader::read_formula_reference(ProofChecker &proofchecker) {
+    FormulaIndex fi = read_varint();
+    if(!proofchecker.is_formula_declared(fi)) {
+        std::cerr << "binary proof refers to undeclared set expression #" << fi << std::endl;
+        exit_with(ExitCode::PARSING_ERROR);
+    }
+    return fi;
+}
+
+ActionSetIndex BinaryProofReader::read_new_actionset_index(ProofChecker &proofchecker) {
+    ActionSetIndex ai = read_varint();
+    if(static_cast<size_t>(ai) < proofchecker.get_actionset_amount()) {
+        std::cerr << "action set #" << ai << " is declared twice or out of order" << std::endl;
+        exit_with(ExitCode::PARSING_ERROR);
+    }
+    return ai;
+}
+
+ActionSetIndex BinaryProofReader::read_actionset_reference(ProofChecker &proofchecker) {
+    ActionSetIndex ai = read_varint();
+    if(!proofchecker.is_actionset_declared(ai)) {
+        std::cerr << "binary proof refers to undeclared action set #" << ai << std::endl;
+        exit_with(ExitCode::PARSING_ERROR);
+    }
+    return ai;
+}
+
+KnowledgeIndex BinaryProofReader::read_knowledge_reference() {
+    KnowledgeIndex ki = read_varint();
+    if(ki >= knowledge_amount) {
+        std::cerr << "binary proof refers to undeclared knowledge #" << ki << std::endl;
+        exit_with(ExitCode::PARSING_ERROR);
+    }
+    return ki;
+}
+
+void BinaryProofReader::read_last_occ(std::vector<KnowledgeIndex> &last_occ) {
+    size_t record_end = footer_pos;
+    pos = last_occ_pos;
+    footer_pos = size - TRAILER_SIZE;
+    int amount = formula_amount;
+    last_occ.resize(amount);
+    for(int i = 0; i < amount; ++i) {
+        last_occ[i] = read_varint() - 1;
+    }
+    footer_pos = record_end;
+    pos = HEADER_SIZE;
+}
+
+void BinaryProofReader::read_in_expression(ProofChecker &proofchecker, Task *task) {
+    FormulaIndex expression_index = read_new_formula_index(proofchecker);
+    char type = read_byte();
+    std::unique_ptr<SetFormula> expression;
+
+    switch(type) {
+    case 'n': {
+        FormulaIndex subformulaindex = read_formula_reference(proofchecker);
+        proofchecker.add_compound_formula(SetFormulaType::NEGATION, subformulaindex,
+                                          ProofChecker::INDEXNONE, expression_index);
+        return;
+    }
+    case 'i': {
+        FormulaIndex left = read_formula_reference(proofchecker);
+        FormulaIndex right = read_formula_reference(proofchecker);
+        proofchecker.add_compound_formula(SetFormulaType::INTERSECTION, left, right, expression_index);
+        return;
+    }
+    case 'u': {
+        FormulaIndex left = read_formula_reference(proofchecker);
+        FormulaIndex right = read_formula_reference(proofchecker);
+        proofchecker.add_compound_formula(SetFormulaType::UNION, left, right, expression_index);
+        return;
+    }
+    case 'p': {
+        FormulaIndex subformulaindex = read_formula_reference(proofchecker);
+        ActionSetIndex actionsetindex = read_actionset_reference(proofchecker);
+        proofchecker.add_compound_formula(SetFormulaType::PROGRESSION, subformulaindex,
+                                          actionsetindex, expression_index);
+        return;
+    }
+    case 'r': {
+        FormulaIndex subformulaindex = read_formula_reference(proofchecker);
+        ActionSetIndex actionsetindex = read_actionset_reference(proofchecker);
+        proofchecker.add_compound_formula(SetFormulaType::REGRESSION, subformulaindex,
+                                          actionsetindex, expression_index);
+        return;
+    }
+    default: {
+        // basic sets are stored in their textual description
+        size_t length = read_varint();
+        if(length > footer_pos - pos) {
+            std::cerr << "description of set expression #" << expression_index
+                      << " exceeds the binary proof" << std::endl;
+            exit_with(ExitCode::PARSING_ERROR);
+        }
+        MemoryBuffer buffer(data + pos, length);
+        std::istream in(&buffer);
+        pos += length;
+        if(type == 'b') {
+            expression = std::unique_ptr<SetFormula>(new SetFormulaBDD(in, task));
+        } else if(type == 'h') {
+            expression = std::unique_ptr<SetFormula>(new SetFormulaHorn(in, task));
+        } else if(type == 'd') {
+            expression = std::unique_ptr<SetFormula>(new SetFormulaDualHorn(in, task));
+        } else if(type == 't') {
+            expression = std::unique_ptr<SetFormula>(new SetFormulaTwoCNF(in, task));
+        } else if(type == 'e') {
+            expression = std::unique_ptr<SetFormula>(new SetFormulaExplicit(in, task));
+        } else if(type == 'c') {
+            expression = std::unique_ptr<SetFormula>(new SetFormulaConstant(in, task));
+        } else {
+            std::cerr << "unknown expression type " << type << std::endl;
+            exit_with(ExitCode::CRITICAL_ERROR);
+        }
+        break;
+    }
+    }
+    proofchecker.add_formula(std::move(expression), expression_index);
+}
+
+void BinaryProofReader::read_in_actionset(ProofChecker &proofchecker, Task *task) {
+    ActionSetIndex action_index = read_new_actionset_index(proofchecker);
+    char type = read_byte();
+    if(type == 'b') {
+        int amount = read_varint();
+        std::unordered_set<int> actions;
+        actions.reserve(amount);
+        for(int i = 0; i < amount; ++i) {
+            int action = read_varint();
+            if(action >= task->get_number_of_actions()) {
+                std::cerr << "action set #" << action_index << " contains unknown action "
+                          << action << std::endl;
+                exit_with(ExitCode::PARSING_ERROR);
+            }
+            actions.insert(action);
+        }
+        proofchecker.add_actionset(std::unique_ptr<ActionSet>(new ActionSetBasic(actions)),
+                                   action_index);
+    } else if(type == 'u') {
+        ActionSetIndex left = read_actionset_reference(proofchecker);
+        ActionSetIndex right = read_actionset_reference(proofchecker);
+        proofchecker.add_actionset_union(left, right, action_index);
+    } else if(type == 'a') {
+        proofchecker.add_actionset(std::unique_ptr<ActionSet>(new ActionSetConstantAll(task)),
+                                   action_index);
+    } else {
+        std::cerr << "unknown actionset type " << type << std::endl;
+        exit_with(ExitCode::CRITICAL_ERROR);
+    }
+}
+
+void BinaryProofReader::read_and_check_knowledge(ProofChecker &proofchecker) {
+    KnowledgeIndex knowledge_index = read_varint();
+    if(knowledge_index < knowledge_amount || knowledge_index == INT_MAX) {
+        std::cerr << "knowledge #" << knowledge_index << " is declared twice or out of range"
+                  << std::endl;
+        exit_with(ExitCode::PARSING_ERROR);
+    }
+    char kind = read_byte();
+    // the sets of a knowledge are read once the rule determines their kind
+    std::vector<int> sets;
+    if(kind == 's') {
+        sets.push_back(read_varint());
+        sets.push_back(read_varint());
+    } else if(kind == 'd') {
+        sets.push_back(read_varint());
+    } else if(kind != 'u') {
+        std::cerr << "unknown knowledge type " << kind << std::endl;
+        exit_with(ExitCode::CRITICAL_ERROR);
+    }
+    char rule = read_byte();
+    int rule_number = read_byte();
+    int argc = read_byte();
+    std::vector<KnowledgeIndex> ki(argc);
+    bool premises_derived = true;
+    for(int i = 0; i < argc; ++i) {
+        ki[i] = read_knowledge_reference();
+        if(!proofchecker.is_knowledge_derived(ki[i])) {
+            std::cerr << "knowledge #" << knowledge_index << " is based on knowledge #"
+                      << ki[i] << " which was not derived" << std::endl;
+            premises_derived = false;
+        }
+    }
+    knowledge_amount = knowledge_index + 1;
+    bool actions = kind == 's' && rule == 'b' && rule_number == 5;
+    for(int set : sets) {
+        if(actions ? !proofchecker.is_actionset_declared(set)
+                   : !proofchecker.is_formula_declared(set)) {
+            std::cerr << "knowledge #" << knowledge_index << " refers to undeclared "
+                      << (actions ? "action set #" : "set expression #") << set << std::endl;
+            exit_with(ExitCode::PARSING_ERROR);
+        }
+    }
+    int first = sets.size() > 0 ? sets[0] : -1;
+    int second = sets.size() > 1 ? sets[1] : -1;
+
+    bool knowledge_is_correct = false;
+    bool known_rule = true;
+    if(!premises_derived) {
+        // the rules expect their premises to be in the knowledge base
+    } else if(kind == 's' && rule == 'b' && argc == 0) {
+        switch(rule_number) {
+        case 1:
+            knowledge_is_correct = proofchecker.check_statement_B1(knowledge_index, first, second);
+            break;
+        case 2:
+            knowledge_is_correct = proofchecker.check_statement_B2(knowledge_index, first, second);
+            break;
+        case 3:
+            knowledge_is_correct = proofchecker.check_statement_B3(knowledge_index, first, second);
+            break;
+        case 4:
+            knowledge_is_correct = proofchecker.check_statement_B4(knowledge_index, first, second);
+            break;
+        case 5:
+            knowledge_is_correct = proofchecker.check_statement_B5(knowledge_index, first, second);
+            break;
+        default:
+            known_rule = false;
+        }
+    } else if(kind == 's' && rule == 'd' && argc == 1) {
+        if(rule_number == 10) {
+            knowledge_is_correct = proofchecker.check_rule_D10(knowledge_index, first, second, ki[0]);
+        } else if(rule_number == 11) {
+            knowledge_is_correct = proofchecker.check_rule_D11(knowledge_index, first, second, ki[0]);
+        } else {
+            known_rule = false;
+        }
+    } else if(kind == 'd' && rule == 'd') {
+        if(rule_number == 1 && argc == 0) {
+            knowledge_is_correct = proofchecker.check_rule_D1(knowledge_index, first);
+        } else if(rule_number == 2 && argc == 2) {
+            knowledge_is_correct = proofchecker.check_rule_D2(knowledge_index, first, ki[0], ki[1]);
+        } else if(rule_number == 3 && argc == 2) {
+            knowledge_is_correct = proofchecker.check_rule_D3(knowledge_index, first, ki[0], ki[1]);
+        } else if(rule_number == 6 && argc == 3) {
+            knowledge_is_correct = proofchecker.check_rule_D6(knowledge_index, first, ki[0], ki[1], ki[2]);
+        } else if(rule_number == 7 && argc == 3) {
+            knowledge_is_correct = proofchecker.check_rule_D7(knowledge_index, first, ki[0], ki[1], ki[2]);
+        } else if(rule_number == 8 && argc == 3) {
+            knowledge_is_correct = proofchecker.check_rule_D8(knowledge_index, first, ki[0], ki[1], ki[2]);
+        } else if(rule_number == 9 && argc == 3) {
+            knowledge_is_correct = proofchecker.check_rule_D9(knowledge_index, first, ki[0], ki[1], ki[2]);
+        } else {
+            known_rule = false;
+        }
+    } else if(kind == 'u' && rule == 'd' && argc == 1) {
+        if(rule_number == 4) {
+            knowledge_is_correct = proofchecker.check_rule_D4(knowledge_index, ki[0]);
+        } else if(rule_number == 5) {
+            knowledge_is_correct = proofchecker.check_rule_D5(knowledge_index, ki[0]);
+        } else {
+            known_rule = false;
+        }
+    } else {
+        known_rule = false;
+    }
+    if(!known_rule) {
+        std::cerr << "unknown justification " << rule << rule_number << " with "
+                  << argc << " arguments for knowledge #" << knowledge_index << std::endl;
+        exit_with(ExitCode::CRITICAL_ERROR);
+    }
+    if(!knowledge_is_correct) {
+        std::cerr << "check for knowledge #" << knowledge_index << " NOT successful!" << std::endl;
+    }
+}
+
+void BinaryProofReader::check_proof(ProofChecker &proofchecker, Task *task) {
+    pos = HEADER_SIZE;
+    while(true) {
+        // check if timeout is reached
+        if(timer() > g_timeout) {
+            exit_timeout("");
+        }
+
+        char opcode = read_byte();
+        if(opcode == 'e') {
+            read_in_expression(proofchecker, task);
+        } else if(opcode == 'k') {
+            read_and_check_knowledge(proofchecker);
+        } else if(opcode == 'a') {
+            read_in_actionset(proofchecker, task);
+        } else if(opcode == 'x') {
+            break;
+        } else {
+            std::cerr << "unknown record type " << (int) opcode << " in binary proof" << std::endl;
+            exit_with(ExitCode::CRITICAL_ERROR);
+        }
+    }
+}
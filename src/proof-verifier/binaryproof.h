@@ -0,0 +1,75 @@
+#ifndef BINARYPROOF_H
+#define BINARYPROOF_H
+
+#include "proofchecker.h"
+#include "task.h"
+
+#include <streambuf>
+#include <string>
+#include <vector>
+
+/*
+ * Binary encoding of a proof (written by the planner with
+ * unsolv_proof_format=binary). The file starts with the magic "UPRF" and a
+ * version byte, followed by a sequence of records:
+ *  - 'e' <id> <type> ...: set expression. Compound types (n,i,u,p,r) are
+ *    followed by the varint indices of their subsets/action sets, all other
+ *    types by a varint length and the textual description used in proof.txt
+ *  - 'a' <id> <type> ...: action set ('b' <amount> <actions>, 'u' <l> <r>, 'a')
+ *  - 'k' <id> <kind> <sets> <rule letter> <rule number> <#args> <args>:
+ *    knowledge, where kind is 's' (2 sets), 'd' (1 set) or 'u' (no set)
+ *  - 'x': end of records
+ * After the records follows a footer with the amount of set expressions and
+ * for each set expression its last occurence (+1, 0 meaning never discard).
+ * The file ends with the offset of the footer (8 bytes, little endian) and
+ * the magic "UPRE".
+ * All indices are encoded as unsigned LEB128 varints of at most 5 bytes
+ * and must fit into an int.
+ */
+class BinaryProofReader
+{
+private:
+    int fd;
+    const char *data;
+    size_t size;
+    size_t pos;
+    size_t footer_pos;
+    // the footer declares the amount of set expressions before their last occurences
+    int formula_amount;
+    size_t last_occ_pos;
+    // all knowledge indices below have been declared
+    KnowledgeIndex knowledge_amount;
+
+    unsigned char read_byte();
+    int read_varint();
+    // exit with a parsing error if an index is out of range or not (yet) declared
+    FormulaIndex read_new_formula_index(ProofChecker &proofchecker);
+    FormulaIndex read_formula_reference(ProofChecker &proofchecker);
+    ActionSetIndex read_new_actionset_index(ProofChecker &proofchecker);
+    ActionSetIndex read_actionset_reference(ProofChecker &proofchecker);
+    KnowledgeIndex read_knowledge_reference();
+
+    void read_in_expression(ProofChecker &proofchecker, Task *task);
+    void read_in_actionset(ProofChecker &proofchecker, Task *task);
+    void read_and_check_knowledge(ProofChecker &proofchecker);
+public:
+    BinaryProofReader(std::string filename);
+    ~BinaryProofReader();
+
+    static bool is_binary_proof(std::string filename);
+
+    void read_last_occ(std::vector<KnowledgeIndex> &last_occ);
+    void check_proof(ProofChecker &proofchecker, Task *task);
+};
+
+/*
+ * Makes a part of the mapped file available as std::istream without copying,
+ * such that basic sets can be parsed with their usual constructors.
+ */
+class MemoryBuffer : public std::streambuf
+{
+public:
+    MemoryBuffer(const char *begin, size_t length);
+};
+
+#endif // BINARYPROOF_H
@@ -14,6 +14,7 @@ Timer timer;
 int g_timeout;
 bool g_discard_formulas;
 Cudd manager;
+thread_local bool is_worker_thread = false;
 
 void initialize_timer() {
     timer = Timer();
@@ -155,7 +156,12 @@ void print_peak_memory_reentrant() {
     TEMP_FAILURE_RETRY(close(proc_file_descr));
 }
 
-void exit_with(ExitCode code) {
+void mark_worker_thread() {
+    is_worker_thread = true;
+}
+
+// writes the exit message and terminates the process, regardless of the thread
+[[noreturn]] void exit_process(ExitCode code) {
     switch(code) {
     case ExitCode::CERTIFICATE_VALID:
         write_reentrant_str(1,"Exiting: certificate is valid\n");
@@ -188,6 +194,13 @@ void exit_with(ExitCode code) {
     exit(static_cast<int>(code));
 }
 
+void exit_with(ExitCode code) {
+    if(is_worker_thread) {
+        throw WorkerExit{code};
+    }
+    exit_process(code);
+}
+
 
 // TODO: why size_t arg? I think it is for using it with the Cudd manager
 void exit_oom(size_t) {
@@ -216,10 +229,11 @@ void signal_handler(int signal_number) {
     std::cout << "abort memory " << get_peak_memory_in_kb() << "KB" << std::endl;
     std::cout << "abort time " << timer << std::endl;
     std::cout << "caught signal " << signal_number << std::endl;
+    // exceptions must not leave a signal handler
     if(signal_number == 24) {
-        exit_with(ExitCode::TIMEOUT);
+        exit_process(ExitCode::TIMEOUT);
     } else {
-        exit_with(ExitCode::CRITICAL_ERROR);
+        exit_process(ExitCode::CRITICAL_ERROR);
     }
 }
 
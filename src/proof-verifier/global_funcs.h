@@ -26,9 +26,18 @@ void initialize_timer();
 void set_timeout(int x);
 void set_discard_formulas(bool b);
 int get_peak_memory_in_kb(bool use_buffered_input = true);
-void exit_with(ExitCode code);
-void exit_oom(size_t size);
-void exit_timeout(std::string);
+/*
+  On worker threads (see mark_worker_thread), exit_with does not terminate the
+  process but throws WorkerExit, which reaches the main thread through the
+  future of the job.
+*/
+struct WorkerExit {
+    ExitCode code;
+};
+void mark_worker_thread();
+[[noreturn]] void exit_with(ExitCode code);
+[[noreturn]] void exit_oom(size_t size);
+[[noreturn]] void exit_timeout(std::string);
 void register_event_handlers();
 
 
@@ -1,6 +1,8 @@
 #include "proofchecker.h"
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <stack>
 #include <fstream>
 #include <math.h>
@@ -8,52 +10,73 @@
 
 #include "global_funcs.h"
 #include "setformulaconstant.h"
-#include "setformulacompound.h"
 
 // TODO: should all error messages here be printed in cerr?
 
-KBEntry::KBEntry() {
+const int ProofChecker::INDEXNONE;
 
+ProofChecker::ProofChecker(int threads)
+    : unsolvability_proven(false), next_canonical_id(0), deferred_checks_valid(true) {
+    if(threads > 1) {
+        pool = std::unique_ptr<ThreadPool>(new ThreadPool(threads));
+    }
+}
+
+void ProofChecker::resize_formulas(size_t size) {
+    formula_types.resize(size, SetFormulaType::CONSTANT);
+    formula_first.resize(size, INDEXNONE);
+    formula_second.resize(size, INDEXNONE);
+    formula_last_occ.resize(size, -1);
+    formula_canonical_ids.resize(size, -1);
 }
 
-ProofChecker::ProofChecker()
-    : unsolvability_proven(false) {
+SetFormula *ProofChecker::get_basic_formula(FormulaIndex fi) {
+    if(formula_first[fi] == INDEXNONE) {
+        return nullptr;
+    }
+    return basic_formulas[formula_first[fi]].get();
+}
 
+bool ProofChecker::is_constant(FormulaIndex fi, ConstantType type) {
+    return formula_types[fi] == SetFormulaType::CONSTANT
+            && formula_second[fi] == static_cast<int>(type);
 }
 
-void ProofChecker::add_kbentry(std::unique_ptr<KBEntry> entry, KnowledgeIndex index) {
-    assert(index >= kbentries.size());
-    if(index > kbentries.size()) {
-        kbentries.resize(index);
+void ProofChecker::add_kbentry(KBType type, int first, int second, KnowledgeIndex index) {
+    assert(index >= kb_types.size());
+    if(index > kb_types.size()) {
+        kb_types.resize(index, KBType::NONE);
+        kb_first.resize(index, INDEXNONE);
+        kb_second.resize(index, INDEXNONE);
     }
-    kbentries.push_back(std::move(entry));
+    kb_types.push_back(type);
+    kb_first.push_back(first);
+    kb_second.push_back(second);
 }
 
-SetFormula *ProofChecker::gather_sets_intersection(SetFormula *f,
+SetFormula *ProofChecker::gather_sets_intersection(FormulaIndex fi,
                                             std::vector<SetFormula *> &positive,
                                             std::vector<SetFormula *> &negative) {
     SetFormula *ret = nullptr;
-    switch(f->get_formula_type()) {
+    switch(formula_types[fi]) {
     case SetFormulaType::CONSTANT:
     case SetFormulaType::BDD:
     case SetFormulaType::HORN:
     case SetFormulaType::DUALHORN:
     case SetFormulaType::TWOCNF:
     case SetFormulaType::EXPLICIT:
-        positive.push_back(f);
-        ret = f;
+        ret = get_basic_formula(fi);
+        if(ret) {
+            positive.push_back(ret);
+        }
         break;
     case SetFormulaType::NEGATION:
-        f = formulas[dynamic_cast<SetFormulaNegation *>(f)->get_subformula_index()].fpointer.get();
-        ret = gather_sets_intersection(f, negative, positive);
+        ret = gather_sets_intersection(formula_first[fi], negative, positive);
         break;
     case SetFormulaType::INTERSECTION: {
-        SetFormulaIntersection *fi = dynamic_cast<SetFormulaIntersection *>(f);
-        ret = gather_sets_intersection(formulas[fi->get_left_index()].fpointer.get(),
-                positive, negative);
+        ret = gather_sets_intersection(formula_first[fi], positive, negative);
         if(ret) {
-            SetFormula *ret2 = gather_sets_intersection(formulas[fi->get_right_index()].fpointer.get(),
-                positive, negative);
+            SetFormula *ret2 = gather_sets_intersection(formula_second[fi], positive, negative);
             if(ret->get_formula_type() == SetFormulaType::CONSTANT) {
                 ret = ret2;
             }
@@ -66,31 +89,29 @@ SetFormula *ProofChecker::gather_sets_intersection(SetFormula *f,
     return ret;
 }
 
-SetFormula *ProofChecker::gather_sets_union(SetFormula *f,
+SetFormula *ProofChecker::gather_sets_union(FormulaIndex fi,
                                      std::vector<SetFormula *> &positive,
                                      std::vector<SetFormula *> &negative) {
     SetFormula *ret = nullptr;
-    switch(f->get_formula_type()) {
+    switch(formula_types[fi]) {
     case SetFormulaType::CONSTANT:
     case SetFormulaType::BDD:
     case SetFormulaType::HORN:
     case SetFormulaType::DUALHORN:
     case SetFormulaType::TWOCNF:
     case SetFormulaType::EXPLICIT:
-        positive.push_back(f);
-        ret = f;
+        ret = get_basic_formula(fi);
+        if(ret) {
+            positive.push_back(ret);
+        }
         break;
     case SetFormulaType::NEGATION:
-        f = formulas[dynamic_cast<SetFormulaNegation *>(f)->get_subformula_index()].fpointer.get();
-        ret = gather_sets_union(f, negative, positive);
+        ret = gather_sets_union(formula_first[fi], negative, positive);
         break;
     case SetFormulaType::UNION: {
-        SetFormulaUnion *fi = dynamic_cast<SetFormulaUnion *>(f);
-        ret = gather_sets_union(formulas[fi->get_left_index()].fpointer.get(),
-                positive, negative);
+        ret = gather_sets_union(formula_first[fi], positive, negative);
         if(ret) {
-            SetFormula *ret2 = gather_sets_union(formulas[fi->get_right_index()].fpointer.get(),
-                positive, negative);
+            SetFormula *ret2 = gather_sets_union(formula_second[fi], positive, negative);
             if(ret->get_formula_type() == SetFormulaType::CONSTANT) {
                 ret = ret2;
             }
@@ -120,13 +141,228 @@ SetFormula *ProofChecker::update_reference_and_check_consistency(
     return reference_formula;
 }
 
+/*
+ * Hands the subset check to the worker pool if it only involves formalisms
+ * that do not use the (not thread-safe) global Cudd manager. Checks involving
+ * only constant sets are also done directly, since they might initialize
+ * static members of the concrete formula types.
+ */
+bool ProofChecker::defer_check(std::string stmt, KnowledgeIndex newki,
+                               FormulaIndex fi1, FormulaIndex fi2,
+                               std::vector<SetFormula *> involved,
+                               std::function<bool()> check) {
+    if(!pool) {
+        return false;
+    }
+    bool has_concrete_formula = false;
+    for(SetFormula *f : involved) {
+        switch(f->get_formula_type()) {
+        case SetFormulaType::HORN:
+        case SetFormulaType::DUALHORN:
+        case SetFormulaType::TWOCNF:
+        case SetFormulaType::EXPLICIT:
+            has_concrete_formula = true;
+            break;
+        case SetFormulaType::CONSTANT:
+            break;
+        default:
+            return false;
+        }
+    }
+    if(!has_concrete_formula) {
+        return false;
+    }
+    // limit the amount of pending checks since they keep their formulas alive
+    collect_deferred_checks(4*pool->size());
+    std::vector<int> positions;
+    collect_basic_formulas(fi1, positions);
+    collect_basic_formulas(fi2, positions);
+    std::sort(positions.begin(), positions.end());
+    positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+    for(int position : positions) {
+        pending_basic_uses[position]++;
+    }
+    DeferredCheck deferred = {newki, fi1, fi2, stmt, std::move(positions), pool->submit(check)};
+    deferred_checks.push_back(std::move(deferred));
+    return true;
+}
+
+void ProofChecker::collect_deferred_checks(size_t max_pending) {
+    while(!deferred_checks.empty()) {
+        DeferredCheck &front = deferred_checks.front();
+        if(max_pending > 0 && deferred_checks.size() < max_pending &&
+           front.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return;
+        }
+        while(front.result.wait_for(std::chrono::seconds(1)) != std::future_status::ready) {
+            if(timer() > g_timeout) {
+                // the workers must be joined before the process exits
+                pool.reset();
+                exit_timeout("");
+            }
+        }
+        bool holds = false;
+        try {
+            holds = front.result.get();
+        } catch(const WorkerExit &worker_exit) {
+            pool.reset();
+            exit_with(worker_exit.code);
+        }
+        if(!holds) {
+            std::cerr << "Error when checking statement " << front.stmt << ": set expression #"
+                      << front.fi1 << " is not a subset of set expression #"
+                      << front.fi2 << "." << std::endl;
+            std::cerr << "check for knowledge #" << front.ki << " NOT successful!" << std::endl;
+            deferred_checks_valid = false;
+        }
+        for(int position : front.basic_formulas) {
+            auto it = pending_basic_uses.find(position);
+            if(--(it->second) == 0) {
+                pending_basic_uses.erase(it);
+                if(obsolete_basic_formulas.erase(position) > 0) {
+                    basic_formulas[position].reset();
+                }
+            }
+        }
+        if (g_discard_formulas) {
+            remove_formulas_if_obsolete({front.fi1,front.fi2}, front.ki);
+        }
+        deferred_checks.pop_front();
+    }
+}
+
 void ProofChecker::add_formula(std::unique_ptr<SetFormula> formula, FormulaIndex index) {
-    // if g_discard_formulas, first_pass() will guarantee that the entry for this index exists already
-    if (!g_discard_formulas && index >= formulas.size()) {
-        formulas.resize(index+1);
+    /*
+     * With g_discard_formulas, first_pass() or the last_occ trailer usually
+     * sized the arrays already. A short trailer does not, and the sets it
+     * misses are never discarded.
+     */
+    if (index >= formula_types.size()) {
+        resize_formulas(index+1);
+    }
+    assert(formula_first[index] == INDEXNONE);
+    formula_types[index] = formula->get_formula_type();
+    formula_first[index] = basic_formulas.size();
+    if(formula_types[index] == SetFormulaType::CONSTANT) {
+        SetFormulaConstant *constant = static_cast<SetFormulaConstant *>(formula.get());
+        formula_second[index] = static_cast<int>(constant->get_constant_type());
+    }
+    basic_formulas.push_back(std::move(formula));
+    formula_canonical_ids[index] = compute_canonical_id(index);
+}
+
+void ProofChecker::add_compound_formula(SetFormulaType type, FormulaIndex first, int second,
+                                        FormulaIndex index) {
+    // see add_formula
+    if (index >= formula_types.size()) {
+        resize_formulas(index+1);
+    }
+    assert(formula_first[index] == INDEXNONE);
+    formula_types[index] = type;
+    formula_first[index] = first;
+    formula_second[index] = second;
+    formula_canonical_ids[index] = compute_canonical_id(index);
+}
+
+int ProofChecker::get_canonical_id(const CanonicalKey &key) {
+    auto it = canonical_ids.find(key);
+    if(it != canonical_ids.end()) {
+        return it->second;
+    }
+    canonical_ids.insert(std::make_pair(key, next_canonical_id));
+    return next_canonical_id++;
+}
+
+// the subformulas of compound formulas are declared before, so their ids are already known
+int ProofChecker::compute_canonical_id(FormulaIndex fi) {
+    int type = static_cast<int>(formula_types[fi]);
+    switch(formula_types[fi]) {
+    case SetFormulaType::CONSTANT:
+        return get_canonical_id({type, formula_second[fi], -1});
+    case SetFormulaType::NEGATION: {
+        int sub = formula_canonical_ids[formula_first[fi]];
+        // \neg \neg S is S
+        auto it = negated_canonical_ids.find(sub);
+        if(it != negated_canonical_ids.end()) {
+            return it->second;
+        }
+        int id = get_canonical_id({type, sub, -1});
+        negated_canonical_ids[id] = sub;
+        return id;
+    }
+    case SetFormulaType::INTERSECTION:
+    case SetFormulaType::UNION: {
+        int left = formula_canonical_ids[formula_first[fi]];
+        int right = formula_canonical_ids[formula_second[fi]];
+        return get_canonical_id({type, std::min(left, right), std::max(left, right)});
+    }
+    case SetFormulaType::PROGRESSION:
+    case SetFormulaType::REGRESSION:
+        return get_canonical_id({type, formula_canonical_ids[formula_first[fi]],
+                                 actionset_canonical_ids[formula_second[fi]]});
+    default:
+        // basic sets are only equal to themselves
+        return next_canonical_id++;
+    }
+}
+
+bool ProofChecker::reuse_verified_subset(int statement, KnowledgeIndex newki,
+                                         FormulaIndex fi1, FormulaIndex fi2) {
+    CanonicalKey key = {statement, formula_canonical_ids[fi1], formula_canonical_ids[fi2]};
+    if(verified_subsets.find(key) == verified_subsets.end()) {
+        return false;
     }
-    assert(!formulas[index].fpointer);
-    formulas[index].fpointer = std::move(formula);
+    add_kbentry(KBType::SUBSET, fi1, fi2, newki);
+    /*
+     * The check that verified the key might still be pending; its sets are
+     * then only marked and discarded once the check has been collected
+     * (see discard_basic_formula).
+     */
+    if (g_discard_formulas) {
+        remove_formulas_if_obsolete({fi1,fi2}, newki);
+    }
+    return true;
+}
+
+void ProofChecker::collect_basic_formulas(FormulaIndex fi, std::vector<int> &positions) {
+    switch (formula_types[fi]) {
+    case SetFormulaType::BDD:
+    case SetFormulaType::HORN:
+    case SetFormulaType::DUALHORN:
+    case SetFormulaType::TWOCNF:
+    case SetFormulaType::EXPLICIT:
+        positions.push_back(formula_first[fi]);
+        break;
+    case SetFormulaType::NEGATION:
+    case SetFormulaType::PROGRESSION:
+    case SetFormulaType::REGRESSION:
+        collect_basic_formulas(formula_first[fi], positions);
+        break;
+    case SetFormulaType::INTERSECTION:
+    case SetFormulaType::UNION:
+        collect_basic_formulas(formula_first[fi], positions);
+        collect_basic_formulas(formula_second[fi], positions);
+        break;
+    default:
+        break;
+    }
+}
+
+// a deferred check might still read the set, in which case it is discarded when collecting the check
+void ProofChecker::discard_basic_formula(int position) {
+    if(pending_basic_uses.find(position) != pending_basic_uses.end()) {
+        obsolete_basic_formulas.insert(position);
+    } else {
+        basic_formulas[position].reset();
+    }
+}
+
+/*
+ * Deferred checks are marked as well: if they fail, the proof is invalid
+ * regardless of which statements reused them.
+ */
+void ProofChecker::mark_verified_subset(int statement, FormulaIndex fi1, FormulaIndex fi2) {
+    verified_subsets.insert({statement, formula_canonical_ids[fi1], formula_canonical_ids[fi2]});
 }
 
 void ProofChecker::add_actionset(std::unique_ptr<ActionSet> actionset, ActionSetIndex index) {
@@ -134,6 +370,13 @@ void ProofChecker::add_actionset(std::unique_ptr<ActionSet> actionset, ActionSet
     if(index > actionsets.size()) {
         actionsets.resize(index);
     }
+    actionset_canonical_ids.resize(index);
+    // all constant-all action sets contain the same actions
+    if(actionset->is_constantall()) {
+        actionset_canonical_ids.push_back(get_canonical_id({ACTIONSET_ALL, -1, -1}));
+    } else {
+        actionset_canonical_ids.push_back(next_canonical_id++);
+    }
     actionsets.push_back(std::move(actionset));
 }
 
@@ -145,45 +388,40 @@ void ProofChecker::add_actionset_union(ActionSetIndex left, ActionSetIndex right
     actionsets.push_back(std::unique_ptr<ActionSet>(
                              new ActionSetUnion(actionsets[left].get(),
                                                 actionsets[right].get())));
+    int left_id = actionset_canonical_ids[left];
+    int right_id = actionset_canonical_ids[right];
+    actionset_canonical_ids.resize(index);
+    if(left_id == right_id) {
+        actionset_canonical_ids.push_back(left_id);
+    } else {
+        actionset_canonical_ids.push_back(get_canonical_id(
+            {ACTIONSET_UNION, std::min(left_id, right_id), std::max(left_id, right_id)}));
+    }
 }
 
 void ProofChecker::remove_formulas_if_obsolete(std::vector<int> indices, int current_ki) {
     for(int index: indices) {
-        if(formulas[index].last_occ == current_ki) {
-            switch (formulas[index].fpointer.get()->get_formula_type()) {
+        if(formula_last_occ[index] == current_ki) {
+            switch (formula_types[index]) {
             case SetFormulaType::BDD:
             case SetFormulaType::HORN:
             case SetFormulaType::DUALHORN:
             case SetFormulaType::TWOCNF:
             case SetFormulaType::EXPLICIT:
-                formulas[index].fpointer.reset();
-                break;
-            case SetFormulaType::NEGATION: {
-                SetFormulaNegation *f = dynamic_cast<SetFormulaNegation *>(formulas[index].fpointer.get());
-                remove_formulas_if_obsolete({f->get_subformula_index()}, current_ki);
-                break;
-            }
-            case SetFormulaType::PROGRESSION: {
-                SetFormulaProgression *f = dynamic_cast<SetFormulaProgression *>(formulas[index].fpointer.get());
-                remove_formulas_if_obsolete({f->get_subformula_index()}, current_ki);
+                discard_basic_formula(formula_first[index]);
                 break;
-            }
-            case SetFormulaType::REGRESSION: {
-                SetFormulaRegression *f = dynamic_cast<SetFormulaRegression *>(formulas[index].fpointer.get());
-                remove_formulas_if_obsolete({f->get_subformula_index()}, current_ki);
+            case SetFormulaType::NEGATION:
+            case SetFormulaType::PROGRESSION:
+            case SetFormulaType::REGRESSION:
+                remove_formulas_if_obsolete({formula_first[index]}, current_ki);
                 break;
-            }
-            case SetFormulaType::INTERSECTION: {
-                SetFormulaIntersection *f = dynamic_cast<SetFormulaIntersection *>(formulas[index].fpointer.get());
-                remove_formulas_if_obsolete({f->get_left_index(), f->get_right_index()}, current_ki);
+            case SetFormulaType::INTERSECTION:
+            case SetFormulaType::UNION:
+                remove_formulas_if_obsolete({formula_first[index], formula_second[index]}, current_ki);
                 break;
-            }
-            case SetFormulaType::UNION: {
-                SetFormulaUnion *f = dynamic_cast<SetFormulaUnion *>(formulas[index].fpointer.get());
-                remove_formulas_if_obsolete({f->get_left_index(), f->get_right_index()}, current_ki);
+            default:
                 break;
             }
-            }
 
         }
     }
@@ -230,8 +468,8 @@ void ProofChecker::first_pass(std::string certfile) {
                 certstream.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
             }
 
-            if(mainsetid >= formulas.size()) {
-                formulas.resize(mainsetid+1);
+            if(mainsetid >= formula_types.size()) {
+                resize_formulas(mainsetid+1);
             }
         } else if(input == "k") {
             certstream >> kid;
@@ -244,8 +482,8 @@ void ProofChecker::first_pass(std::string certfile) {
                 certstream >> set2;
                 certstream >> input;
                 if(input.at(0) == 'b') {
-                    formulas[set1].last_occ = kid;
-                    formulas[set2].last_occ = kid;
+                    formula_last_occ[set1] = kid;
+                    formula_last_occ[set2] = kid;
                     continue;
                 }
             }
@@ -267,29 +505,102 @@ void ProofChecker::first_pass(std::string certfile) {
         cset = rit->first;
         sset1 = rit->second.first;
         sset2 = rit->second.second;
-        formulas[sset1].last_occ = std::max(formulas[sset1].last_occ, formulas[cset].last_occ);
+        formula_last_occ[sset1] = std::max(formula_last_occ[sset1], formula_last_occ[cset]);
         if(sset2 >= 0) {
-            formulas[sset2].last_occ = std::max(formulas[sset2].last_occ, formulas[cset].last_occ);
+            formula_last_occ[sset2] = std::max(formula_last_occ[sset2], formula_last_occ[cset]);
         }
     }
 
 
     // constant formulas should never be deleted
     for(size_t i = 0; i < constant_formulas.size(); ++i) {
-        formulas[constant_formulas[i]].last_occ = -1;
+        formula_last_occ[constant_formulas[i]] = -1;
     }
 }
 
+void ProofChecker::set_last_occ(const std::vector<KnowledgeIndex> &last_occ) {
+    if(last_occ.size() > formula_types.size()) {
+        resize_formulas(last_occ.size());
+    }
+    for(size_t i = 0; i < last_occ.size(); ++i) {
+        formula_last_occ[i] = last_occ[i];
+    }
+}
+
+bool ProofChecker::is_formula_declared(FormulaIndex fi) const {
+    return fi >= 0 && static_cast<size_t>(fi) < formula_types.size()
+            && formula_first[fi] != INDEXNONE;
+}
+
+bool ProofChecker::is_actionset_declared(ActionSetIndex ai) const {
+    return ai >= 0 && static_cast<size_t>(ai) < actionsets.size() && actionsets[ai];
+}
+
+size_t ProofChecker::get_actionset_amount() const {
+    return actionsets.size();
+}
+
+bool ProofChecker::is_knowledge_derived(KnowledgeIndex ki) const {
+    return ki >= 0 && static_cast<size_t>(ki) < kb_types.size()
+            && kb_types[ki] != KBType::NONE;
+}
+
+/*
+ * The planner appends the last occurences as the comment lines
+ *   #last_occ <n> <last_occ of set 0> ... <last_occ of set n-1>
+ *   #last_occ_offset <byte offset of the #last_occ line, 20 digits>
+ * Since the last line has a fixed size, we can find the trailer without
+ * reading the rest of the proof.
+ */
+bool ProofChecker::read_last_occ_trailer(std::string certfile) {
+    const std::string offset_prefix = "#last_occ_offset ";
+    const std::streamoff offset_line_size = offset_prefix.size() + 20 + 1;
+    std::ifstream certstream(certfile, std::ios::binary);
+    if(!certstream.is_open()) {
+        return false;
+    }
+    certstream.seekg(0, std::ios::end);
+    std::streamoff filesize = certstream.tellg();
+    if(filesize < offset_line_size) {
+        return false;
+    }
+    certstream.seekg(filesize - offset_line_size);
+    std::string offset_line(offset_line_size, ' ');
+    certstream.read(&offset_line[0], offset_line_size);
+    if(offset_line.compare(0, offset_prefix.size(), offset_prefix) != 0
+            || offset_line.back() != '\n') {
+        return false;
+    }
+    std::streamoff trailer_pos = std::stoll(offset_line.substr(offset_prefix.size(), 20));
+    if(trailer_pos < 0 || trailer_pos >= filesize - offset_line_size) {
+        return false;
+    }
+
+    certstream.seekg(trailer_pos);
+    std::string input;
+    size_t amount;
+    if(!(certstream >> input >> amount) || input != "#last_occ") {
+        return false;
+    }
+    std::vector<KnowledgeIndex> last_occ(amount);
+    for(size_t i = 0; i < amount; ++i) {
+        if(!(certstream >> last_occ[i])) {
+            return false;
+        }
+    }
+    set_last_occ(last_occ);
+    return true;
+}
+
 // KBEntry newki says that f=emptyset is dead
 bool ProofChecker::check_rule_D1(KnowledgeIndex newki, FormulaIndex fi) {
 
-    SetFormulaConstant *f = dynamic_cast<SetFormulaConstant *>(formulas[fi].fpointer.get());
-    if ((!f) || (f->get_constant_type() != ConstantType::EMPTY)) {
+    if (!is_constant(fi, ConstantType::EMPTY)) {
         std::cerr << "Error when applying rule D1: set expression #" << fi
                   << " is not the constant empty set." << std::endl;
         return false;
     }
-    add_kbentry(std::unique_ptr<KBEntry>(new KBEntryDead(fi)), newki);
+    add_kbentry(KBType::DEAD, fi, INDEXNONE, newki);
     return true;
 }
 
@@ -297,21 +608,20 @@ bool ProofChecker::check_rule_D1(KnowledgeIndex newki, FormulaIndex fi) {
 // KBEntry newki says that f=S \union S' is dead based on k1 (S is dead) and k2 (S' is dead)
 bool ProofChecker::check_rule_D2(KnowledgeIndex newki, FormulaIndex fi,
                                KnowledgeIndex ki1, KnowledgeIndex ki2) {
-    assert(kbentries[ki1] && kbentries[ki2]);
+    assert(kb_types[ki1] != KBType::NONE && kb_types[ki2] != KBType::NONE);
 
     // f represents left \cup right
-    SetFormulaUnion *f = dynamic_cast<SetFormulaUnion *>(formulas[fi].fpointer.get());
-    if (!f) {
+    if (formula_types[fi] != SetFormulaType::UNION) {
         std::cerr << "Error when applying rule D2: set expression #" << fi
                   << "is not a union." << std::endl;
         return false;
     }
-    FormulaIndex lefti = f->get_left_index();
-    FormulaIndex righti = f->get_right_index();
+    FormulaIndex lefti = formula_first[fi];
+    FormulaIndex righti = formula_second[fi];
 
     // check if k1 says that left is dead
-    if ((kbentries[ki1].get()->get_kbentry_type() != KBType::DEAD) ||
-        (kbentries[ki1].get()->get_first() != lefti)) {
+    if ((kb_types[ki1] != KBType::DEAD) ||
+        (kb_first[ki1] != lefti)) {
         std::cerr << "Error when applying rule D2: Knowledge #" << ki1
                   << "does not state that set expression #" << lefti
                   << " is dead." << std::endl;
@@ -319,15 +629,15 @@ bool ProofChecker::check_rule_D2(KnowledgeIndex newki, FormulaIndex fi,
     }
 
     // check if k2 says that right is dead
-    if ((kbentries[ki2].get()->get_kbentry_type() != KBType::DEAD) ||
-        (kbentries[ki2].get()->get_first() != righti)) {
+    if ((kb_types[ki2] != KBType::DEAD) ||
+        (kb_first[ki2] != righti)) {
         std::cerr << "Error when applying rule D2: Knowledge #" << ki2
                   << "does not state that set expression #" << righti
                   << " is dead." << std::endl;
         return false;
     }
 
-    add_kbentry(std::unique_ptr<KBEntry>(new KBEntryDead(fi)), newki);
+    add_kbentry(KBType::DEAD, fi, INDEXNONE, newki);
     return true;
 }
 
@@ -335,75 +645,73 @@ bool ProofChecker::check_rule_D2(KnowledgeIndex newki, FormulaIndex fi,
 // KBEntry newki says that f=S is dead based on k1 (S \subseteq S') and k2 (S' is dead)
 bool ProofChecker::check_rule_D3(KnowledgeIndex newki, FormulaIndex fi,
                                KnowledgeIndex ki1, KnowledgeIndex ki2) {
-    assert(kbentries[ki1] != nullptr && kbentries[ki2] != nullptr);
+    assert(kb_types[ki1] != KBType::NONE && kb_types[ki2] != KBType::NONE);
 
     // check if k1 says that f is a subset of "x" (x can be anything)
-    if ((kbentries[ki1]->get_kbentry_type() != KBType::SUBSET) ||
-       (kbentries[ki1]->get_first() != fi)) {
+    if ((kb_types[ki1] != KBType::SUBSET) ||
+       (kb_first[ki1] != fi)) {
         std::cerr << "Error when applying rule D3: knowledge #" << ki1
                   << " does not state that set expression #" << fi
                   << " is a subset of another set." << std::endl;
         return false;
     }
 
-    FormulaIndex xi = kbentries[ki1]->get_second();
+    FormulaIndex xi = kb_second[ki1];
 
     // check if k2 says that x is dead
-    if ((kbentries[ki2]->get_kbentry_type() != KBType::DEAD) ||
-       (kbentries[ki2]->get_first() != xi)) {
+    if ((kb_types[ki2] != KBType::DEAD) ||
+       (kb_first[ki2] != xi)) {
         std::cerr << "Error when applying rule D3: knowledge #" << ki1
                   << " states that set expression #" << fi
                   << " is a subset of set expression #" << xi << ", but knowledge #" << ki2
                   << " does not state that " << xi << " is dead." << std::endl;
         return false;
     }
-    add_kbentry(std::unique_ptr<KBEntry>(new KBEntryDead(fi)), newki);
+    add_kbentry(KBType::DEAD, fi, INDEXNONE, newki);
     return true;
 }
 
 
 // KBEntry newki says that the task is unsolvable based on k ({I} is dead)
 bool ProofChecker::check_rule_D4(KnowledgeIndex newki, KnowledgeIndex ki) {
-    assert(kbentries[ki] != nullptr);
+    assert(kb_types[ki] != KBType::NONE);
 
     // check that k says that {I} is dead
-    if (kbentries[ki]->get_kbentry_type() != KBType::DEAD) {
+    if (kb_types[ki] != KBType::DEAD) {
         std::cerr << "Error when applying rule D4: knowledge #" << ki
                   << " is not of type DEAD." << std::endl;
         return false;
     }
-    SetFormulaConstant *init =
-            dynamic_cast<SetFormulaConstant *>(formulas[kbentries[ki]->get_first()].fpointer.get());
-    if ((!init) || (init->get_constant_type() != ConstantType::INIT)) {
+    FormulaIndex init = kb_first[ki];
+    if (!is_constant(init, ConstantType::INIT)) {
         std::cerr << "Error when applying rule D4: knowledge #" << ki
                   << " does not state that the constant initial set is dead." << std::endl;
         return false;
     }
 
-    add_kbentry(std::unique_ptr<KBEntry>(new KBEntryUnsolvable()), newki);
+    add_kbentry(KBType::UNSOLVABLE, INDEXNONE, INDEXNONE, newki);
     unsolvability_proven = true;
     return true;
 }
 
 // KBEntry newki says that the task is unsolvable based on k (S_G(\Pi) is dead)
 bool ProofChecker::check_rule_D5(KnowledgeIndex newki, KnowledgeIndex ki) {
-    assert(kbentries[ki] != nullptr);
+    assert(kb_types[ki] != KBType::NONE);
 
     // check that k says that S_G(\Pi) is dead
-    if (kbentries[ki]->get_kbentry_type() != KBType::DEAD) {
+    if (kb_types[ki] != KBType::DEAD) {
         std::cerr << "Error when applying rule D5: knowledge #" << ki
                   << " is not of type DEAD." << std::endl;
         return false;
     }
-    SetFormulaConstant *goal =
-            dynamic_cast<SetFormulaConstant *>(formulas[kbentries[ki]->get_first()].fpointer.get());
-    if ( (!goal) || (goal->get_constant_type() != ConstantType::GOAL)) {
+    FormulaIndex goal = kb_first[ki];
+    if (!is_constant(goal, ConstantType::GOAL)) {
         std::cerr << "Error when applying rule D5: knowledge #" << ki
                   << " does not state that the constant goal set is dead." << std::endl;
         return false;
     }
 
-    add_kbentry(std::unique_ptr<KBEntry>(new KBEntryUnsolvable()), newki);
+    add_kbentry(KBType::UNSOLVABLE, INDEXNONE, INDEXNONE, newki);
     unsolvability_proven = true;
     return true;
 }
@@ -413,72 +721,68 @@ bool ProofChecker::check_rule_D5(KnowledgeIndex newki, KnowledgeIndex ki) {
 // k2 (S' is dead) and k3 (S \cap S_G(\Pi) is dead)
 bool ProofChecker::check_rule_D6(KnowledgeIndex newki, FormulaIndex fi,
                                KnowledgeIndex ki1, KnowledgeIndex ki2, KnowledgeIndex ki3) {
-    assert(kbentries[ki1] != nullptr && kbentries[ki2] != nullptr && kbentries[ki3] != nullptr);
+    assert(kb_types[ki1] != KBType::NONE && kb_types[ki2] != KBType::NONE && kb_types[ki3] != KBType::NONE);
 
     // check if k1 says that S[A] \subseteq S \cup S'
-    if (kbentries[ki1]->get_kbentry_type() != KBType::SUBSET) {
+    if (kb_types[ki1] != KBType::SUBSET) {
         std::cerr << "Error when applying rule D6: knowledge #" << ki1
                   << " is not of type SUBSET." << std::endl;
         return false;
     }
     // check if the left side of k1 is S[A]
-    SetFormulaProgression *s_prog =
-            dynamic_cast<SetFormulaProgression *>(formulas[kbentries[ki1]->get_first()].fpointer.get());
-    if ((!s_prog) || (s_prog->get_subformula_index() != fi)) {
+    FormulaIndex s_prog = kb_first[ki1];
+    if ((formula_types[s_prog] != SetFormulaType::PROGRESSION) || (formula_first[s_prog] != fi)) {
         std::cerr << "Error when applying rule D6: the left side of subset knowledge #" << ki1
                   << " is not the progression of set expression #" << fi << "." << std::endl;
         return false;
     }
-    if(!actionsets[s_prog->get_actionset_index()].get()->is_constantall()) {
+    if(!actionsets[formula_second[s_prog]].get()->is_constantall()) {
         std::cerr << "Error when applying rule D6: "
                      "the progression does not speak about all actions" << std::endl;
         return false;
     }
     // check f the right side of k1 is S \cup S'
-    SetFormulaUnion *s_cup_sp =
-            dynamic_cast<SetFormulaUnion *>(formulas[kbentries[ki1]->get_second()].fpointer.get());
-    if((!s_cup_sp) || (s_cup_sp->get_left_index() != fi)) {
+    FormulaIndex s_cup_sp = kb_second[ki1];
+    if((formula_types[s_cup_sp] != SetFormulaType::UNION) || (formula_first[s_cup_sp] != fi)) {
         std::cerr << "Error when applying rule D6: the right side of subset knowledge #" << ki1
                   << " is not a union of set expression #" << fi
                   << " and another set expression." << std::endl;
         return false;
     }
 
-    FormulaIndex spi = s_cup_sp->get_right_index();
+    FormulaIndex spi = formula_second[s_cup_sp];
 
     // check if k2 says that S' is dead
-    if ((kbentries[ki2]->get_kbentry_type() != KBType::DEAD) ||
-       (kbentries[ki2]->get_first() != spi)) {
+    if ((kb_types[ki2] != KBType::DEAD) ||
+       (kb_first[ki2] != spi)) {
         std::cerr << "Error when applying rule D6: knowledge #" << ki2
                   << " does not state that set expression #" << spi << " is dead." << std::endl;
         return false;
     }
 
     // check if k3 says that S \cap S_G(\Pi) is dead
-    if (kbentries[ki3]->get_kbentry_type() != KBType::DEAD) {
+    if (kb_types[ki3] != KBType::DEAD) {
         std::cerr << "Error when applying rule D6: knowledge #" << ki3
                  << " is not of type DEAD." << std::endl;
         return false;
     }
-    SetFormulaIntersection *s_and_goal =
-            dynamic_cast<SetFormulaIntersection *>(formulas[kbentries[ki3]->get_first()].fpointer.get());
+    FormulaIndex s_and_goal = kb_first[ki3];
     // check if left side of s_and goal is S
-    if ((!s_and_goal) || (s_and_goal->get_left_index() != fi)) {
+    if ((formula_types[s_and_goal] != SetFormulaType::INTERSECTION) || (formula_first[s_and_goal] != fi)) {
         std::cerr << "Error when applying rule D6: the set expression declared dead in knowledge #"
                   << ki3 << " is not an intersection with set expression #" << fi
                   << " on the left side." << std::endl;
         return false;
     }
-    SetFormulaConstant *goal =
-            dynamic_cast<SetFormulaConstant *>(formulas[s_and_goal->get_right_index()].fpointer.get());
-    if((!goal) || (goal->get_constant_type() != ConstantType::GOAL)) {
+    FormulaIndex goal = formula_second[s_and_goal];
+    if(!is_constant(goal, ConstantType::GOAL)) {
         std::cerr << "Error when applying rule D6: the set expression declared dead in knowledge #"
                   << ki3 << " is not an intersection with the constant goal set on the right side."
                   << std::endl;
         return false;
     }
 
-    add_kbentry(std::unique_ptr<KBEntry>(new KBEntryDead(fi)), newki);
+    add_kbentry(KBType::DEAD, fi, INDEXNONE, newki);
     return true;
 }
 
@@ -487,78 +791,75 @@ bool ProofChecker::check_rule_D6(KnowledgeIndex newki, FormulaIndex fi,
 // k2 (S' is dead) and k3 ({I} \subseteq S_not)
 bool ProofChecker::check_rule_D7(KnowledgeIndex newki, FormulaIndex fi,
                                KnowledgeIndex ki1, KnowledgeIndex ki2, KnowledgeIndex ki3) {
-    assert(kbentries[ki1] != nullptr && kbentries[ki2] != nullptr && kbentries[ki3] != nullptr);
+    assert(kb_types[ki1] != KBType::NONE && kb_types[ki2] != KBType::NONE && kb_types[ki3] != KBType::NONE);
 
     // check if fi corresponds to s_not
-    SetFormulaNegation *s_not = dynamic_cast<SetFormulaNegation *>(formulas[fi].fpointer.get());
-    if(!s_not) {
+    FormulaIndex s_not = fi;
+    if(formula_types[s_not] != SetFormulaType::NEGATION) {
         std::cerr << "Error when applying rule D7: set expression #" << fi
                   << " is not a negation." << std::endl;
         return false;
     }
-    FormulaIndex si = s_not->get_subformula_index();
+    FormulaIndex si = formula_first[s_not];
 
     // check if k1 says that S[A] \subseteq S \cup S'
-    if (kbentries[ki1]->get_kbentry_type() != KBType::SUBSET) {
+    if (kb_types[ki1] != KBType::SUBSET) {
         std::cerr << "Error when applying rule D7: knowledge #" << ki1
                   << " is not of type SUBSET." << std::endl;
         return false;
     }
     // check if the left side of k1 is S[A]
-    SetFormulaProgression *s_prog =
-            dynamic_cast<SetFormulaProgression *>(formulas[kbentries[ki1]->get_first()].fpointer.get());
-    if ((!s_prog) || (s_prog->get_subformula_index() != si)) {
+    FormulaIndex s_prog = kb_first[ki1];
+    if ((formula_types[s_prog] != SetFormulaType::PROGRESSION) || (formula_first[s_prog] != si)) {
         std::cerr << "Error when applying rule D7: the left side of subset knowledge #" << ki1
                   << " is not the progression of set expression #" << si << "." << std::endl;
         return false;
     }
-    if(!actionsets[s_prog->get_actionset_index()].get()->is_constantall()) {
+    if(!actionsets[formula_second[s_prog]].get()->is_constantall()) {
         std::cerr << "Error when applying rule D7: "
                      "the progression does not speak about all actions" << std::endl;
         return false;
     }
     // check f the right side of k1 is S \cup S'
-    SetFormulaUnion *s_cup_sp =
-            dynamic_cast<SetFormulaUnion *>(formulas[kbentries[ki1]->get_second()].fpointer.get());
-    if((!s_cup_sp) || (s_cup_sp->get_left_index() != si)) {
+    FormulaIndex s_cup_sp = kb_second[ki1];
+    if((formula_types[s_cup_sp] != SetFormulaType::UNION) || (formula_first[s_cup_sp] != si)) {
         std::cerr << "Error when applying rule D7: the right side of subset knowledge #" << ki1
                   << " is not a union of set expression #" << si
                   << " and another set expression." << std::endl;
         return false;
     }
 
-    FormulaIndex spi = s_cup_sp->get_right_index();
+    FormulaIndex spi = formula_second[s_cup_sp];
 
     // check if k2 says that S' is dead
-    if ((kbentries[ki2]->get_kbentry_type() != KBType::DEAD) ||
-       (kbentries[ki2]->get_first() != spi)) {
+    if ((kb_types[ki2] != KBType::DEAD) ||
+       (kb_first[ki2] != spi)) {
         std::cerr << "Error when applying rule D7: knowledge #" << ki2
                   << " does not state that set expression #" << spi << " is dead." << std::endl;
         return false;
     }
 
     // check if k3 says that {I} \subseteq S
-    if (kbentries[ki3]->get_kbentry_type() != KBType::SUBSET) {
+    if (kb_types[ki3] != KBType::SUBSET) {
         std::cerr << "Error when applying rule D7: knowledge #" << ki3
                  << " is not of type SUBSET." << std::endl;
         return false;
     }
     // check that left side of k3 is {I}
-    SetFormulaConstant *init =
-            dynamic_cast<SetFormulaConstant *>(formulas[kbentries[ki3]->get_first()].fpointer.get());
-    if((!init) || (init->get_constant_type() != ConstantType::INIT)) {
+    FormulaIndex init = kb_first[ki3];
+    if(!is_constant(init, ConstantType::INIT)) {
         std::cerr << "Error when applying rule D7: the left side of subset knowledge #" << ki3
                   << " is not the constant initial set." << std::endl;
         return false;
     }
     // check that right side of k3 is S
-    if(kbentries[ki3]->get_second() != si) {
+    if(kb_second[ki3] != si) {
         std::cerr << "Error when applying rule D7: the right side of subset knowledge #" << ki3
                   << " is not set expression #" << si << "." << std::endl;
         return false;
     }
 
-    add_kbentry(std::unique_ptr<KBEntry>(new KBEntryDead(fi)), newki);
+    add_kbentry(KBType::DEAD, fi, INDEXNONE, newki);
     return true;
 }
 
@@ -567,81 +868,77 @@ bool ProofChecker::check_rule_D7(KnowledgeIndex newki, FormulaIndex fi,
 // k2 (S' is dead) and k3  (S_not \cap S_G(\Pi) is dead)
 bool ProofChecker::check_rule_D8(KnowledgeIndex newki, FormulaIndex fi,
                                KnowledgeIndex ki1, KnowledgeIndex ki2, KnowledgeIndex ki3) {
-    assert(kbentries[ki1] != nullptr && kbentries[ki2] != nullptr && kbentries[ki3] != nullptr);
+    assert(kb_types[ki1] != KBType::NONE && kb_types[ki2] != KBType::NONE && kb_types[ki3] != KBType::NONE);
 
     // check if fi corresponds to s_not
-    SetFormulaNegation *s_not = dynamic_cast<SetFormulaNegation *>(formulas[fi].fpointer.get());
-    if(!s_not) {
+    FormulaIndex s_not = fi;
+    if(formula_types[s_not] != SetFormulaType::NEGATION) {
         std::cerr << "Error when applying rule D8: set expression #" << fi
                   << " is not a negation." << std::endl;
         return false;
     }
-    FormulaIndex si = s_not->get_subformula_index();
+    FormulaIndex si = formula_first[s_not];
 
     // check if k1 says that [A]S \subseteq S \cup S'
-    if(kbentries[ki1]->get_kbentry_type() != KBType::SUBSET) {
+    if(kb_types[ki1] != KBType::SUBSET) {
         std::cerr << "Error when applying rule D8: knowledge #" << ki1
                  << " is not of type SUBSET." << std::endl;
         return false;
     }
     // check if the left side of k1 is [A]S
-    SetFormulaRegression *s_reg =
-            dynamic_cast<SetFormulaRegression *>(formulas[kbentries[ki1]->get_first()].fpointer.get());
-    if ((!s_reg) || (s_reg->get_subformula_index() != si)) {
+    FormulaIndex s_reg = kb_first[ki1];
+    if ((formula_types[s_reg] != SetFormulaType::REGRESSION) || (formula_first[s_reg] != si)) {
         std::cerr << "Error when applying rule D8: the left side of subset knowledge #" << ki1
                   << " is not the regression of set expression #" << si << "." << std::endl;
         return false;
     }
-    if(!actionsets[s_reg->get_actionset_index()].get()->is_constantall()) {
+    if(!actionsets[formula_second[s_reg]].get()->is_constantall()) {
         std::cerr << "Error when applying rule D8: "
                      "the regression does not speak about all actions" << std::endl;
         return false;
     }
     // check f the right side of k1 is S \cup S'
-    SetFormulaUnion *s_cup_sp =
-            dynamic_cast<SetFormulaUnion *>(formulas[kbentries[ki1]->get_second()].fpointer.get());
-    if((!s_cup_sp) || (s_cup_sp->get_left_index() != si)) {
+    FormulaIndex s_cup_sp = kb_second[ki1];
+    if((formula_types[s_cup_sp] != SetFormulaType::UNION) || (formula_first[s_cup_sp] != si)) {
         std::cerr << "Error when applying rule D8: the right side of subset knowledge #" << ki1
                   << " is not a union of set expression #" << si
                   << " and another set expression." << std::endl;
         return false;
     }
 
-    FormulaIndex spi = s_cup_sp->get_right_index();
+    FormulaIndex spi = formula_second[s_cup_sp];
 
     // check if k2 says that S' is dead
-    if ((kbentries[ki2]->get_kbentry_type() != KBType::DEAD) ||
-       (kbentries[ki2]->get_first() != spi)) {
+    if ((kb_types[ki2] != KBType::DEAD) ||
+       (kb_first[ki2] != spi)) {
         std::cerr << "Error when applying rule D8: knowledge #" << ki2
                   << " does not state that set expression #" << spi << " is dead." << std::endl;
         return false;
     }
 
     // check if k3 says that S_not \cap S_G(\Pi) is dead
-    if (kbentries[ki3]->get_kbentry_type() != KBType::DEAD) {
+    if (kb_types[ki3] != KBType::DEAD) {
         std::cerr << "Error when applying rule D8: knowledge #" << ki3
                  << " is not of type DEAD." << std::endl;
         return false;
     }
-    SetFormulaIntersection *s_not_and_goal =
-            dynamic_cast<SetFormulaIntersection *>(formulas[kbentries[ki3]->get_first()].fpointer.get());
+    FormulaIndex s_not_and_goal = kb_first[ki3];
     // check if left side of s_not_and goal is S_not
-    if ((!s_not_and_goal) || (s_not_and_goal->get_left_index() != fi)) {
+    if ((formula_types[s_not_and_goal] != SetFormulaType::INTERSECTION) || (formula_first[s_not_and_goal] != fi)) {
         std::cerr << "Error when applying rule D8: the set expression declared dead in knowledge #"
                   << ki3 << " is not an intersection with set expression #" << fi
                   << " on the left side." << std::endl;
         return false;
     }
-    SetFormulaConstant *goal =
-            dynamic_cast<SetFormulaConstant *>(formulas[s_not_and_goal->get_right_index()].fpointer.get());
-    if((!goal) || (goal->get_constant_type() != ConstantType::GOAL)) {
+    FormulaIndex goal = formula_second[s_not_and_goal];
+    if(!is_constant(goal, ConstantType::GOAL)) {
         std::cerr << "Error when applying rule D8: the set expression declared dead in knowledge #"
                   << ki3 << " is not an intersection with the constant goal set on the right side."
                   << std::endl;
         return false;
     }
 
-    add_kbentry(std::unique_ptr<KBEntry>(new KBEntryDead(fi)), newki);
+    add_kbentry(KBType::DEAD, fi, INDEXNONE, newki);
     return true;
 }
 
@@ -650,71 +947,67 @@ bool ProofChecker::check_rule_D8(KnowledgeIndex newki, FormulaIndex fi,
 // k2 (S' is dead) and k3 ({I} \subseteq S_not)
 bool ProofChecker::check_rule_D9(KnowledgeIndex newki, FormulaIndex fi,
                                KnowledgeIndex ki1, KnowledgeIndex ki2, KnowledgeIndex ki3) {
-    assert(kbentries[ki1] != nullptr && kbentries[ki2] != nullptr && kbentries[ki3] != nullptr);
+    assert(kb_types[ki1] != KBType::NONE && kb_types[ki2] != KBType::NONE && kb_types[ki3] != KBType::NONE);
 
     // check if k1 says that [A]S \subseteq S \cup S'
-    if(kbentries[ki1]->get_kbentry_type() != KBType::SUBSET) {
+    if(kb_types[ki1] != KBType::SUBSET) {
         std::cerr << "Error when applying rule D9: knowledge #" << ki1
                  << " is not of type SUBSET." << std::endl;
         return false;
     }
     // check if the left side of k1 is [A]S
-    SetFormulaRegression *s_reg =
-            dynamic_cast<SetFormulaRegression *>(formulas[kbentries[ki1]->get_first()].fpointer.get());
-    if ((!s_reg) || (s_reg->get_subformula_index() != fi)) {
+    FormulaIndex s_reg = kb_first[ki1];
+    if ((formula_types[s_reg] != SetFormulaType::REGRESSION) || (formula_first[s_reg] != fi)) {
         std::cerr << "Error when applying rule D9: the left side of subset knowledge #" << ki1
                   << " is not the regression of set expression #" << fi << "." << std::endl;
         return false;
     }
-    if(!actionsets[s_reg->get_actionset_index()].get()->is_constantall()) {
+    if(!actionsets[formula_second[s_reg]].get()->is_constantall()) {
         std::cerr << "Error when applying rule D9: "
                      "the regression does not speak about all actions" << std::endl;
         return false;
     }
     // check f the right side of k1 is S \cup S'
-    SetFormulaUnion *s_cup_sp =
-            dynamic_cast<SetFormulaUnion *>(formulas[kbentries[ki1]->get_second()].fpointer.get());
-    if((!s_cup_sp) || (s_cup_sp->get_left_index() != fi)) {
+    FormulaIndex s_cup_sp = kb_second[ki1];
+    if((formula_types[s_cup_sp] != SetFormulaType::UNION) || (formula_first[s_cup_sp] != fi)) {
         std::cerr << "Error when applying rule D9: the right side of subset knowledge #" << ki1
                   << " is not a union of set expression #" << fi
                   << " and another set expression." << std::endl;
         return false;
     }
 
-    FormulaIndex spi = s_cup_sp->get_right_index();
+    FormulaIndex spi = formula_second[s_cup_sp];
 
     // check if k2 says that S' is dead
-    if ((kbentries[ki2]->get_kbentry_type() != KBType::DEAD) ||
-       (kbentries[ki2]->get_first() != spi)) {
+    if ((kb_types[ki2] != KBType::DEAD) ||
+       (kb_first[ki2] != spi)) {
         std::cerr << "Error when applying rule D9: knowledge #" << ki2
                   << " does not state that set expression #" << spi << " is dead." << std::endl;
         return false;
     }
 
     // check if k3 says that {I} \subseteq S_not
-    if (kbentries[ki3]->get_kbentry_type() != KBType::SUBSET) {
+    if (kb_types[ki3] != KBType::SUBSET) {
         std::cerr << "Error when applying rule D9: knowledge #" << ki3
                  << " is not of type SUBSET." << std::endl;
         return false;
     }
     // check that left side of k3 is {I}
-    SetFormulaConstant *init =
-            dynamic_cast<SetFormulaConstant *>(formulas[kbentries[ki3]->get_first()].fpointer.get());
-    if((!init) || (init->get_constant_type() != ConstantType::INIT)) {
+    FormulaIndex init = kb_first[ki3];
+    if(!is_constant(init, ConstantType::INIT)) {
         std::cerr << "Error when applying rule D9: the left side of subset knowledge #" << ki3
                   << " is not the constant initial set." << std::endl;
         return false;
     }
     // check that right side of k3 is S_not
-    SetFormulaNegation *s_not =
-            dynamic_cast<SetFormulaNegation *>(formulas[kbentries[ki3]->get_second()].fpointer.get());
-    if((!s_not) || s_not->get_subformula_index() != fi) {
+    FormulaIndex s_not = kb_second[ki3];
+    if((formula_types[s_not] != SetFormulaType::NEGATION) || formula_first[s_not] != fi) {
         std::cerr << "Error when applying rule D9: the right side of subset knowledge #" << ki3
                   << " is not the negation of set expression #" << fi << "." << std::endl;
         return false;
     }
 
-    add_kbentry(std::unique_ptr<KBEntry>(new KBEntryDead(fi)), newki);
+    add_kbentry(KBType::DEAD, fi, INDEXNONE, newki);
     return true;
 }
 
@@ -722,49 +1015,46 @@ bool ProofChecker::check_rule_D9(KnowledgeIndex newki, FormulaIndex fi,
 // KBEntry newki says that S'_not[A] \subseteq S_not based on k ([A]S \subseteq S')
 bool ProofChecker::check_rule_D10(KnowledgeIndex newki, FormulaIndex fi1, FormulaIndex fi2,
                                 KnowledgeIndex ki) {
-    assert(kbentries[ki] != nullptr);
+    assert(kb_types[ki] != KBType::NONE);
 
     // check that f1 represents S'_not[A] and f2 S_not
-    SetFormulaProgression *sp_not_prog =
-            dynamic_cast<SetFormulaProgression *>(formulas[fi1].fpointer.get());
-    if(!sp_not_prog) {
+    FormulaIndex sp_not_prog = fi1;
+    if(formula_types[sp_not_prog] != SetFormulaType::PROGRESSION) {
         std::cerr << "Error when applying rule D10: set expression #" << fi1
                   << " is not a progression." << std::endl;
         return false;
     }
-    SetFormulaNegation *sp_not =
-            dynamic_cast<SetFormulaNegation *>(formulas[sp_not_prog->get_subformula_index()].fpointer.get());
-    if(!sp_not) {
+    FormulaIndex sp_not = formula_first[sp_not_prog];
+    if(formula_types[sp_not] != SetFormulaType::NEGATION) {
         std::cerr << "Error when applying rule D10: set expression #" << fi1
                   << " is not the progression of a negation." << std::endl;
         return false;
     }
-    SetFormulaNegation *s_not =
-            dynamic_cast<SetFormulaNegation *>(formulas[fi2].fpointer.get());
-    if(!s_not) {
+    FormulaIndex s_not = fi2;
+    if(formula_types[s_not] != SetFormulaType::NEGATION) {
         std::cerr << "Error when applying rule D10: set expression #" << fi2
                   << " is not a negation." << std::endl;
         return false;
     }
 
-    FormulaIndex si = s_not->get_subformula_index();
-    FormulaIndex spi = sp_not->get_subformula_index();
+    FormulaIndex si = formula_first[s_not];
+    FormulaIndex spi = formula_first[sp_not];
 
     // check if k says that [A]S \subseteq S'
-    if(kbentries[ki]->get_kbentry_type() != KBType::SUBSET) {
+    if(kb_types[ki] != KBType::SUBSET) {
         std::cerr << "Error when applying rule D10: knwoledge #" << ki
                   << " is not of type SUBSET." << std::endl;
         return false;
     }
-    SetFormulaRegression *s_reg =
-            dynamic_cast<SetFormulaRegression *>(formulas[kbentries[ki]->get_first()].fpointer.get());
-    if(!s_reg || s_reg->get_subformula_index() != si || kbentries[ki]->get_second() != spi) {
+    FormulaIndex s_reg = kb_first[ki];
+    if(formula_types[s_reg] != SetFormulaType::REGRESSION || formula_first[s_reg] != si
+            || kb_second[ki] != spi) {
         std::cerr << "Error when applying rule D10: knowledge #" << ki
                   << " does not state that the regression of set expression #" << si
                   << " is a subset of set expression #" << spi << "." << std::endl;
         return false;
     }
-    add_kbentry(std::unique_ptr<KBEntry>(new KBEntrySubset(fi1, fi2)), newki);
+    add_kbentry(KBType::SUBSET, fi1, fi2, newki);
     return true;
 }
 
@@ -772,69 +1062,70 @@ bool ProofChecker::check_rule_D10(KnowledgeIndex newki, FormulaIndex fi1, Formul
 // KBEntry newki says that [A]S'_not \subseteq S_not based on k (S[A] \subseteq S')
 bool ProofChecker::check_rule_D11(KnowledgeIndex newki, FormulaIndex fi1, FormulaIndex fi2,
                                 KnowledgeIndex ki) {
-    assert(kbentries[ki] != nullptr);
+    assert(kb_types[ki] != KBType::NONE);
 
     //check that f1 represents [A]S'_not and f_2 S_not
-    SetFormulaRegression *sp_not_reg =
-            dynamic_cast<SetFormulaRegression *>(formulas[fi1].fpointer.get());
-    if(!sp_not_reg) {
+    FormulaIndex sp_not_reg = fi1;
+    if(formula_types[sp_not_reg] != SetFormulaType::REGRESSION) {
         std::cerr << "Error when applying rule D11: set expression #" << fi1
                   << " is not a regression." << std::endl;
         return false;
     }
-    SetFormulaNegation *sp_not =
-            dynamic_cast<SetFormulaNegation *>(formulas[sp_not_reg->get_subformula_index()].fpointer.get());
-    if(!sp_not) {
+    FormulaIndex sp_not = formula_first[sp_not_reg];
+    if(formula_types[sp_not] != SetFormulaType::NEGATION) {
         std::cerr << "Error when applying rule D11: set expression #" << fi1
                   << " is not the regression of a negation." << std::endl;
         return false;
     }
-    SetFormulaNegation *s_not =
-            dynamic_cast<SetFormulaNegation *>(formulas[fi2].fpointer.get());
-    if(!s_not) {
+    FormulaIndex s_not = fi2;
+    if(formula_types[s_not] != SetFormulaType::NEGATION) {
         std::cerr << "Error when applying rule D11: set expression #" << fi2
                   << " is not a negation." << std::endl;
         return false;
     }
 
-    FormulaIndex si = s_not->get_subformula_index();
-    FormulaIndex spi = sp_not->get_subformula_index();
+    FormulaIndex si = formula_first[s_not];
+    FormulaIndex spi = formula_first[sp_not];
 
     // check if k says that S[A] \subseteq S'
-    if(kbentries[ki]->get_kbentry_type() != KBType::SUBSET) {
+    if(kb_types[ki] != KBType::SUBSET) {
         std::cerr << "Error when applying rule D11: knwoledge #" << ki
                   << " is not of type SUBSET." << std::endl;
         return false;
     }
-    SetFormulaProgression *s_prog =
-            dynamic_cast<SetFormulaProgression *>(formulas[kbentries[ki]->get_first()].fpointer.get());
-    if(!s_prog || s_prog->get_subformula_index() != si || kbentries[ki]->get_second() != spi) {
+    FormulaIndex s_prog = kb_first[ki];
+    if(formula_types[s_prog] != SetFormulaType::PROGRESSION || formula_first[s_prog] != si
+            || kb_second[ki] != spi) {
         std::cerr << "Error when applying rule D11: knowledge #" << ki
                   << " does not state that the progression of set expression #" << si
                   << " is a subset of set expression #" << spi << "." << std::endl;
         return false;
     }
-    add_kbentry(std::unique_ptr<KBEntry>(new KBEntrySubset(fi1, fi2)), newki);
+    add_kbentry(KBType::SUBSET, fi1, fi2, newki);
     return true;
 }
 
 
 // check if \bigcap_{L \in \mathcal L} L \subseteq \bigcup_{L' \in \mathcal L'} L'
 bool ProofChecker::check_statement_B1(KnowledgeIndex newki, FormulaIndex fi1, FormulaIndex fi2) {
+    if(reuse_verified_subset(1, newki, fi1, fi2)) {
+        return true;
+    }
     bool ret = false;
+    bool deferred = false;
 
     try {
         std::vector<SetFormula *> left;
         std::vector<SetFormula *> right;
 
-        SetFormula *reference_formula = gather_sets_intersection(formulas[fi1].fpointer.get(), left, right);
+        SetFormula *reference_formula = gather_sets_intersection(fi1, left, right);
         if(!reference_formula) {
             std::string msg = "Error when checking statement B1: set expression #"
                     + std::to_string(fi1)
                     + " is not a intersection of literals of the same type.";
             throw std::runtime_error(msg);
         }
-        SetFormula *tmp = gather_sets_union(formulas[fi2].fpointer.get(), right, left);
+        SetFormula *tmp = gather_sets_union(fi2, right, left);
         if (!tmp) {
             std::string msg = "Error when checking statement B1: set expression #"
                     + std::to_string(fi2)
@@ -844,19 +1135,24 @@ bool ProofChecker::check_statement_B1(KnowledgeIndex newki, FormulaIndex fi1, Fo
         reference_formula =
                 update_reference_and_check_consistency(reference_formula, tmp, "B1");
 
-        if (!reference_formula->is_subset(left, right)) {
+        std::function<bool()> check = [=]() mutable {
+            return reference_formula->is_subset(left, right);
+        };
+        deferred = defer_check("B1", newki, fi1, fi2, {reference_formula}, check);
+        if (!deferred && !check()) {
             std::string msg = "Error when checking statement B1: set expression #"
                     + std::to_string(fi1) + " is not a subset of set expression #"
                     + std::to_string(fi2) + ".";
             throw std::runtime_error(msg);
         }
 
-        add_kbentry(std::unique_ptr<KBEntry>(new KBEntrySubset(fi1,fi2)), newki);
+        mark_verified_subset(1, fi1, fi2);
+        add_kbentry(KBType::SUBSET, fi1, fi2, newki);
         ret = true;
     } catch(std::runtime_error e) {
         std::cerr << e.what() << std::endl;
     }
-    if (g_discard_formulas) {
+    if (g_discard_formulas && !deferred) {
         remove_formulas_if_obsolete({fi1,fi2}, newki);
     }
     return ret;
@@ -864,39 +1160,41 @@ bool ProofChecker::check_statement_B1(KnowledgeIndex newki, FormulaIndex fi1, Fo
 
 // check if (\bigcap_{X \in \mathcal X} X)[A] \land \bigcap_{L \in \mathcal L} L \subseteq \bigcup_{L' \in \mathcal L'} L'
 bool ProofChecker::check_statement_B2(KnowledgeIndex newki, FormulaIndex fi1, FormulaIndex fi2) {
+    if(reuse_verified_subset(2, newki, fi1, fi2)) {
+        return true;
+    }
     bool ret = false;
+    bool deferred = false;
 
     try {
         std::vector<SetFormula *> prog;
         std::vector<SetFormula *> left;
         std::vector<SetFormula *> right;
-        std::unordered_set<int> actions;
-        SetFormula *prog_formula = nullptr;
-        SetFormula *left_formula = nullptr;
+        // owned by the action set, which is never discarded
+        const std::unordered_set<int> *actions = nullptr;
+        FormulaIndex prog_formula = INDEXNONE;
+        FormulaIndex left_formula = INDEXNONE;
 
-        SetFormulaType left_type = formulas[fi1].fpointer.get()->get_formula_type();
+        SetFormulaType left_type = formula_types[fi1];
         /*
          * We expect the left side to either be a progression or an intersection with
          * a progression on the left side
          */
         if (left_type == SetFormulaType::INTERSECTION) {
-            SetFormulaIntersection *intersection =
-                    dynamic_cast<SetFormulaIntersection *>(formulas[fi1].fpointer.get());
-            prog_formula = formulas[intersection->get_left_index()].fpointer.get();
-            left_formula = formulas[intersection->get_right_index()].fpointer.get();
+            prog_formula = formula_first[fi1];
+            left_formula = formula_second[fi1];
         } else if (left_type == SetFormulaType::PROGRESSION) {
-            prog_formula = formulas[fi1].fpointer.get();
+            prog_formula = fi1;
         }
         // here, prog_formula should be S[A]
-        if (!prog_formula || prog_formula->get_formula_type() != SetFormulaType::PROGRESSION) {
+        if (prog_formula == INDEXNONE || formula_types[prog_formula] != SetFormulaType::PROGRESSION) {
             std::string msg = "Error when checking statement B2: set expression #"
                     + std::to_string(fi1)
                     + " is not a progresison or intersection with progression on the left.";
             throw std::runtime_error(msg);
         }
-        SetFormulaProgression *progression = dynamic_cast<SetFormulaProgression *>(prog_formula);
-        actionsets[progression->get_actionset_index()]->get_actions(actions);
-        prog_formula = formulas[progression->get_subformula_index()].fpointer.get();
+        actions = &actionsets[formula_second[prog_formula]]->get_actions();
+        prog_formula = formula_first[prog_formula];
         // here, prog_formula is S (without [A])
 
         /*
@@ -914,7 +1212,7 @@ bool ProofChecker::check_statement_B2(KnowledgeIndex newki, FormulaIndex fi1, Fo
         }
 
         // left_formula is empty if the left side contains only a progression
-        if(left_formula) {
+        if(left_formula != INDEXNONE) {
             SetFormula *tmp = gather_sets_intersection(left_formula, left, right);
             if(!tmp) {
                 std::string msg = "Error when checking statement B2: "
@@ -926,7 +1224,7 @@ bool ProofChecker::check_statement_B2(KnowledgeIndex newki, FormulaIndex fi1, Fo
             reference_formula =
                     update_reference_and_check_consistency(reference_formula, tmp, "B2");
         }
-        SetFormula *tmp = gather_sets_union(formulas[fi2].fpointer.get(), right, left);
+        SetFormula *tmp = gather_sets_union(fi2, right, left);
         if(!tmp) {
             std::string msg = "Error when checking statement B2: set expression #"
                     + std::to_string(fi2)
@@ -936,21 +1234,25 @@ bool ProofChecker::check_statement_B2(KnowledgeIndex newki, FormulaIndex fi1, Fo
         reference_formula =
                 update_reference_and_check_consistency(reference_formula, tmp, "B2");
 
-        if(!reference_formula->is_subset_with_progression(
-                    left, right, prog, actions)) {
+        std::function<bool()> check = [=]() mutable {
+            return reference_formula->is_subset_with_progression(left, right, prog, *actions);
+        };
+        deferred = defer_check("B2", newki, fi1, fi2, {reference_formula}, check);
+        if(!deferred && !check()) {
             std::string msg = "Error when checking statement B2: set expression #"
                     + std::to_string(fi1) + " is not a subset of set expression #"
                     + std::to_string(fi2) + ".";
             throw std::runtime_error(msg);
         }
-        add_kbentry(std::unique_ptr<KBEntry>(new KBEntrySubset(fi1,fi2)), newki);
+        mark_verified_subset(2, fi1, fi2);
+        add_kbentry(KBType::SUBSET, fi1, fi2, newki);
         ret = true;
 
     } catch(std::runtime_error e) {
         std::cerr << e.what() << std::endl;
     }
 
-    if (g_discard_formulas) {
+    if (g_discard_formulas && !deferred) {
         remove_formulas_if_obsolete({fi1,fi2}, newki);
     }
     return ret;
@@ -958,39 +1260,41 @@ bool ProofChecker::check_statement_B2(KnowledgeIndex newki, FormulaIndex fi1, Fo
 
 // check if [A](\bigcap_{X \in \mathcal X} X) \land \bigcap_{L \in \mathcal L} L \subseteq \bigcup_{L' \in \mathcal L'} L'
 bool ProofChecker::check_statement_B3(KnowledgeIndex newki, FormulaIndex fi1, FormulaIndex fi2) {
+    if(reuse_verified_subset(3, newki, fi1, fi2)) {
+        return true;
+    }
     bool ret = false;
+    bool deferred = false;
 
     try {
         std::vector<SetFormula *> reg;
         std::vector<SetFormula *> left;
         std::vector<SetFormula *> right;
-        std::unordered_set<int> actions;
-        SetFormula *reg_formula = nullptr;
-        SetFormula *left_formula = nullptr;
+        // owned by the action set, which is never discarded
+        const std::unordered_set<int> *actions = nullptr;
+        FormulaIndex reg_formula = INDEXNONE;
+        FormulaIndex left_formula = INDEXNONE;
 
-        SetFormulaType left_type = formulas[fi1].fpointer.get()->get_formula_type();
+        SetFormulaType left_type = formula_types[fi1];
         /*
          * We expect the left side to either be a regression or an intersection with
          * a regression on the left side
          */
         if (left_type == SetFormulaType::INTERSECTION) {
-            SetFormulaIntersection *intersection =
-                    dynamic_cast<SetFormulaIntersection *>(formulas[fi1].fpointer.get());
-            reg_formula = formulas[intersection->get_left_index()].fpointer.get();
-            left_formula = formulas[intersection->get_right_index()].fpointer.get();
+            reg_formula = formula_first[fi1];
+            left_formula = formula_second[fi1];
         } else if (left_type == SetFormulaType::REGRESSION) {
-            reg_formula = formulas[fi1].fpointer.get();
+            reg_formula = fi1;
         }
         // here, reg_formula should be [A]S
-        if (!reg_formula || reg_formula->get_formula_type() != SetFormulaType::REGRESSION) {
+        if (reg_formula == INDEXNONE || formula_types[reg_formula] != SetFormulaType::REGRESSION) {
             std::string msg = "Error when checking statement B3: set expression #"
                     + std::to_string(fi1)
                     + " is not a regresison or intersection with regression on the left.";
             throw std::runtime_error(msg);
         }
-        SetFormulaRegression *regression = dynamic_cast<SetFormulaRegression *>(reg_formula);
-        actionsets[regression->get_actionset_index()]->get_actions(actions);
-        reg_formula = formulas[regression->get_subformula_index()].fpointer.get();
+        actions = &actionsets[formula_second[reg_formula]]->get_actions();
+        reg_formula = formula_first[reg_formula];
         // here, reg_formula is S (without [A])
 
         /*
@@ -1008,7 +1312,7 @@ bool ProofChecker::check_statement_B3(KnowledgeIndex newki, FormulaIndex fi1, Fo
         }
 
         // left_formula is empty if the left side contains only a progression
-        if(left_formula) {
+        if(left_formula != INDEXNONE) {
             SetFormula *tmp = gather_sets_intersection(left_formula, left, right);
             if(!tmp) {
                 std::string msg = "Error when checking statement B3: "
@@ -1020,7 +1324,7 @@ bool ProofChecker::check_statement_B3(KnowledgeIndex newki, FormulaIndex fi1, Fo
             reference_formula =
                     update_reference_and_check_consistency(reference_formula, tmp, "B2");
         }
-        SetFormula *tmp = gather_sets_union(formulas[fi2].fpointer.get(), right, left);
+        SetFormula *tmp = gather_sets_union(fi2, right, left);
         if(!tmp) {
             std::string msg = "Error when checking statement B3: set expression #"
                     + std::to_string(fi2)
@@ -1030,21 +1334,25 @@ bool ProofChecker::check_statement_B3(KnowledgeIndex newki, FormulaIndex fi1, Fo
         reference_formula =
                 update_reference_and_check_consistency(reference_formula, tmp, "B2");
 
-        if(!reference_formula->is_subset_with_regression(
-                    left, right, reg, actions)) {
+        std::function<bool()> check = [=]() mutable {
+            return reference_formula->is_subset_with_regression(left, right, reg, *actions);
+        };
+        deferred = defer_check("B3", newki, fi1, fi2, {reference_formula}, check);
+        if(!deferred && !check()) {
             std::string msg = "Error when checking statement B3: set expression #"
                     + std::to_string(fi1) + " is not a subset of set expression #"
                     + std::to_string(fi2) + ".";
             throw std::runtime_error(msg);
         }
-        add_kbentry(std::unique_ptr<KBEntry>(new KBEntrySubset(fi1,fi2)), newki);
+        mark_verified_subset(3, fi1, fi2);
+        add_kbentry(KBType::SUBSET, fi1, fi2, newki);
         ret = true;
 
     } catch(std::runtime_error e) {
         std::cerr << e.what() << std::endl;
     }
 
-    if (g_discard_formulas) {
+    if (g_discard_formulas && !deferred) {
         remove_formulas_if_obsolete({fi1,fi2}, newki);
     }
     return ret;
@@ -1053,20 +1361,23 @@ bool ProofChecker::check_statement_B3(KnowledgeIndex newki, FormulaIndex fi1, Fo
 
 // check if L \subseteq L', where L and L' might be represented by different formalisms
 bool ProofChecker::check_statement_B4(KnowledgeIndex newki, FormulaIndex fi1, FormulaIndex fi2) {
+    if(reuse_verified_subset(4, newki, fi1, fi2)) {
+        return true;
+    }
     bool ret = true;
+    bool deferred = false;
 
     try {
-        SetFormula *left = formulas[fi1].fpointer.get();
+        FormulaIndex lefti = fi1;
         bool left_positive = true;
-        SetFormula *right = formulas[fi2].fpointer.get();
+        FormulaIndex righti = fi2;
         bool right_positive = true;
 
-        if(left->get_formula_type() == SetFormulaType::NEGATION) {
-            SetFormulaNegation *f1neg = dynamic_cast<SetFormulaNegation *>(left);
-            left = formulas[f1neg->get_subformula_index()].fpointer.get();
+        if(formula_types[lefti] == SetFormulaType::NEGATION) {
+            lefti = formula_first[lefti];
             left_positive = false;
         }
-        switch (left->get_formula_type()) {
+        switch (formula_types[lefti]) {
         case SetFormulaType::NEGATION:
         case SetFormulaType::INTERSECTION:
         case SetFormulaType::UNION:
@@ -1078,12 +1389,11 @@ bool ProofChecker::check_statement_B4(KnowledgeIndex newki, FormulaIndex fi1, Fo
             break;
         }
 
-        if(right->get_formula_type() == SetFormulaType::NEGATION) {
-            SetFormulaNegation *f2neg = dynamic_cast<SetFormulaNegation *>(right);
-            right = formulas[f2neg->get_subformula_index()].fpointer.get();
+        if(formula_types[righti] == SetFormulaType::NEGATION) {
+            righti = formula_first[righti];
             right_positive = false;
         }
-        switch (right->get_formula_type()) {
+        switch (formula_types[righti]) {
         case SetFormulaType::NEGATION:
         case SetFormulaType::INTERSECTION:
         case SetFormulaType::UNION:
@@ -1095,20 +1405,33 @@ bool ProofChecker::check_statement_B4(KnowledgeIndex newki, FormulaIndex fi1, Fo
             break;
         }
 
-        if(!left->is_subset_of(right, left_positive, right_positive)) {
+        SetFormula *left = get_basic_formula(lefti);
+        SetFormula *right = get_basic_formula(righti);
+        // a stale last_occ trailer might have discarded a set too early
+        if(!left || !right) {
+            std::string msg = "Error when checking statement B4: set expression #"
+                    + std::to_string(left ? fi2 : fi1) + " is not available.";
+            throw std::runtime_error(msg);
+        }
+        std::function<bool()> check = [=]() {
+            return left->is_subset_of(right, left_positive, right_positive);
+        };
+        deferred = defer_check("B4", newki, fi1, fi2, {left, right}, check);
+        if(!deferred && !check()) {
             std::string msg = "Error when checking statement B4: set expression #"
                     + std::to_string(fi1) + " is not a subset of set expression #"
                     + std::to_string(fi2) + ".";
             throw std::runtime_error(msg);
         }
 
-        add_kbentry(std::unique_ptr<KBEntry>(new KBEntrySubset(fi1,fi2)), newki);
+        mark_verified_subset(4, fi1, fi2);
+        add_kbentry(KBType::SUBSET, fi1, fi2, newki);
     } catch (std::runtime_error e) {
         std::cerr << e.what();
         ret = false;
     }
 
-    if (g_discard_formulas) {
+    if (g_discard_formulas && !deferred) {
         remove_formulas_if_obsolete({fi1,fi2}, newki);
     }
     return ret;
@@ -1124,12 +1447,13 @@ bool ProofChecker::check_statement_B5(KnowledgeIndex newki,
                   << ai1 << " is not a subset of action set #" << ai2 << "." << std::endl;
         return false;
     } else {
-        add_kbentry(std::unique_ptr<KBEntry>(new KBEntryAction(ai1,ai2)), newki);
+        add_kbentry(KBType::ACTION, ai1, ai2, newki);
         return true;
     }
 }
 
 
 bool ProofChecker::is_unsolvability_proven() {
-    return unsolvability_proven;
+    collect_deferred_checks(0);
+    return unsolvability_proven && deferred_checks_valid;
 }
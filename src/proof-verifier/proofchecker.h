@@ -3,94 +3,149 @@
 
 #include "actionset.h"
 #include "setformula.h"
+#include "threadpool.h"
 
 #include <iostream>
 #include <deque>
+#include <functional>
+#include <future>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 typedef int KnowledgeIndex;
 
-enum class KBType {
+enum class KBType : unsigned char {
+    NONE,
     SUBSET,
     DEAD,
     ACTION,
     UNSOLVABLE
 };
 
-// TODO: virtual get_first() and get_second() methods are somewhat hacky
-// but it saves us dynamic casts
-class KBEntry {
-public:
-    static const FormulaIndex INDEXNONE = -1;
-    KBEntry();
-    virtual FormulaIndex get_first() = 0;
-    virtual FormulaIndex get_second() = 0;
-
-    virtual KBType get_kbentry_type() = 0;
-};
-
-class KBEntrySubset : public KBEntry {
-private:
-    FormulaIndex first;
-    FormulaIndex second;
-public:
-    KBEntrySubset(FormulaIndex first, FormulaIndex second)
-        : first(first), second(second) {}
-    virtual FormulaIndex get_first() { return first; }
-    virtual FormulaIndex get_second() { return second; }
-    virtual KBType get_kbentry_type() { return KBType::SUBSET; }
-};
-
-class KBEntryDead : public KBEntry {
-private:
-    FormulaIndex first;
-public:
-    KBEntryDead(FormulaIndex first) : first(first) {}
-    virtual FormulaIndex get_first() { return first; }
-    virtual FormulaIndex get_second() { return INDEXNONE; }
-    virtual KBType get_kbentry_type() { return KBType::DEAD; }
-};
-
-class KBEntryAction : public KBEntry {
-private:
-    ActionSetIndex first;
-    ActionSetIndex second;
-public:
-    KBEntryAction(FormulaIndex first, FormulaIndex second)
-        : first(first), second(second) {}
-    virtual FormulaIndex get_first() { return first; }
-    virtual FormulaIndex get_second() { return second; }
-    virtual KBType get_kbentry_type() { return KBType::ACTION; }
+/*
+ * Set expressions and action sets are hash-consed: each of them gets a
+ * canonical id, and two compound expressions get the same id if they have the
+ * same type and the same canonical children. Intersections and unions are
+ * normalized by ordering their children, and double negations are removed.
+ * Basic sets are only identified by their index, since comparing their content
+ * would require the same reasoning we want to avoid.
+ * The key consists of the type and up to two canonical ids (or -1).
+ */
+struct CanonicalKey {
+    int type;
+    int first;
+    int second;
+    bool operator==(const CanonicalKey &other) const {
+        return type == other.type && first == other.first && second == other.second;
+    }
 };
 
-class KBEntryUnsolvable : public KBEntry {
-public:
-    KBEntryUnsolvable() {}
-    virtual FormulaIndex get_first() { return INDEXNONE; }
-    virtual FormulaIndex get_second() { return INDEXNONE; }
-    virtual KBType get_kbentry_type() { return KBType::UNSOLVABLE; }
+struct CanonicalKeyHash {
+    size_t operator()(const CanonicalKey &key) const {
+        size_t hash = std::hash<int>()(key.type);
+        hash ^= std::hash<int>()(key.first) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        hash ^= std::hash<int>()(key.second) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        return hash;
+    }
 };
 
-struct FormulaEntry {
-    std::unique_ptr<SetFormula> fpointer;
-    // the last KnowledgeIndex where we need the actual set representation
-    KnowledgeIndex last_occ;
-    FormulaEntry(std::unique_ptr<SetFormula> fpointer, int last_occ)
-        : fpointer(std::move(fpointer)), last_occ(last_occ) {}
-    FormulaEntry()
-        : last_occ(-1) {}
+/*
+ * A subset check of statement B1-B4 that has been handed to a worker thread.
+ * The KBEntry it would create is already added to the knowledge base, since
+ * its content does not depend on the outcome of the check.
+ * basic_formulas holds the positions of all basic sets the check reads (see
+ * ProofChecker::pending_basic_uses).
+ */
+struct DeferredCheck {
+    KnowledgeIndex ki;
+    FormulaIndex fi1;
+    FormulaIndex fi2;
+    std::string stmt;
+    std::vector<int> basic_formulas;
+    std::future<bool> result;
 };
 
 class ProofChecker
 {
 private:
-    std::deque<FormulaEntry> formulas;
-    std::deque<std::unique_ptr<KBEntry>> kbentries;
+    /*
+     * Set expressions are stored in flat arrays indexed by FormulaIndex: a type
+     * tag and two operands. Compound expressions store the indices of their
+     * subexpressions (negation, intersection, union) or the subexpression and
+     * the action set (progression, regression). Basic and constant sets are held
+     * in basic_formulas; the first operand is their position there and for
+     * constants the second operand is the ConstantType.
+     * Undeclared indices are constants with both operands INDEXNONE.
+     */
+    std::vector<SetFormulaType> formula_types;
+    std::vector<int> formula_first;
+    std::vector<int> formula_second;
+    // the last KnowledgeIndex where we need the actual set representation
+    std::vector<KnowledgeIndex> formula_last_occ;
+    // stays valid after the basic set has been discarded
+    std::vector<int> formula_canonical_ids;
+    std::vector<std::unique_ptr<SetFormula>> basic_formulas;
+
+    // knowledge is stored the same way: a type tag and (up to) two indices
+    std::vector<KBType> kb_types;
+    std::vector<int> kb_first;
+    std::vector<int> kb_second;
     std::deque<std::unique_ptr<ActionSet>> actionsets;
+    std::deque<int> actionset_canonical_ids;
     bool unsolvability_proven;
 
-    void add_kbentry(std::unique_ptr<KBEntry> entry, KnowledgeIndex index);
+    // key types for action sets (set expressions use their SetFormulaType)
+    static const int ACTIONSET_ALL = -1;
+    static const int ACTIONSET_UNION = -2;
+    std::unordered_map<CanonicalKey, int, CanonicalKeyHash> canonical_ids;
+    // maps the canonical id of a negation to the one of its subformula
+    std::unordered_map<int, int> negated_canonical_ids;
+    int next_canonical_id;
+    /*
+     * B1-B4 statements that have already been verified (or handed to the
+     * worker pool), keyed on the statement and the canonical ids of both sides.
+     * Since the action sets of B2 and B3 are part of the canonical id of the
+     * progression/regression, repeating a statement on structurally equal
+     * expressions does not redo the check.
+     */
+    std::unordered_set<CanonicalKey, CanonicalKeyHash> verified_subsets;
+
+    std::unique_ptr<ThreadPool> pool;
+    std::deque<DeferredCheck> deferred_checks;
+    bool deferred_checks_valid;
+    /*
+     * The amount of pending deferred checks reading each basic set (by its
+     * position in basic_formulas). A basic set that becomes obsolete while
+     * it is still in use is only marked and discarded once the last of these
+     * checks has been collected.
+     */
+    std::unordered_map<int, int> pending_basic_uses;
+    std::unordered_set<int> obsolete_basic_formulas;
+
+    void resize_formulas(size_t size);
+    // the SetFormula of a basic or constant set
+    SetFormula *get_basic_formula(FormulaIndex fi);
+    bool is_constant(FormulaIndex fi, ConstantType type);
+    void add_kbentry(KBType type, int first, int second, KnowledgeIndex index);
     void remove_formulas_if_obsolete(std::vector<int> indices, int current_ki);
+    // the positions of the basic sets occurring in the set expression
+    void collect_basic_formulas(FormulaIndex fi, std::vector<int> &positions);
+    void discard_basic_formula(int position);
+
+    int get_canonical_id(const CanonicalKey &key);
+    int compute_canonical_id(FormulaIndex fi);
+    // if the statement has been verified before, adds the knowledge and returns true
+    bool reuse_verified_subset(int statement, KnowledgeIndex newki,
+                               FormulaIndex fi1, FormulaIndex fi2);
+    void mark_verified_subset(int statement, FormulaIndex fi1, FormulaIndex fi2);
+
+    // returns true if the check has been handed to the worker pool
+    bool defer_check(std::string stmt, KnowledgeIndex newki, FormulaIndex fi1, FormulaIndex fi2,
+                     std::vector<SetFormula *> involved, std::function<bool()> check);
+    // collects finished deferred checks; if max_pending is 0 it waits for all
+    void collect_deferred_checks(size_t max_pending);
 
     /*
      * The return formula serves as a reference which basic formula type is involved.
@@ -98,22 +153,43 @@ private:
      * If it is a constant formula, then all set variables involved are constant.
      * If it is a concrete type, then all set variables invovled are of this type or constant.
      */
-    SetFormula *gather_sets_intersection(SetFormula *f,
+    SetFormula *gather_sets_intersection(FormulaIndex fi,
                                  std::vector<SetFormula *>&positive,
                                  std::vector<SetFormula *>&negative);
-    SetFormula *gather_sets_union(SetFormula *f,
+    SetFormula *gather_sets_union(FormulaIndex fi,
                            std::vector<SetFormula *>&positive,
                            std::vector<SetFormula *>&negative);
     SetFormula *update_reference_and_check_consistency(SetFormula *reference_formula,
                                                        SetFormula *tmp, std::string stmt);
 public:
-    ProofChecker();
+    static const int INDEXNONE = -1;
+
+    // with threads > 1, B1-B4 are checked concurrently on that many worker threads
+    ProofChecker(int threads = 1);
 
+    // for basic and constant sets
     void add_formula(std::unique_ptr<SetFormula> formula, FormulaIndex index);
+    // second is INDEXNONE for negations and the action set for progressions/regressions
+    void add_compound_formula(SetFormulaType type, FormulaIndex first, int second,
+                              FormulaIndex index);
     // TODO one function for both types of actionsets would be nicer...
     void add_actionset(std::unique_ptr<ActionSet> actionset, ActionSetIndex index);
     void add_actionset_union(ActionSetIndex left, ActionSetIndex right, ActionSetIndex index);
     void first_pass(std::string certfile);
+    // alternative to first_pass if the last occurences are already known (binary proofs)
+    void set_last_occ(const std::vector<KnowledgeIndex> &last_occ);
+    /*
+      alternative to first_pass for textual proofs ending with the last_occ
+      trailer written by the planner; returns false if there is no trailer
+    */
+    bool read_last_occ_trailer(std::string certfile);
+
+    // used to validate the indices of binary proofs before passing them on
+    bool is_formula_declared(FormulaIndex fi) const;
+    bool is_actionset_declared(ActionSetIndex ai) const;
+    size_t get_actionset_amount() const;
+    // false for knowledge whose check was not successful
+    bool is_knowledge_derived(KnowledgeIndex ki) const;
 
     bool check_rule_D1(KnowledgeIndex newki, FormulaIndex emptyi);
     bool check_rule_D2(KnowledgeIndex newki, FormulaIndex fi,
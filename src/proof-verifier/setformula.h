@@ -3,9 +3,10 @@
 
 #include "task.h"
 
+#include <istream>
 #include <unordered_set>
 
-enum class SetFormulaType {
+enum class SetFormulaType : unsigned char {
     CONSTANT,
     BDD,
     HORN,
@@ -48,11 +49,11 @@ public:
     virtual bool is_subset_with_progression(std::vector<SetFormula *> &left,
                                             std::vector<SetFormula *> &right,
                                             std::vector<SetFormula *> &prog,
-                                            std::unordered_set<int> &actions) = 0;
+                                            const std::unordered_set<int> &actions) = 0;
     virtual bool is_subset_with_regression(std::vector<SetFormula *> &left,
                                            std::vector<SetFormula *> &right,
                                            std::vector<SetFormula *> &reg,
-                                           std::unordered_set<int> &actions) = 0;
+                                           const std::unordered_set<int> &actions) = 0;
 
     // Here the other Formula has a different type
     virtual bool is_subset_of(SetFormula *superset, bool left_positive, bool right_positive) = 0;
@@ -2,37 +2,50 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cerrno>
 #include <fstream>
 #include <iostream>
-#include "dddmp.h"
+#include <unistd.h>
+#include "bdddump.h"
 
 #include "global_funcs.h"
 #include "setformulahorn.h"
 #include "setformulaexplicit.h"
 
 std::unordered_map<std::vector<int>, BDDUtil, VectorHasher> BDDFile::utils;
-std::vector<int> BDDFile::compose;
+bool BDDFile::reordering = false;
+int BDDFile::varorder_report_fd = -1;
 
-BDDFile::BDDFile(Task *task, std::string filename) {
-    if (compose.empty()) {
-        /*
-         * The dumped BDDs only contain the original variables.
-         * Since we need also primed variables for checking
-         * statements B4 and B5 (pro/regression), we move the
-         * variables in such a way that a primed variable always
-         * occurs directly after its unprimed version
-         * (Example: BDD dump with vars "a b c": "a a' b b' c c'")
-         */
-        compose.resize(task->get_number_of_facts());
-        for(int i = 0; i < task->get_number_of_facts(); ++i) {
-            compose[i] = 2*i;
-        }
+void BDDFile::enable_reordering(Task *task) {
+    assert(utils.empty());
+    reordering = true;
+    for(int i = 0; i < task->get_number_of_facts(); ++i) {
+        manager.MakeTreeNode(2*i, 2, MTR_FIXED);
+    }
+    manager.AutodynEnable(CUDD_REORDER_GROUP_SIFT);
+}
+
+void BDDFile::set_varorder_report_fd(int fd) {
+    varorder_report_fd = fd;
+}
 
+void BDDFile::precompile_util(Task *task, std::vector<int> &varorder) {
+    auto it = utils.find(varorder);
+    if (it == utils.end()) {
+        it = utils.emplace(std::piecewise_construct,
+                      std::forward_as_tuple(varorder),
+                      std::forward_as_tuple(task,varorder)).first;
     }
-    // we need to read in the file as FILE* since dddmp uses this
-    fp = fopen(filename.c_str(), "r");
+    if (!it->second.transitions_built) {
+        it->second.build_transitions();
+    }
+}
+
+BDDFile::BDDFile(Task *task, std::string filename) {
+    FILE *fp = fopen(filename.c_str(), "r");
     if(!fp) {
         std::cerr << "could not open bdd file " << filename << std::endl;
+        exit_with(ExitCode::CRITICAL_ERROR);
     }
 
     // the first line contains the variable order, separated by space
@@ -52,14 +65,57 @@ BDDFile::BDDFile(Task *task, std::string filename) {
         varorder.push_back(n);
     }
     assert(varorder.size() == task->get_number_of_facts());
+
+    /*
+     * The dumped BDDs only contain the original variables.
+     * Since we need also primed variables for checking
+     * statements B4 and B5 (pro/regression), we move the
+     * variables in such a way that a primed variable always
+     * occurs directly after its unprimed version
+     * (Example: BDD dump with vars "a b c": "a a' b b' c c'")
+     * With reordering, the dump variable of fact i (at position varorder[i])
+     * is additionally moved to the common variable 2*i; the manager then
+     * takes care of finding a good order for all BDDs.
+     */
+    std::vector<int> identity(task->get_number_of_facts());
+    for(int i = 0; i < task->get_number_of_facts(); ++i) {
+        identity[i] = i;
+    }
+    if (reordering) {
+        compose = interleaved_compose(varorder);
+        varorder = identity;
+    } else {
+        compose = interleaved_compose(identity);
+    }
     auto it = utils.find(varorder);
     if (it == utils.end()) {
         it = utils.emplace(std::piecewise_construct,
                       std::forward_as_tuple(varorder),
                       std::forward_as_tuple(task,varorder)).first;
+        if (varorder_report_fd >= 0) {
+            std::vector<int> report;
+            report.reserve(varorder.size()+1);
+            report.push_back(varorder.size());
+            report.insert(report.end(), varorder.begin(), varorder.end());
+            const char *buf = reinterpret_cast<const char *>(report.data());
+            size_t left = report.size()*sizeof(int);
+            while (left > 0) {
+                ssize_t written = write(varorder_report_fd, buf, left);
+                if (written < 0 && errno == EINTR) {
+                    continue;
+                } else if (written <= 0) {
+                    // the report is only an optimization for later jobs
+                    break;
+                }
+                buf += written;
+                left -= written;
+            }
+        }
     }
     util = &(it->second);
 
+    // the remaining blocks are read ahead in the background
+    prefetcher.reset(new BDDPrefetcher(fp, filename));
 }
 
 DdNode *BDDFile::get_ddnode(int index) {
@@ -74,47 +130,27 @@ DdNode *BDDFile::get_ddnode(int index) {
     }
     while(!found) {
         std::vector<int> indices;
-        // next line contains indices
-        std::stringstream ss;
-        char c;
-        while((c = fgetc (fp)) != '\n') {
-            ss << c;
+        std::string dump;
+        bool binary;
+        if(!prefetcher->next_block(indices, dump, binary)) {
+            std::cerr << "BDD #" << index << " not found in bdd file" << std::endl;
+            exit_with(ExitCode::CRITICAL_ERROR);
         }
-        // read out the same line from the string stream int by int
-        // TODO: what happens if it cannot interpret the next word as int?
-        // TODO: can we do this more directly? Ie. get the ints while reading the first line.
-        int n;
-        while (ss >> n){
-            indices.push_back(n);
-        }
-        DdNode **tmp_array;
-        /* read in the BDDs into an array of DdNodes. The parameters are as follows:
-         *  - manager
-         *  - how to match roots: we want them to be matched by id
-         *  - root names: only needed when you want to match roots by name
-         *  - how to match variables: since we want to permute the BDDs in order to
-         *    allow primed variables in between the original one, we take COMPOSEIDS
-         *  - varnames: needed if you want to match vars according to names
-         *  - varmatchauxids: needed if you want to match vars according to auxidc
-         *  - varcomposeids: the variable permutation if you want to permute the BDDs
-         *  - mode: if the file was dumped in text or in binary mode
-         *  - filename: needed if you don't directly pass the FILE *
-         *  - FILE*
-         *  - Pointer to array where the DdNodes should be saved to
-         */
-        int nRoots = Dddmp_cuddBddArrayLoad(manager.getManager(),DDDMP_ROOT_MATCHLIST,NULL,
-            DDDMP_VAR_COMPOSEIDS,NULL,NULL,compose.data(),DDDMP_MODE_TEXT,NULL,fp,&tmp_array);
-
-        assert(indices.size() == nRoots);
-        for(int i = 0; i < nRoots; ++i) {
+        // dddmp reads from a FILE *, so we wrap the prefetched dump into one
+        FILE *fp = fmemopen(&dump[0], dump.size(), "r");
+        std::vector<DdNode *> roots = load_bdd_dump(manager.getManager(), fp,
+            binary ? static_cast<long>(dump.size()) : -1, compose);
+        fclose(fp);
+
+        assert(indices.size() == roots.size());
+        for(size_t i = 0; i < roots.size(); ++i) {
             if (indices[i] == index) {
                 found = true;
-                it = ddnodes.insert(std::make_pair(indices[i],tmp_array[i])).first;
+                it = ddnodes.insert(std::make_pair(indices[i],roots[i])).first;
             } else {
-                ddnodes.insert(std::make_pair(indices[i],tmp_array[i]));
+                ddnodes.insert(std::make_pair(indices[i],roots[i]));
             }
         }
-        // we do not need to free the memory for tmp_array, memcheck detected no leaks
     }
     DdNode *ret = it->second;
     //ddnodes.erase(it);
@@ -126,7 +162,7 @@ BDDUtil *BDDFile::get_util() {
 }
 
 BDDUtil::BDDUtil(Task *task, std::vector<int> &varorder)
-    : task(task), varorder(varorder) {
+    : task(task), varorder(varorder), transitions_built(false) {
 
     assert(varorder.size() == task->get_number_of_facts());
     other_varorder.resize(varorder.size(),-1);
@@ -139,7 +175,8 @@ BDDUtil::BDDUtil(Task *task, std::vector<int> &varorder)
     emptyformula = SetFormulaBDD( this, BDD(manager.bddZero()) );
 }
 
-BDDUtil::BDDUtil() {
+BDDUtil::BDDUtil()
+    : transitions_built(false) {
 
 }
 
@@ -153,27 +190,113 @@ BDD BDDUtil::build_bdd_from_cube(const Cube &cube) {
     return BDD(manager, Cudd_CubeArrayToBdd(manager.getManager(), &local_cube[0]));
 }
 
-void BDDUtil::build_actionformulas() {
-    actionformulas.reserve(task->get_number_of_actions());
+void BDDUtil::build_transitions() {
+    transitions = BDDTransitionRelation(manager, varorder);
     for(int i = 0; i < task->get_number_of_actions(); ++i) {
-        BDDAction bddaction;
         const Action &action = task->get_action(i);
-        bddaction.pre = manager.bddOne();
-        for (int var : action.pre) {
-            bddaction.pre *= manager.bddVar(varorder[var]*2);
+        transitions.add_action(action.pre, action.change);
+    }
+    transitions_built = true;
+}
+
+std::vector<DdNode *> BDDUtil::get_product_key(const std::vector<BDD *> &bdds) {
+    std::vector<DdNode *> key;
+    key.reserve(bdds.size());
+    for(BDD *bdd : bdds) {
+        key.push_back(bdd->getNode());
+    }
+    std::sort(key.begin(), key.end());
+    key.erase(std::unique(key.begin(), key.end()), key.end());
+    return key;
+}
+
+const BDD *BDDUtil::lookup_product(ProductCache &cache, const std::vector<DdNode *> &key) {
+    auto it = cache.find(key);
+    if(it == cache.end()) {
+        return nullptr;
+    }
+    return &(it->second.result);
+}
+
+void BDDUtil::cache_product(ProductCache &cache, std::vector<DdNode *> &&key,
+                            const std::vector<BDD *> &bdds, const BDD &result) {
+    if(cache.size() >= MAX_CACHED_PRODUCTS) {
+        cache.clear();
+    }
+    ProductCacheEntry entry;
+    entry.operands.reserve(bdds.size());
+    for(BDD *bdd : bdds) {
+        entry.operands.push_back(*bdd);
+    }
+    entry.result = result;
+    cache.emplace(std::move(key), std::move(entry));
+}
+
+BDD BDDUtil::get_conjunction(const std::vector<BDD *> &bdds) {
+    if(bdds.size() == 1) {
+        return *(bdds[0]);
+    }
+    std::vector<DdNode *> key = get_product_key(bdds);
+    const BDD *cached = lookup_product(conjunctions, key);
+    if(cached) {
+        return *cached;
+    }
+    BDD result = manager.bddOne();
+    for(BDD *bdd : bdds) {
+        result *= *bdd;
+        if(result.IsZero()) {
+            break;
         }
-        bddaction.eff = manager.bddOne();
-        for (size_t var = 0; var < action.change.size(); ++var) {
-            if (action.change[var] == 0) {
-                continue;
-            } else if (action.change[var] == 1) {
-                bddaction.eff *= manager.bddVar(varorder[var]*2);
-            } else {
-                bddaction.eff *= !manager.bddVar(varorder[var]*2);
-            }
+    }
+    cache_product(conjunctions, std::move(key), bdds, result);
+    return result;
+}
+
+BDD BDDUtil::get_disjunction(const std::vector<BDD *> &bdds) {
+    if(bdds.size() == 1) {
+        return *(bdds[0]);
+    }
+    std::vector<DdNode *> key = get_product_key(bdds);
+    const BDD *cached = lookup_product(disjunctions, key);
+    if(cached) {
+        return *cached;
+    }
+    BDD result = manager.bddZero();
+    for(BDD *bdd : bdds) {
+        result += *bdd;
+        if(result.IsOne()) {
+            break;
         }
-        actionformulas.push_back(bddaction);
     }
+    cache_product(disjunctions, std::move(key), bdds, result);
+    return result;
+}
+
+bool BDDUtil::is_conjunction_subset(const std::vector<BDD *> &bdds, const BDD &superset) {
+    if(bdds.empty()) {
+        return superset.IsOne();
+    }
+    if(bdds.size() == 1) {
+        return bdds[0]->Leq(superset);
+    }
+    std::vector<DdNode *> key = get_product_key(bdds);
+    const BDD *cached = lookup_product(conjunctions, key);
+    if(cached) {
+        return cached->Leq(superset);
+    }
+    BDD result = manager.bddOne();
+    for(BDD *bdd : bdds) {
+        if(bdd->Leq(superset)) {
+            return true;
+        }
+        result *= *bdd;
+        if(result.Leq(superset)) {
+            // the remaining conjuncts can only make the set smaller
+            return true;
+        }
+    }
+    cache_product(conjunctions, std::move(key), bdds, result);
+    return false;
 }
 
 bool BDDUtil::get_bdd_vector(std::vector<SetFormula *> &formulas, std::vector<BDD *> &bdds) {
@@ -217,7 +340,6 @@ bool BDDUtil::get_bdd_vector(std::vector<SetFormula *> &formulas, std::vector<BD
 }
 
 std::unordered_map<std::string, BDDFile> SetFormulaBDD::bddfiles;
-std::vector<int> SetFormulaBDD::prime_permutation;
 
 SetFormulaBDD::SetFormulaBDD()
     : util(nullptr), bdd(manager.bddZero()) {
@@ -228,19 +350,12 @@ SetFormulaBDD::SetFormulaBDD(BDDUtil *util, BDD bdd)
     : util(util), bdd(bdd) {
 }
 
-SetFormulaBDD::SetFormulaBDD(std::ifstream &input, Task *task) {
+SetFormulaBDD::SetFormulaBDD(std::istream &input, Task *task) {
     std::string filename;
     int bdd_index;
     input >> filename;
     input >> bdd_index;
     if(bddfiles.find(filename) == bddfiles.end()) {
-        if(bddfiles.empty()) {
-            prime_permutation.resize(task->get_number_of_facts()*2, -1);
-            for(int i = 0 ; i < task->get_number_of_facts(); ++i) {
-              prime_permutation[2*i] = (2*i)+1;
-              prime_permutation[(2*i)+1] = 2*i;
-            }
-        }
         bddfiles.emplace(std::piecewise_construct,
                          std::forward_as_tuple(filename),
                          std::forward_as_tuple(task, filename));
@@ -268,21 +383,21 @@ bool SetFormulaBDD::is_subset(std::vector<SetFormula *> &left,
         return false;
     }
 
-    BDD left_singular = manager.bddOne();
-    for(size_t i = 0; i < left_bdds.size(); ++i) {
-        left_singular *= *(left_bdds[i]);
-    }
-    BDD right_singular = manager.bddZero();
-    for(size_t i = 0; i < right_bdds.size(); ++i) {
-        right_singular += *(right_bdds[i]);
+    // before building any product, check if a single left BDD is below a single right BDD
+    for(BDD *left_bdd : left_bdds) {
+        for(BDD *right_bdd : right_bdds) {
+            if(left_bdd->Leq(*right_bdd)) {
+                return true;
+            }
+        }
     }
-    return left_singular.Leq(right_singular);
+    return util->is_conjunction_subset(left_bdds, util->get_disjunction(right_bdds));
 }
 
 bool SetFormulaBDD::is_subset_with_progression(std::vector<SetFormula *> &left,
                                                std::vector<SetFormula *> &right,
                                                std::vector<SetFormula *> &prog,
-                                               std::unordered_set<int> &actions) {
+                                               const std::unordered_set<int> &actions) {
 
     std::vector<BDD *> left_bdds;
     std::vector<BDD *> right_bdds;
@@ -294,51 +409,32 @@ bool SetFormulaBDD::is_subset_with_progression(std::vector<SetFormula *> &left,
         return false;
     }
 
-    BDD left_singular = manager.bddOne();
-    for (size_t i = 0; i < left_bdds.size(); ++i) {
-        left_singular *= *(left_bdds[i]);
-    }
-    BDD right_singular = manager.bddZero();
-    for (size_t i = 0; i < right_bdds.size(); ++i) {
-        right_singular += *(right_bdds[i]);
-    }
-
+    BDD left_singular = util->get_conjunction(left_bdds);
+    BDD right_singular = util->get_disjunction(right_bdds);
     BDD neg_left_or_right = (!left_singular) + right_singular;
+    // all successors/predecessors are trivially contained
+    if(neg_left_or_right.IsOne()) {
+        return true;
+    }
 
-    BDD prog_singular = manager.bddOne();
-    for (size_t i = 0; i < prog_bdds.size(); ++i) {
-        prog_singular *= *(prog_bdds[i]);
+    BDD prog_singular = util->get_conjunction(prog_bdds);
+    if(prog_singular.IsZero()) {
+        return true;
     }
-    if(util->actionformulas.size() == 0) {
-        util->build_actionformulas();
+    if(!util->transitions_built) {
+        util->build_transitions();
     }
 
-    for (int a : actions) {
-        const Action &action = util->task->get_action(a);
-        BDD prog_rn = prog_singular * util->actionformulas[a].pre;
-
-        for (int var = 0; var < util->task->get_number_of_facts(); ++var) {
-            int local_var = util->varorder[var];
-            if (action.change[var] != 0) {
-                prime_permutation[2*local_var] = 2*local_var+1;
-                prime_permutation[2*local_var+1] = 2*local_var;
-            } else {
-                prime_permutation[2*local_var] = 2*local_var;
-                prime_permutation[2*local_var+1] = 2*local_var+1;
-            }
-        }
-        prog_rn = (prog_rn.Permute(&prime_permutation[0]));
-        if ( !((prog_rn* util->actionformulas[a].eff).Leq(neg_left_or_right)) ) {
-            return false;
-        }
-    }
-    return true;
+    return util->transitions.check_images(prog_singular,
+        [&neg_left_or_right](const BDD &succ, const std::vector<int> &) {
+            return succ.Leq(neg_left_or_right);
+        }, &actions);
 }
 
 bool SetFormulaBDD::is_subset_with_regression(std::vector<SetFormula *> &left,
                                               std::vector<SetFormula *> &right,
                                               std::vector<SetFormula *> &reg,
-                                              std::unordered_set<int> &actions) {
+                                              const std::unordered_set<int> &actions) {
     std::vector<BDD *> left_bdds;
     std::vector<BDD *> right_bdds;
     std::vector<BDD *> reg_bdds;
@@ -349,44 +445,26 @@ bool SetFormulaBDD::is_subset_with_regression(std::vector<SetFormula *> &left,
         return false;
     }
 
-    BDD left_singular = manager.bddOne();
-    for (size_t i = 0; i < left_bdds.size(); ++i) {
-        left_singular *= *(left_bdds[i]);
-    }
-    BDD right_singular = manager.bddZero();
-    for (size_t i = 0; i < right_bdds.size(); ++i) {
-        right_singular += *(right_bdds[i]);
-    }
-
+    BDD left_singular = util->get_conjunction(left_bdds);
+    BDD right_singular = util->get_disjunction(right_bdds);
     BDD neg_left_or_right = (!left_singular) + right_singular;
+    // all successors/predecessors are trivially contained
+    if(neg_left_or_right.IsOne()) {
+        return true;
+    }
 
-    BDD reg_singular = manager.bddOne();
-    for (size_t i = 0; i < reg_bdds.size(); ++i) {
-        reg_singular *= *(reg_bdds[i]);
+    BDD reg_singular = util->get_conjunction(reg_bdds);
+    if(reg_singular.IsZero()) {
+        return true;
     }
-    if(util->actionformulas.size() == 0) {
-        util->build_actionformulas();
+    if(!util->transitions_built) {
+        util->build_transitions();
     }
 
-    for (int a : actions) {
-        const Action &action = util->task->get_action(a);
-        BDD reg_rn = reg_singular * util->actionformulas[a].eff;
-        for (int var = 0; var < util->task->get_number_of_facts(); ++var) {
-            int local_var = util->varorder[var];
-            if (action.change[var] != 0) {
-                prime_permutation[2*local_var] = 2*local_var+1;
-                prime_permutation[2*local_var+1] = 2*local_var;
-            } else {
-                prime_permutation[2*local_var] = 2*local_var;
-                prime_permutation[2*local_var+1] = 2*local_var+1;
-            }
-        }
-        reg_rn = reg_rn.Permute(&prime_permutation[0]);
-        if (!( (reg_rn*util->actionformulas[a].pre).Leq(neg_left_or_right) )) {
-            return false;
-        }
-    }
-    return true;
+    return util->transitions.check_preimages(reg_singular,
+        [&neg_left_or_right](const BDD &pred, const std::vector<int> &) {
+            return pred.Leq(neg_left_or_right);
+        }, &actions);
 }
 
 bool SetFormulaBDD::is_subset_of(SetFormula *superset, bool left_positive, bool right_positive) {
@@ -2,6 +2,8 @@
 #define SETFORMULABDD_H
 
 #include "setformulabasic.h"
+#include "bddprefetcher.h"
+#include "bddtransitionrelation.h"
 
 #include <unordered_map>
 #include <sstream>
@@ -21,32 +23,57 @@ struct VectorHasher {
     }
 };
 
+struct NodeVectorHasher {
+    size_t operator()(const std::vector<DdNode *> &nodes) const {
+        size_t hash = 0;
+        for(DdNode *node : nodes) {
+            hash = hash*31 + std::hash<DdNode *>()(node);
+        }
+        return hash;
+    }
+};
+
 class BDDFile {
 private:
     static std::unordered_map<std::vector<int>, BDDUtil, VectorHasher> utils;
-    static std::vector<int> compose;
+    static bool reordering;
+    // the variable order of each newly created BDDUtil is written here (if >= 0)
+    static int varorder_report_fd;
+    // maps the variables of the dump to their position in the manager
+    std::vector<int> compose;
     BDDUtil *util;
-    FILE *fp;
+    std::unique_ptr<BDDPrefetcher> prefetcher;
     std::unordered_map<int, DdNode *> ddnodes;
 public:
     BDDFile() {}
     BDDFile(Task *task, std::string filename);
+    /*
+     * Enables dynamic (group sifting) reordering in the manager. Each variable
+     * and its primed copy form a group that is kept together. All BDD files are
+     * then loaded into one common variable order, such that sets from files
+     * with different orders can be used in the same statement.
+     * Must be called before the first BDD file is read.
+     */
+    static void enable_reordering(Task *task);
+    /*
+     * In batch mode, each verification job reports the variable orders of
+     * the BDD files it reads to fd (as the amount of variables followed by
+     * the order, all as raw ints). The next jobs for the same task get the
+     * BDDUtil for these orders from precompile_util, including the transition
+     * relation.
+     */
+    static void set_varorder_report_fd(int fd);
+    static void precompile_util(Task *task, std::vector<int> &varorder);
     // expects caller to take ownership and call deref!
     DdNode *get_ddnode(int index);
     BDDUtil *get_util();
 };
 
-struct BDDAction {
-    BDD pre;
-    BDD eff;
-};
-
 class SetFormulaBDD : public SetFormulaBasic
 {
     friend class BDDUtil;
 private:
     static std::unordered_map<std::string, BDDFile> bddfiles;
-    static std::vector<int> prime_permutation;
     // TODO: can we change this to a reference?
     BDDUtil *util;
     BDD bdd;
@@ -54,18 +81,18 @@ private:
     SetFormulaBDD(BDDUtil *util, BDD bdd);
 public:
     SetFormulaBDD();
-    SetFormulaBDD(std::ifstream &input, Task *task);
+    SetFormulaBDD(std::istream &input, Task *task);
 
     virtual bool is_subset(std::vector<SetFormula *> &left,
                            std::vector<SetFormula *> &right);
     virtual bool is_subset_with_progression(std::vector<SetFormula *> &left,
                                             std::vector<SetFormula *> &right,
                                             std::vector<SetFormula *> &prog,
-                                            std::unordered_set<int> &actions);
+                                            const std::unordered_set<int> &actions);
     virtual bool is_subset_with_regression(std::vector<SetFormula *> &left,
                                            std::vector<SetFormula *> &right,
                                            std::vector<SetFormula *> &reg,
-                                           std::unordered_set<int> &actions);
+                                           const std::unordered_set<int> &actions);
 
     virtual bool is_subset_of(SetFormula *superset, bool left_positive, bool right_positive);
 
@@ -97,12 +124,13 @@ public:
  * as well as all constant and action formulas in the respective
  * variable order.
  *
- * Note: action formulas are only created on demand (when the method
- * pro/regression_is_union_subset is used the first time by some
+ * Note: the transition relation is only created on demand (when the method
+ * is_subset_with_pro/regression is used the first time by some
  * SetFormulaBDD using this particual BDDUtil)
  */
 class BDDUtil {
     friend class SetFormulaBDD;
+    friend class BDDFile;
 private:
     Task *task;
     // TODO: fix varorder meaning across the code!
@@ -114,11 +142,41 @@ private:
     SetFormulaBDD emptyformula;
     SetFormulaBDD initformula;
     SetFormulaBDD goalformula;
-    std::vector<BDDAction> actionformulas;
+    BDDTransitionRelation transitions;
+    bool transitions_built;
+
+    /*
+     * Conjunctions and disjunctions of several BDDs are cached, keyed on the
+     * sorted nodes of the operands. Since BDDs are canonical, equal nodes
+     * represent the same set. An entry keeps its operands referenced such that
+     * their nodes cannot be reused for other BDDs while the key exists.
+     */
+    struct ProductCacheEntry {
+        std::vector<BDD> operands;
+        BDD result;
+    };
+    typedef std::unordered_map<std::vector<DdNode *>, ProductCacheEntry, NodeVectorHasher> ProductCache;
+    // the caches are cleared when they reach this size
+    static const size_t MAX_CACHED_PRODUCTS = 1024;
+    ProductCache conjunctions;
+    ProductCache disjunctions;
 
     BDD build_bdd_from_cube(const Cube &cube);
-    //BDD build_bdd_for_action(const Action &a);
-    void build_actionformulas();
+    void build_transitions();
+
+    static std::vector<DdNode *> get_product_key(const std::vector<BDD *> &bdds);
+    // returns nullptr if the product is not cached
+    const BDD *lookup_product(ProductCache &cache, const std::vector<DdNode *> &key);
+    void cache_product(ProductCache &cache, std::vector<DdNode *> &&key,
+                       const std::vector<BDD *> &bdds, const BDD &result);
+    BDD get_conjunction(const std::vector<BDD *> &bdds);
+    BDD get_disjunction(const std::vector<BDD *> &bdds);
+    /*
+     * Checks whether the conjunction of bdds is a subset of superset. The
+     * conjunction is built incrementally and the check stops as soon as a
+     * partial conjunction is a subset, in which case it is not cached.
+     */
+    bool is_conjunction_subset(const std::vector<BDD *> &bdds, const BDD &superset);
 
     /*
      * Returns a vector containing all BDDs contained in the vector of SetFormulas.
@@ -6,7 +6,7 @@
 #include "setformulahorn.h"
 #include "global_funcs.h"
 
-SetFormulaConstant::SetFormulaConstant(std::ifstream &input, Task *task)
+SetFormulaConstant::SetFormulaConstant(std::istream &input, Task *task)
     : task(task) {
     std::string type;
     input >> type;
@@ -57,7 +57,7 @@ bool SetFormulaConstant::is_subset(std::vector<SetFormula *> &,
 bool SetFormulaConstant::is_subset_with_progression(std::vector<SetFormula *> &,
                                                     std::vector<SetFormula *> &,
                                                     std::vector<SetFormula *> &,
-                                                    std::unordered_set<int> &) {
+                                                    const std::unordered_set<int> &) {
     std::cerr << "subset checks should not be forwarded to SetFormulaConstant";
     exit_with(ExitCode::CRITICAL_ERROR);
 }
@@ -65,7 +65,7 @@ bool SetFormulaConstant::is_subset_with_progression(std::vector<SetFormula *> &,
 bool SetFormulaConstant::is_subset_with_regression(std::vector<SetFormula *> &,
                                                    std::vector<SetFormula *> &,
                                                    std::vector<SetFormula *> &,
-                                                   std::unordered_set<int> &) {
+                                                   const std::unordered_set<int> &) {
     std::cerr << "subset checks should not be forwarded to SetFormulaConstant";
     exit_with(ExitCode::CRITICAL_ERROR);
 }
@@ -19,18 +19,18 @@ private:
      */
     SetFormulaBasic *get_concrete_formula_instance(SetFormula *f1, SetFormula *f2);
 public:
-    SetFormulaConstant(std::ifstream &input, Task *task);
+    SetFormulaConstant(std::istream &input, Task *task);
 
     virtual bool is_subset(std::vector<SetFormula *> &left,
                            std::vector<SetFormula *> &right);
     virtual bool is_subset_with_progression(std::vector<SetFormula *> &left,
                                             std::vector<SetFormula *> &right,
                                             std::vector<SetFormula *> &prog,
-                                            std::unordered_set<int> &);
+                                            const std::unordered_set<int> &);
     virtual bool is_subset_with_regression(std::vector<SetFormula *> &left,
                                            std::vector<SetFormula *> &right,
                                            std::vector<SetFormula *> &reg,
-                                           std::unordered_set<int> &);
+                                           const std::unordered_set<int> &);
 
     virtual bool is_subset_of(SetFormula *superset, bool left_positive, bool right_positive);
 
@@ -3,6 +3,7 @@
 #include "setformulabdd.h"
 
 #include <cassert>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <algorithm>
@@ -12,15 +13,114 @@
 #include "global_funcs.h"
 
 
+ModelStore::ModelStore(size_t var_amount)
+    : var_amount(var_amount), stride((var_amount+63)/64), model_amount(0) {
+}
+
+size_t ModelStore::hash(const uint64_t *packed) const {
+    uint64_t h = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < stride; ++i) {
+        h ^= packed[i];
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 32;
+    }
+    return h;
+}
+
+bool ModelStore::equals(size_t index, const uint64_t *packed) const {
+    return std::memcmp(get_packed(index), packed, stride*sizeof(uint64_t)) == 0;
+}
+
+void ModelStore::grow_table() {
+    table.assign(std::max<size_t>(16, 2*table.size()), 0);
+    size_t mask = table.size()-1;
+    for (size_t index = 0; index < model_amount; ++index) {
+        size_t slot = hash(get_packed(index)) & mask;
+        while (table[slot] != 0) {
+            slot = (slot+1) & mask;
+        }
+        table[slot] = index+1;
+    }
+}
+
+void ModelStore::unpack(size_t index, Model &model) const {
+    model.resize(var_amount);
+    const uint64_t *packed = get_packed(index);
+    for (size_t i = 0; i < var_amount; ++i) {
+        model[i] = (packed[i/64] >> (i%64)) & 1;
+    }
+}
+
+void ModelStore::pack(const Model &model, uint64_t *packed) const {
+    assert(model.size() == var_amount);
+    std::fill(packed, packed+stride, 0);
+    for (size_t i = 0; i < var_amount; ++i) {
+        if (model[i]) {
+            packed[i/64] |= (uint64_t(1) << (i%64));
+        }
+    }
+}
+
+bool ModelStore::insert_packed(const uint64_t *packed) {
+    if (2*(model_amount+1) > table.size()) {
+        grow_table();
+    }
+    size_t mask = table.size()-1;
+    size_t slot = hash(packed) & mask;
+    while (table[slot] != 0) {
+        if (equals(table[slot]-1, packed)) {
+            return false;
+        }
+        slot = (slot+1) & mask;
+    }
+    if (model_amount == UINT32_MAX) {
+        std::cerr << "Too many models in explicit set." << std::endl;
+        exit_with(ExitCode::OUT_OF_MEMORY);
+    }
+    arena.insert(arena.end(), packed, packed+stride);
+    table[slot] = ++model_amount;
+    return true;
+}
+
+bool ModelStore::insert(const Model &model) {
+    std::vector<uint64_t> packed(stride);
+    pack(model, packed.data());
+    return insert_packed(packed.data());
+}
+
+bool ModelStore::contains_packed(const uint64_t *packed) const {
+    if (model_amount == 0) {
+        return false;
+    }
+    size_t mask = table.size()-1;
+    size_t slot = hash(packed) & mask;
+    while (table[slot] != 0) {
+        if (equals(table[slot]-1, packed)) {
+            return true;
+        }
+        slot = (slot+1) & mask;
+    }
+    return false;
+}
+
+bool ModelStore::contains(const Model &model) const {
+    // is_contained is called very often and possibly from several threads
+    thread_local std::vector<uint64_t> packed;
+    packed.resize(stride);
+    pack(model, packed.data());
+    return contains_packed(packed.data());
+}
+
+
 ExplicitUtil::ExplicitUtil(Task *task)
     : task(task) {
 
     std::vector<int> varorder(1,0);
-    std::unordered_set<std::vector<bool>> entries;
-    emptyformula = SetFormulaExplicit(std::move(varorder), std::move(entries));
+    std::vector<Model> entries;
+    emptyformula = SetFormulaExplicit(std::move(varorder), entries);
     varorder = std::vector<int> {0};
-    entries = std::unordered_set<std::vector<bool>> {{true},{false}};
-    trueformula = SetFormulaExplicit(std::move(varorder), std::move(entries));
+    entries = std::vector<Model> {{true},{false}};
+    trueformula = SetFormulaExplicit(std::move(varorder), entries);
     varorder = std::vector<int>();
     int var = 0;
     for ( int val : task->get_goal()) {
@@ -29,13 +129,13 @@ ExplicitUtil::ExplicitUtil(Task *task)
         }
         var++;
     }
-    entries = std::unordered_set<std::vector<bool>> {std::vector<bool>(varorder.size(), true)};
-    goalformula = SetFormulaExplicit(std::move(varorder),std::move(entries));
+    entries = std::vector<Model> {Model(varorder.size(), true)};
+    goalformula = SetFormulaExplicit(std::move(varorder), entries);
     varorder = std::vector<int>(task->get_number_of_facts(),-1);
     for (size_t i = 0; i < varorder.size(); ++i) {
         varorder[i] = i;
     }
-    entries = std::unordered_set<std::vector<bool>>();
+    entries.clear();
     std::vector<bool> entry(varorder.size());
     var = 0;
     for ( int val : task->get_initial_state()) {
@@ -43,17 +143,8 @@ ExplicitUtil::ExplicitUtil(Task *task)
             entry[var] = true;
         }
     }
-    entries.insert(std::move(entry));
-    initformula = SetFormulaExplicit(std::move(varorder),std::move(entries));
-
-
-    hex.reserve(16);
-    for(int i = 0; i < 16; ++i) {
-        std::vector<bool> tmp = { (bool)((i >> 3)%2), (bool)((i >> 2)%2),
-                                 (bool)((i >> 1)%2), (bool)(i%2)};
-        hex.push_back(tmp);
-    }
-
+    entries.push_back(std::move(entry));
+    initformula = SetFormulaExplicit(std::move(varorder), entries);
 }
 
 bool ExplicitUtil::get_explicit_vector(std::vector<SetFormula *> &formulas,
@@ -272,28 +363,35 @@ SetFormulaExplicit::SetFormulaExplicit() {
 }
 
 SetFormulaExplicit::SetFormulaExplicit(std::vector<int> &&vars,
-                                       std::unordered_set<std::vector<bool>> &&entries)
-    : vars(vars), models(entries) {
-    for (std::vector<bool> entry : this->models) {
-        assert(vars.size() == entry.size());
+                                       const std::vector<Model> &entries)
+    : vars(vars), models(this->vars.size()) {
+    for (const Model &entry : entries) {
+        assert(this->vars.size() == entry.size());
+        models.insert(entry);
     }
-
 }
 
 SetFormulaExplicit::SetFormulaExplicit(std::vector<int> &varorder, std::vector<SetFormulaExplicit *> &disjuncts)
-    : vars(varorder) {
+    : vars(varorder), models(varorder.size()) {
     for (SetFormulaExplicit *formula : disjuncts) {
         if(formula->vars != vars) {
             std::cerr << "Tried to build Explicit union with different varorder." << std::endl;
             return;
         }
-        for (Model model : formula->models) {
-            models.insert(model);
+        // same varorder -> the packed models can be copied directly
+        for (size_t i = 0; i < formula->models.size(); ++i) {
+            models.insert_packed(formula->models.get_packed(i));
         }
     }
 }
 
-SetFormulaExplicit::SetFormulaExplicit(std::ifstream &input, Task *task) {
+SetFormulaExplicit::SetFormulaExplicit(Task *task) {
+    if(!util) {
+        util = std::unique_ptr<ExplicitUtil>(new ExplicitUtil(task));
+    }
+}
+
+SetFormulaExplicit::SetFormulaExplicit(std::istream &input, Task *task) {
     if(!util) {
         util = std::unique_ptr<ExplicitUtil>(new ExplicitUtil(task));
     }
@@ -315,34 +413,49 @@ SetFormulaExplicit::SetFormulaExplicit(std::ifstream &input, Task *task) {
         exit_with(ExitCode::PARSING_ERROR);
     }
 
-    // TODO: would a reserve make sense? but then we need to know the number of models
-
+    // each hex digit describes the value of 4 consecutive variables
+    models = ModelStore(varamount);
+    std::vector<uint64_t> packed(models.get_stride());
+    size_t digits = (varamount+3)/4;
     input >> s;
     while(s.compare(";") != 0) {
-        std::vector<bool> entry(varamount);
-        int pos = 0;
-        const std::vector<bool> *vec;
-        for (int i = 0; i < (varamount/4); ++i) {
-            if (s.at(i) < 'a') {
-                vec = &(util->hex.at(s.at(i)-'0'));
-            } else {
-                vec = &(util->hex.at(s.at(i)-'a'+10));
-            }
-            for (int i = 0; i < 4; ++i) {
-                entry[pos++] = vec->at(i);
-            }
-        }
-        if(varamount%4 != 0) {
-            if (s.at(varamount/4) < 'a') {
-                vec = &(util->hex.at(s.at(varamount/4)-'0'));
+        if (!input) {
+            std::cerr << "Error when parsing Explicit Formula: models are not "
+                      << "terminated by ;" << std::endl;
+            exit_with(ExitCode::PARSING_ERROR);
+        }
+        if (s.size() < digits) {
+            std::cerr << "Error when parsing Explicit Formula: model " << s
+                      << " is too short." << std::endl;
+            exit_with(ExitCode::PARSING_ERROR);
+        }
+        std::fill(packed.begin(), packed.end(), 0);
+        for (size_t i = 0; i < digits; ++i) {
+            uint64_t digit;
+            if (s[i] >= '0' && s[i] <= '9') {
+                digit = s[i]-'0';
+            } else if (s[i] >= 'a' && s[i] <= 'f') {
+                digit = s[i]-'a'+10;
             } else {
-                vec = &(util->hex.at(s.at(varamount/4)-'a'+10));
-            }
-            for (int i = 0; i < (varamount%4); ++i) {
-                entry[pos++] = vec->at(i);
+                std::cerr << "Error when parsing Explicit Formula: model " << s
+                          << " contains an invalid hex digit." << std::endl;
+                exit_with(ExitCode::PARSING_ERROR);
+            }
+            // the last digit might describe less than 4 variables, the rest must be 0
+            size_t remaining = std::min<size_t>(4, varamount - 4*i);
+            if ((digit & ((uint64_t(1) << (4-remaining)) - 1)) != 0) {
+                std::cerr << "Error when parsing Explicit Formula: model " << s
+                          << " sets more than " << varamount << " variables." << std::endl;
+                exit_with(ExitCode::PARSING_ERROR);
+            }
+            for (size_t j = 0; j < remaining; ++j) {
+                size_t pos = 4*i+j;
+                if ((digit >> (3-j)) & 1) {
+                    packed[pos/64] |= (uint64_t(1) << (pos%64));
+                }
             }
         }
-        models.insert(std::move(entry));
+        models.insert_packed(packed.data());
         input >> s;
     }
 }
@@ -388,8 +501,34 @@ bool SetFormulaExplicit::is_subset(std::vector<SetFormula *> &left,
     ExplicitUtil::SubsetCheckHelper helper =
             util->get_subset_checker_helper(reference->vars, left_explicit, right_explicit);
 
+    /*
+     * If all formulas have the same varorder as the reference, we can look up
+     * the packed models directly.
+     */
+    if (helper.other_varorder_left.empty() && helper.other_varorder_right.empty()) {
+        for (size_t i = 0; i < reference->models.size(); ++i) {
+            const uint64_t *packed = reference->models.get_packed(i);
+            bool contained = false;
+            for (SetFormulaExplicit *formula : helper.same_varorder_left) {
+                if (!formula->models.contains_packed(packed)) {
+                    contained = true;
+                    break;
+                }
+            }
+            for (size_t j = 0; !contained && j < helper.same_varorder_right.size(); ++j) {
+                contained = helper.same_varorder_right[j]->models.contains_packed(packed);
+            }
+            if (!contained) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     // loop over each model of the reference formula
-    for (const std::vector<bool> &model : reference->models) {
+    Model model;
+    for (size_t i = 0; i < reference->models.size(); ++i) {
+        reference->models.unpack(i, model);
         if(!util->is_model_contained(model,helper)) {
             return false;
         }
@@ -400,7 +539,7 @@ bool SetFormulaExplicit::is_subset(std::vector<SetFormula *> &left,
 bool SetFormulaExplicit::is_subset_with_progression(std::vector<SetFormula *> &left,
                                                     std::vector<SetFormula *> &right,
                                                     std::vector<SetFormula *> &prog,
-                                                    std::unordered_set<int> &actions) {
+                                                    const std::unordered_set<int> &actions) {
     assert(!prog.empty());
     std::vector<SetFormulaExplicit *> left_explicit;
     std::vector<SetFormulaExplicit *> right_explicit;
@@ -482,11 +621,11 @@ bool SetFormulaExplicit::is_subset_with_progression(std::vector<SetFormula *> &l
         Model model;
         model.reserve(varorder.size());
 
-        for (Model prog_model : prog_singular->models) {
+        for (size_t i = 0; i < prog_singular->models.size(); ++i) {
             // check preconditions
             bool preconditions_met = true;
             for (int pos : pre_to_check) {
-                if (prog_model[pos] == false) {
+                if (prog_singular->models.get_value(i, pos) == false) {
                     preconditions_met = false;
                     break;
                 }
@@ -496,8 +635,7 @@ bool SetFormulaExplicit::is_subset_with_progression(std::vector<SetFormula *> &l
                 continue;
             }
 
-            model.clear();
-            model.insert(std::end(model), std::begin(prog_model), std::end(prog_model));
+            prog_singular->models.unpack(i, model);
             model.resize(varorder.size());
 
             // apply changes from action and check if the model is contained
@@ -523,7 +661,7 @@ bool SetFormulaExplicit::is_subset_with_progression(std::vector<SetFormula *> &l
 bool SetFormulaExplicit::is_subset_with_regression(std::vector<SetFormula *> &left,
                                                    std::vector<SetFormula *> &right,
                                                    std::vector<SetFormula *> &reg,
-                                                   std::unordered_set<int> &actions) {
+                                                   const std::unordered_set<int> &actions) {
     assert(!reg.empty());
     std::vector<SetFormulaExplicit *> left_explicit;
     std::vector<SetFormulaExplicit *> right_explicit;
@@ -597,17 +735,17 @@ bool SetFormulaExplicit::is_subset_with_regression(std::vector<SetFormula *> &le
         Model model;
         model.reserve(varorder.size());
 
-        for (Model reg_model : reg_singular->models) {
+        for (size_t i = 0; i < reg_singular->models.size(); ++i) {
             // check add/del
             bool add_del_met = true;
             for (int pos : add_pos) {
-                if (reg_model[pos] == false) {
+                if (reg_singular->models.get_value(i, pos) == false) {
                     add_del_met = false;
                     break;
                 }
             }
             for (int pos : del_pos) {
-                if (reg_model[pos] == true) {
+                if (reg_singular->models.get_value(i, pos) == true) {
                     add_del_met = false;
                     break;
                 }
@@ -617,8 +755,7 @@ bool SetFormulaExplicit::is_subset_with_regression(std::vector<SetFormula *> &le
                 continue;
             }
 
-            model.clear();
-            model.insert(std::end(model), std::begin(reg_model), std::end(reg_model));
+            reg_singular->models.unpack(i, model);
             model.resize(varorder.size());
 
             // apply changes from action and check if the model is contained
@@ -663,9 +800,9 @@ bool SetFormulaExplicit::is_subset_of(SetFormula *superset, bool left_positive,
         // superset varorder does not contain new vars --> can do model check
         if (superset_varorder_is_subset) {
             std::vector<bool> transformed_model(var_pos.size());
-            for (Model model : models) {
+            for (size_t m = 0; m < models.size(); ++m) {
                 for (size_t i = 0; i < transformed_model.size(); ++i) {
-                    transformed_model[i] = model[var_pos[i]];
+                    transformed_model[i] = models.get_value(m, var_pos[i]);
                 }
                 if (!superset->is_contained(transformed_model)) {
                     return false;
@@ -673,7 +810,9 @@ bool SetFormulaExplicit::is_subset_of(SetFormula *superset, bool left_positive,
             }
             return true;
         } else if (superset->supports_implicant_check()) {
-            for (Model model : models) {
+            Model model;
+            for (size_t m = 0; m < models.size(); ++m) {
+                models.unpack(m, model);
                 if (!superset->is_implicant(vars, model)) {
                     return false;
                 }
@@ -700,9 +839,9 @@ bool SetFormulaExplicit::is_subset_of(SetFormula *superset, bool left_positive,
         // superset varorder does not contain new vars --> can do model check
         if (superset_varorder_is_subset) {
             std::vector<bool> transformed_model(var_pos.size());
-            for (Model model : models) {
+            for (size_t m = 0; m < models.size(); ++m) {
                 for (size_t i = 0; i < transformed_model.size(); ++i) {
-                    transformed_model[i] = model[var_pos[i]];
+                    transformed_model[i] = models.get_value(m, var_pos[i]);
                 }
                 if (!superset->is_contained(transformed_model)) {
                     return false;
@@ -710,15 +849,16 @@ bool SetFormulaExplicit::is_subset_of(SetFormula *superset, bool left_positive,
             }
             return true;
         } else if (superset->supports_clausal_entailment_check()) {
-            for (Model model : models) {
-                std::vector<bool> clause(model.size());
-                for (size_t i = 0; i < model.size(); ++i) {
-                    clause[i] = !model[i];
+            std::vector<bool> clause(vars.size());
+            for (size_t m = 0; m < models.size(); ++m) {
+                for (size_t i = 0; i < clause.size(); ++i) {
+                    clause[i] = !models.get_value(m, i);
                 }
                 if (!superset->is_entailed(vars, clause)) {
                     return false;
                 }
             }
+            return true;
         } else if (superset->supports_dnf_enumeration()) {
             return superset->is_subset_of(this, true, false);
         } else {
@@ -731,10 +871,10 @@ bool SetFormulaExplicit::is_subset_of(SetFormula *superset, bool left_positive,
         // superset varorder does not contain new vars --> can do model check
         if (superset_varorder_is_subset && superset->supports_model_counting()) {
             std::vector<bool> transformed_model(var_pos.size());
-            int count;
-            for (Model model : models) {
+            int count = 0;
+            for (size_t m = 0; m < models.size(); ++m) {
                 for (size_t i = 0; i < transformed_model.size(); ++i) {
-                    transformed_model[i] = model[var_pos[i]];
+                    transformed_model[i] = models.get_value(m, var_pos[i]);
                 }
                 if (!superset->is_contained(transformed_model)) {
                     count++;
@@ -799,7 +939,7 @@ std::vector<Model> SetFormulaExplicit::get_missing_var_values(Model &model, cons
 }
 
 bool SetFormulaExplicit::is_contained(const std::vector<bool> &model) const {
-    return (models.find(model) != models.end());
+    return models.contains(model);
 }
 
 bool SetFormulaExplicit::is_implicant(const std::vector<int> &varorder, const std::vector<bool> &implicant) {
@@ -826,10 +966,10 @@ bool SetFormulaExplicit::is_implicant(const std::vector<int> &varorder, const st
 }
 
 bool SetFormulaExplicit::is_entailed(const std::vector<int> &varorder, const std::vector<bool> &clause) {
-    for (Model model : models) {
+    for (size_t m = 0; m < models.size(); ++m) {
         bool found = false;
         for (size_t i = 0; i < clause.size(); ++i) {
-            if (model[varorder[i]] == clause[i]) {
+            if (models.get_value(m, varorder[i]) == clause[i]) {
                 found = true;
                 break;
             }
@@ -5,6 +5,7 @@
 #include "task.h"
 
 #include "cuddObj.hh"
+#include <cstdint>
 #include <memory>
 #include <unordered_set>
 
@@ -14,20 +15,61 @@ typedef std::vector<Model> ModelExtensions;
 typedef std::vector<const Model *>GlobalModel;
 typedef std::pair<int,int> GlobalModelVarOcc;
 
+/*
+ * Set of models over a fixed amount of variables. Each model is packed into
+ * stride 64-bit words (bit i of the model is bit i%64 of word i/64, unused
+ * bits are 0) and all models lie consecutively in one arena. Lookups go over
+ * an open addressing hash table storing model indices.
+ */
+class ModelStore {
+private:
+    size_t var_amount;
+    size_t stride;
+    size_t model_amount;
+    std::vector<uint64_t> arena;
+    // model index + 1, 0 denotes an empty slot; size is a power of 2
+    std::vector<uint32_t> table;
+
+    size_t hash(const uint64_t *packed) const;
+    bool equals(size_t index, const uint64_t *packed) const;
+    void grow_table();
+public:
+    explicit ModelStore(size_t var_amount = 0);
+
+    size_t size() const { return model_amount; }
+    size_t get_stride() const { return stride; }
+    const uint64_t *get_packed(size_t index) const {
+        return arena.data() + index*stride;
+    }
+    bool get_value(size_t index, size_t var_pos) const {
+        return (arena[index*stride + var_pos/64] >> (var_pos%64)) & 1;
+    }
+    void unpack(size_t index, Model &model) const;
+    // packed must point to stride words
+    void pack(const Model &model, uint64_t *packed) const;
+
+    // return false if the model was already contained
+    bool insert_packed(const uint64_t *packed);
+    bool insert(const Model &model);
+    bool contains_packed(const uint64_t *packed) const;
+    bool contains(const Model &model) const;
+};
+
 class SetFormulaExplicit : public SetFormulaBasic
 {
     friend class ExplicitUtil;
 private:
     static std::unique_ptr<ExplicitUtil> util;
     std::vector<int> vars;
-    std::unordered_set<Model> models;
-    std::unordered_set<Model>::iterator model_it;
-    SetFormulaExplicit(std::vector<int> &&vars, std::unordered_set<Model> &&models);
+    ModelStore models;
+    SetFormulaExplicit(std::vector<int> &&vars, const std::vector<Model> &models);
     // all formulas need to have same varorder
     SetFormulaExplicit(std::vector<int> &varorder, std::vector<SetFormulaExplicit *>&disjuncts);
 public:
     SetFormulaExplicit();
-    SetFormulaExplicit(std::ifstream &input, Task *task);
+    // only initializes util (used for preparing a task in batch mode)
+    SetFormulaExplicit(Task *task);
+    SetFormulaExplicit(std::istream &input, Task *task);
     virtual ~SetFormulaExplicit() {}
 
     virtual bool is_subset(std::vector<SetFormula *> &left,
@@ -35,11 +77,11 @@ public:
     virtual bool is_subset_with_progression(std::vector<SetFormula *> &left,
                                             std::vector<SetFormula *> &right,
                                             std::vector<SetFormula *> &prog,
-                                            std::unordered_set<int> &actions);
+                                            const std::unordered_set<int> &actions);
     virtual bool is_subset_with_regression(std::vector<SetFormula *> &left,
                                            std::vector<SetFormula *> &right,
                                            std::vector<SetFormula *> &reg,
-                                           std::unordered_set<int> &actions);
+                                           const std::unordered_set<int> &actions);
 
     virtual bool is_subset_of(SetFormula *superset, bool left_positive, bool right_positive);
 
@@ -78,7 +120,6 @@ private:
     SetFormulaExplicit trueformula;
     SetFormulaExplicit initformula;
     SetFormulaExplicit goalformula;
-    std::vector<std::vector<bool>> hex;
 
     ExplicitUtil(Task *task);
 
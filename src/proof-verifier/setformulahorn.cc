@@ -4,51 +4,60 @@
 #include <deque>
 #include <algorithm>
 #include <cassert>
+#include <cstdlib>
 #include <iostream>
 
 #include "global_funcs.h"
 
-HornConjunctionElement::HornConjunctionElement (const SetFormulaHorn *formula)
+template<bool Dual>
+HornConjunctionElement<Dual>::HornConjunctionElement(const HornFormula<Dual> *formula)
     : formula(formula), removed_implications(formula->get_size(), false) {
 }
 
-HornUtil::HornUtil(Task *task)
+template<bool Dual>
+HornUtil<Dual>::HornUtil(Task *task)
     : task(task) {
     int varamount = task->get_number_of_facts();
     std::vector<std::pair<std::vector<int>,int>> clauses;
     // this is the maximum amount of clauses the formulas need
     clauses.reserve(varamount*2);
 
-    trueformula = new SetFormulaHorn(clauses, varamount);
+    trueformula = new Formula(clauses, varamount);
     clauses.push_back(std::make_pair(std::vector<int>(1,0),-1));
     clauses.push_back(std::make_pair(std::vector<int>(),0));
-    emptyformula = new SetFormulaHorn(clauses, varamount);
+    emptyformula = new Formula(clauses, varamount);
     clauses.clear();
 
     // insert goal
     const Cube &goal = task->get_goal();
     for(int i = 0; i < goal.size(); ++i) {
         if(goal.at(i) == 1) {
-            clauses.push_back(std::make_pair(std::vector<int>(),i));
+            clauses.push_back(unit_clause(i, true));
         }
     }
-    goalformula = new SetFormulaHorn(clauses, varamount);
+    goalformula = new Formula(clauses, varamount);
     clauses.clear();
 
     // insert initial state
     clauses.clear();
     const Cube &init = task->get_initial_state();
     for(int i = 0; i < init.size(); ++i) {
-        if(init.at(i) == 1) {
-            clauses.push_back(std::make_pair(std::vector<int>(),i));
-        } else {
-            clauses.push_back(std::make_pair(std::vector<int>(1,i),-1));
-        }
+        clauses.push_back(unit_clause(i, init.at(i) == 1));
     }
-    initformula = new SetFormulaHorn(clauses, varamount);
+    initformula = new Formula(clauses, varamount);
 }
 
-bool HornUtil::get_horn_vector(std::vector<SetFormula *> &formulas, std::vector<SetFormulaHorn *> &horn_formulas) {
+template<bool Dual>
+std::pair<std::vector<int>,int> HornUtil<Dual>::unit_clause(int var, bool value) {
+    if (HornPolarity<Dual>::internal(value)) {
+        return std::make_pair(std::vector<int>(), var);
+    } else {
+        return std::make_pair(std::vector<int>(1,var), -1);
+    }
+}
+
+template<bool Dual>
+bool HornUtil<Dual>::get_horn_vector(std::vector<SetFormula *> &formulas, std::vector<Formula *> &horn_formulas) {
     assert(horn_formulas.empty());
     horn_formulas.reserve(formulas.size());
     for(size_t i = 0; i < formulas.size(); ++i) {
@@ -70,162 +79,246 @@ bool HornUtil::get_horn_vector(std::vector<SetFormula *> &formulas, std::vector<
                 exit_with(ExitCode::CRITICAL_ERROR);
                 break;
             }
-        } else if(formulas[i]->get_formula_type() == SetFormulaType::HORN) {
-            SetFormulaHorn *h_formula = static_cast<SetFormulaHorn *>(formulas[i]);
+        } else if(formulas[i]->get_formula_type() == HornPolarity<Dual>::type) {
+            Formula *h_formula = static_cast<Formula *>(formulas[i]);
             horn_formulas.push_back(h_formula);
         } else {
-            std::cerr << "Error: SetFormula of type other than Horn not allowed here."
-                      << std::endl;
+            std::cerr << "Error: SetFormula of type other than " << HornPolarity<Dual>::name()
+                      << " not allowed here." << std::endl;
             return false;
         }
     }
     return true;
 }
 
-bool HornUtil::simplify_conjunction(std::vector<HornConjunctionElement> &conjuncts, Cube &partial_assignment) {
-    int total_varamount = partial_assignment.size();
-    int amount_implications = 0;
-    std::vector<int> implstart;
-
-    std::deque<std::pair<int,bool>> unit_clauses;
-    std::vector<int> leftcount;
-    std::vector<int> rightvars;
+template<bool Dual>
+HornPropagator::HornPropagator(const std::vector<const HornFormula<Dual> *> &formulas, int varamount)
+    : varamount(varamount), queue_head(0), conflict(false) {
+    for (const HornFormula<Dual> *formula : formulas) {
+        this->varamount = std::max(this->varamount, formula->get_varamount());
+    }
 
-    for(size_t var = 0; var < partial_assignment.size(); ++var) {
-        int assignment = partial_assignment[var];
-        if (assignment == 0) {
-            unit_clauses.push_back(std::make_pair(var,false));
-        } else if (assignment == 1) {
-            unit_clauses.push_back(std::make_pair(var,true));
+    // collect the clauses of all formulas and count the variable occurences
+    left_occurence_start.assign(this->varamount+1, 0);
+    right_occurence_start.assign(this->varamount+1, 0);
+    clause_left_start.push_back(0);
+    for (const HornFormula<Dual> *formula : formulas) {
+        for (int i = 0; i < formula->get_size(); ++i) {
+            for (int var : formula->get_left_vars(i)) {
+                clause_left.push_back(var);
+                left_occurence_start[var+1]++;
+            }
+            clause_left_start.push_back(clause_left.size());
+            int right = formula->get_right(i);
+            clause_right.push_back(right);
+            if (right != -1) {
+                right_occurence_start[right+1]++;
+            }
+            leftcount.push_back(formula->get_left_vars(i).size());
+        }
+    }
+    for (int var = 0; var < this->varamount; ++var) {
+        left_occurence_start[var+1] += left_occurence_start[var];
+        right_occurence_start[var+1] += right_occurence_start[var];
+    }
+    left_occurences.resize(clause_left.size());
+    right_occurences.resize(right_occurence_start.back());
+    std::vector<int> left_pos(left_occurence_start.begin(), left_occurence_start.end()-1);
+    std::vector<int> right_pos(right_occurence_start.begin(), right_occurence_start.end()-1);
+    for (size_t clause = 0; clause < clause_right.size(); ++clause) {
+        for (int i = clause_left_start[clause]; i < clause_left_start[clause+1]; ++i) {
+            left_occurences[left_pos[clause_left[i]]++] = clause;
+        }
+        if (clause_right[clause] != -1) {
+            right_occurences[right_pos[clause_right[clause]]++] = clause;
         }
     }
 
-    for(const HornConjunctionElement &conjunct : conjuncts) {
-        int local_varamount = conjunct.formula->get_varamount();
-        total_varamount = std::max(total_varamount, local_varamount);
-        implstart.push_back(amount_implications);
-        amount_implications += conjunct.formula->get_size();
-        partial_assignment.resize(total_varamount,2);
-        leftcount.insert(leftcount.end(), conjunct.formula->get_left_sizes().begin(),
-                         conjunct.formula->get_left_sizes().end());
-        rightvars.insert(rightvars.end(), conjunct.formula->get_right_sides().begin(),
-                        conjunct.formula->get_right_sides().end());
-
-        for(int var : conjunct.formula->get_forced_false()) {
-            if (partial_assignment[var] == 1) {
-                return false;
-            }
-            unit_clauses.push_back(std::make_pair(var, false));
-            partial_assignment[var] = 0;
+    values.assign(this->varamount, 2);
+    for (const HornFormula<Dual> *formula : formulas) {
+        for (int var : formula->get_forced_false()) {
+            enqueue(var, false);
         }
-        for(int var : conjunct.formula->get_forced_true()) {
-            if (partial_assignment[var] == 0) {
-                return false;
-            }
-            unit_clauses.push_back(std::make_pair(var, true));
-            partial_assignment[var] = 1;
+        for (int var : formula->get_forced_true()) {
+            enqueue(var, true);
         }
     }
-    std::vector<bool> already_seen(total_varamount, false);
+    propagate();
+}
 
-    // unit propagation
-    while(!unit_clauses.empty()) {
-        std::pair<int,bool> unit_clause = unit_clauses.front();
-        unit_clauses.pop_front();
+void HornPropagator::enqueue(int var, bool value) {
+    if (values[var] == 2) {
+        values[var] = value;
+        trail.push_back(var);
+    } else if (values[var] != value) {
+        conflict = true;
+    }
+}
 
-        int var = unit_clause.first;
-        if (already_seen[var]) {
-            continue;
+void HornPropagator::propagate_last_left(int clause) {
+    int right = clause_right[clause];
+    // the clause still has a positive literal that can become true
+    if (right != -1 && values[right] != 0) {
+        return;
+    }
+    for (int i = clause_left_start[clause]; i < clause_left_start[clause+1]; ++i) {
+        int var = clause_left[i];
+        if (values[var] != 1) {
+            // if the variable is already false the clause is satisfied
+            enqueue(var, false);
+            return;
         }
-        int positive = unit_clause.second;
-        already_seen[var] = true;
-        // positive literal
-        if(positive) {
-            for (size_t i = 0; i < conjuncts.size(); ++i) {
-                HornConjunctionElement &conjunct = conjuncts[i];
-                if (var >= conjunct.formula->get_varamount()) {
+    }
+    // all negative literals and the positive literal are false
+    conflict = true;
+}
+
+int HornPropagator::get_varamount() const {
+    return varamount;
+}
+
+int HornPropagator::get_value(int var) const {
+    return values[var];
+}
+
+bool HornPropagator::is_satisfiable() const {
+    return !conflict;
+}
+
+void HornPropagator::assume(int var, bool value) {
+    enqueue(var, value);
+}
+
+bool HornPropagator::propagate() {
+    while (!conflict && queue_head < trail.size()) {
+        int var = trail[queue_head++];
+        if (values[var] == 1) {
+            /*
+             * All counters need to be updated even if we run into a conflict,
+             * since pop() restores them for each propagated variable.
+             */
+            for (int i = left_occurence_start[var]; i < left_occurence_start[var+1]; ++i) {
+                int clause = left_occurences[i];
+                leftcount[clause]--;
+                if (conflict) {
                     continue;
                 }
-                const std::forward_list<int> &left_occurences = conjunct.formula->get_variable_occurence_left(var);
-                const std::forward_list<int> &right_occurences = conjunct.formula->get_variable_occurence_right(var);
-                for (int left_occ : left_occurences) {
-                    int global_impl = implstart[i]+left_occ;
-                    leftcount[global_impl]--;
+                if (leftcount[clause] == 0) {
                     // deleted last negative literal --> must have positive literal
-                    if (leftcount[global_impl] == 0) {
-                        int newvar = conjunct.formula->get_right(left_occ);
-                        assert(newvar != -1);
-                        if (partial_assignment[newvar] == 0) {
-                            return false;
-                        }
-                        unit_clauses.push_back(std::make_pair(newvar, true));
-                        partial_assignment[newvar] = 1;
-                        conjunct.removed_implications[left_occ] = true;
-                    // deleted second last negative literal and no positive literal
-                    } else if (leftcount[global_impl] == 1
-                               && rightvars[global_impl] == -1) {
-                        // find corresponding variable in left
-                        int newvar = -1;
-                        for (int leftvar : conjunct.formula->get_left_vars(left_occ)) {
-                            if (partial_assignment[leftvar] != 1) {
-                                newvar = leftvar;
-                                break;
-                            }
-                        }
-                        if (newvar == -1) {
-                            return false;
-                        }
-                        unit_clauses.push_back(std::make_pair(newvar, false));
-                        partial_assignment[newvar] = 0;
-                        conjunct.removed_implications[left_occ] = true;
+                    if (clause_right[clause] == -1) {
+                        conflict = true;
+                    } else {
+                        enqueue(clause_right[clause], true);
                     }
+                } else if (leftcount[clause] == 1) {
+                    propagate_last_left(clause);
                 }
-                for(int right_occ: right_occurences) {
-                    conjunct.removed_implications[right_occ] = true;
-                }
-            } // end iterate over formulas
-        // negative literal
+            }
         } else {
-            for (size_t i = 0; i < conjuncts.size(); ++i) {
-                HornConjunctionElement &conjunct = conjuncts[i];
-                if (var >= conjunct.formula->get_varamount()) {
-                    continue;
+            for (int i = right_occurence_start[var]; i < right_occurence_start[var+1]; ++i) {
+                int clause = right_occurences[i];
+                if (leftcount[clause] == 1) {
+                    propagate_last_left(clause);
                 }
-                const std::forward_list<int> &left_occurences = conjunct.formula->get_variable_occurence_left(var);
-                const std::forward_list<int> &right_occurences = conjunct.formula->get_variable_occurence_right(var);
-                for (int left_occ : left_occurences) {
-                    conjunct.removed_implications[left_occ] = true;
+                if (conflict) {
+                    break;
                 }
-                for(int right_occ: right_occurences) {
-                    rightvars[implstart[i]+right_occ] = -1;
-                    if(leftcount[implstart[i]+right_occ] == 1) {
-                        // find corresponding variable in left
-                        int newvar = -1;
-                        for (int leftvar : conjunct.formula->get_left_vars(right_occ)) {
-                            if (partial_assignment[leftvar] != 1) {
-                                newvar = leftvar;
-                                break;
-                            }
-                        }
-                        if (newvar == -1) {
-                            return false;
-                        }
-                        unit_clauses.push_back(std::make_pair(newvar, false));
-                        partial_assignment[newvar] = 0;
-                        conjunct.removed_implications[right_occ] = true;
-                    }
+            }
+        }
+    }
+    return !conflict;
+}
+
+void HornPropagator::push() {
+    assert(conflict || queue_head == trail.size());
+    levels.push_back(std::make_pair(trail.size(), conflict));
+}
+
+void HornPropagator::pop() {
+    assert(!levels.empty());
+    size_t mark = levels.back().first;
+    for (size_t pos = trail.size(); pos > mark; --pos) {
+        int var = trail[pos-1];
+        if (pos-1 < queue_head && values[var] == 1) {
+            for (int i = left_occurence_start[var]; i < left_occurence_start[var+1]; ++i) {
+                leftcount[left_occurences[i]]++;
+            }
+        }
+        values[var] = 2;
+    }
+    trail.resize(mark);
+    queue_head = std::min(queue_head, mark);
+    conflict = levels.back().second;
+    levels.pop_back();
+}
+
+
+template<bool Dual>
+bool HornUtil<Dual>::simplify_conjunction(std::vector<HornConjunctionElement<Dual>> &conjuncts, Cube &partial_assignment) {
+    std::vector<const Formula *> formulas;
+    formulas.reserve(conjuncts.size());
+    for (const HornConjunctionElement<Dual> &conjunct : conjuncts) {
+        formulas.push_back(conjunct.formula);
+    }
+    HornPropagator propagator(formulas, partial_assignment.size());
+    for(size_t var = 0; var < partial_assignment.size(); ++var) {
+        if (partial_assignment[var] != 2) {
+            propagator.assume(var, partial_assignment[var] == 1);
+        }
+    }
+    if (!propagator.propagate()) {
+        return false;
+    }
+
+    partial_assignment.resize(propagator.get_varamount());
+    for (int var = 0; var < propagator.get_varamount(); ++var) {
+        partial_assignment[var] = propagator.get_value(var);
+    }
+    // implications that are satisfied by the assignment can be removed
+    for (HornConjunctionElement<Dual> &conjunct : conjuncts) {
+        const Formula *formula = conjunct.formula;
+        for (int i = 0; i < formula->get_size(); ++i) {
+            int right = formula->get_right(i);
+            bool satisfied = (right != -1 && partial_assignment[right] == 1);
+            for (int var : formula->get_left_vars(i)) {
+                if (satisfied) {
+                    break;
                 }
-            } // end iterate over formulas
-        } // end if else (positive or negative unit clause)
-    } // end while unit clauses not empty
+                satisfied = (partial_assignment[var] == 0);
+            }
+            conjunct.removed_implications[i] = satisfied;
+        }
+    }
     return true;
 }
 
-bool HornUtil::is_restricted_satisfiable(const SetFormulaHorn *formula, Cube &restriction) {
-    std::vector<HornConjunctionElement> vec(1,HornConjunctionElement(formula));
+template<bool Dual>
+bool HornUtil<Dual>::is_restricted_satisfiable(const Formula *formula, Cube &restriction) {
+    std::vector<HornConjunctionElement<Dual>> vec(1,HornConjunctionElement<Dual>(formula));
     return simplify_conjunction(vec, restriction);
 }
 
+template<bool Dual>
+bool HornUtil<Dual>::is_restricted_satisfiable(HornPropagator &propagator, Cube &restriction) {
+    propagator.push();
+    // variables not occuring in the propagator are unconstrained
+    int varamount = std::min<int>(restriction.size(), propagator.get_varamount());
+    for (int var = 0; var < varamount; ++var) {
+        if (restriction[var] != 2) {
+            propagator.assume(var, restriction[var] == 1);
+        }
+    }
+    bool satisfiable = propagator.propagate();
+    if (satisfiable) {
+        restriction.resize(std::max<int>(restriction.size(), propagator.get_varamount()), 2);
+        for (int var = 0; var < propagator.get_varamount(); ++var) {
+            restriction[var] = propagator.get_value(var);
+        }
+    }
+    propagator.pop();
+    return satisfiable;
+}
+
 inline bool update_current_clauses(std::vector<int> &current_clauses, std::vector<int> &clause_amount) {
     int pos_to_change = 0;
     while (current_clauses[pos_to_change] == clause_amount[pos_to_change]-1) {
@@ -240,8 +333,82 @@ inline bool update_current_clauses(std::vector<int> &current_clauses, std::vecto
 }
 
 
-bool HornUtil::conjunction_implies_disjunction(std::vector<SetFormulaHorn *> &conjuncts,
-                                               std::vector<SetFormulaHorn *> &disjuncts) {
+template<bool Dual>
+bool HornUtil<Dual>::falsify_disjuncts(HornPropagator &propagator,
+                                 const std::vector<std::vector<Literals>> &negated_clauses,
+                                 std::vector<bool> &falsified) {
+    /*
+     * Pick the open disjunct with the fewest clauses whose negation is still
+     * consistent with the current assignment. Disjuncts that are already
+     * falsified by the assignment are marked without branching.
+     */
+    int chosen = -1;
+    std::vector<int> chosen_candidates;
+    std::vector<int> newly_falsified;
+    std::vector<int> candidates;
+    for (size_t i = 0; i < negated_clauses.size(); ++i) {
+        if (falsified[i]) {
+            continue;
+        }
+        candidates.clear();
+        bool already_falsified = false;
+        for (size_t clause = 0; clause < negated_clauses[i].size(); ++clause) {
+            bool consistent = true;
+            bool holds = true;
+            for (const std::pair<int,bool> &literal : negated_clauses[i][clause]) {
+                int value = propagator.get_value(literal.first);
+                if (value == 2) {
+                    holds = false;
+                } else if (value != literal.second) {
+                    consistent = false;
+                    break;
+                }
+            }
+            if (consistent && holds) {
+                already_falsified = true;
+                break;
+            } else if (consistent) {
+                candidates.push_back(clause);
+            }
+        }
+        if (already_falsified) {
+            newly_falsified.push_back(i);
+            falsified[i] = true;
+        } else if (chosen == -1 || candidates.size() < chosen_candidates.size()) {
+            chosen = i;
+            chosen_candidates.swap(candidates);
+        }
+    }
+
+    bool found = false;
+    if (chosen == -1) {
+        // all disjuncts are falsified and the propagator has no conflict
+        found = true;
+    } else {
+        falsified[chosen] = true;
+        for (int clause : chosen_candidates) {
+            propagator.push();
+            for (const std::pair<int,bool> &literal : negated_clauses[chosen][clause]) {
+                propagator.assume(literal.first, literal.second);
+            }
+            found = propagator.propagate()
+                    && falsify_disjuncts(propagator, negated_clauses, falsified);
+            propagator.pop();
+            if (found) {
+                break;
+            }
+        }
+        falsified[chosen] = false;
+    }
+    for (int i : newly_falsified) {
+        falsified[i] = false;
+    }
+    return found;
+}
+
+template<bool Dual>
+bool HornUtil<Dual>::conjunction_implies_disjunction(std::vector<Formula *> &conjuncts,
+                                               std::vector<Formula *> &disjuncts) {
     if (conjuncts.size() == 0) {
         conjuncts.push_back(trueformula);
     }
@@ -249,9 +416,9 @@ bool HornUtil::conjunction_implies_disjunction(std::vector<SetFormulaHorn *> &co
     std::vector<int> current_clauses;
     int disj_varamount = 0;
     // iterator for removing while iterating
-    std::vector<SetFormulaHorn *>::iterator disjunct_it = disjuncts.begin();
+    typename std::vector<Formula *>::iterator disjunct_it = disjuncts.begin();
     while (disjunct_it != disjuncts.end()) {
-        SetFormulaHorn *formula = *disjunct_it;
+        Formula *formula = *disjunct_it;
         /*
          * An empty formula is equivalent to \top
          * -> return true since everything is a subset of a union containing \top
@@ -275,25 +442,60 @@ bool HornUtil::conjunction_implies_disjunction(std::vector<SetFormulaHorn *> &co
         disjunct_it++;
     }
 
-    SetFormulaHorn conjunction_dummy(task);
-    const SetFormulaHorn *conjunction = conjuncts[0];
-    if(conjuncts.size() > 1) {
-        conjunction_dummy = SetFormulaHorn(conjuncts);
-        conjunction = &conjunction_dummy;
+    // the conjunction is propagated once; each clause combination only propagates the difference
+    std::vector<const Formula *> conjunct_formulas(conjuncts.begin(), conjuncts.end());
+    HornPropagator conjunction(conjunct_formulas, disj_varamount);
+    if (!conjunction.is_satisfiable()) {
+        return true;
+    }
+    Cube conjunction_pa(conjunction.get_varamount());
+    for (size_t var = 0; var < conjunction_pa.size(); ++var) {
+        conjunction_pa[var] = conjunction.get_value(var);
     }
 
-    Cube conjunction_pa;
-    if ( !is_restricted_satisfiable(conjunction,conjunction_pa) ) {
-        return true;
+    /*
+     * For larger instances, we search for a combination of negated clauses
+     * instead of trying out all combinations.
+     */
+    long long combinations = 1;
+    for (int amount : clause_amounts) {
+        combinations *= amount;
+        if (combinations > MAX_ENUMERATED_COMBINATIONS) {
+            break;
+        }
+    }
+    if (combinations > MAX_ENUMERATED_COMBINATIONS) {
+        std::vector<std::vector<Literals>> negated_clauses(disjuncts.size());
+        for (size_t i = 0; i < disjuncts.size(); ++i) {
+            const Formula *formula = disjuncts[i];
+            negated_clauses[i].reserve(clause_amounts[i]);
+            for (int var : formula->get_forced_true()) {
+                negated_clauses[i].push_back(Literals(1, std::make_pair(var, false)));
+            }
+            for (int var : formula->get_forced_false()) {
+                negated_clauses[i].push_back(Literals(1, std::make_pair(var, true)));
+            }
+            for (int clause = 0; clause < formula->get_size(); ++clause) {
+                Literals negation;
+                for (int var : formula->get_left_vars(clause)) {
+                    negation.push_back(std::make_pair(var, true));
+                }
+                if (formula->get_right(clause) != -1) {
+                    negation.push_back(std::make_pair(formula->get_right(clause), false));
+                }
+                negated_clauses[i].push_back(std::move(negation));
+            }
+        }
+        std::vector<bool> falsified(disjuncts.size(), false);
+        return !falsify_disjuncts(conjunction, negated_clauses, falsified);
     }
-    conjunction_pa.resize(disj_varamount, 2);
 
     // try for each clause combination if its negation together with conjuncts is unsat
     do {
         bool unsatisfiable = false;
         Cube partial_assignment(disj_varamount,2);
         for (size_t i = 0; i < current_clauses.size(); ++i) {
-            const SetFormulaHorn *formula = disjuncts[i];
+            const Formula *formula = disjuncts[i];
             int clausenum = current_clauses[i];
             if (clausenum < formula->get_forced_true().size()) {
                 int forced_true = formula->get_forced_true().at(clausenum);
@@ -353,10 +555,12 @@ bool HornUtil::conjunction_implies_disjunction(std::vector<SetFormulaHorn *> &co
     return true;
 }
 
-HornUtil *SetFormulaHorn::util = nullptr;
+template<bool Dual>
+HornUtil<Dual> *HornFormula<Dual>::util = nullptr;
 
-SetFormulaHorn::SetFormulaHorn(const std::vector<std::pair<std::vector<int>, int> > &clauses, int varamount)
-    : variable_occurences(varamount), varamount(varamount) {
+template<bool Dual>
+HornFormula<Dual>::HornFormula(const std::vector<std::pair<std::vector<int>, int> > &clauses, int varamount)
+    : varamount(varamount) {
 
     for(auto clause : clauses) {
         if (clause.first.size() == 0) {
@@ -369,14 +573,9 @@ SetFormulaHorn::SetFormulaHorn(const std::vector<std::pair<std::vector<int>, int
         }
         left_vars.push_back(clause.first);
         right_side.push_back(clause.second);
-        for(int var : clause.first) {
-            variable_occurences[var].first.push_front(left_vars.size()-1);
-        }
-        if(clause.second != -1) {
-            variable_occurences[clause.second].second.push_front(left_vars.size()-1);
-        }
         left_sizes.push_back(clause.first.size());
     }
+    build_occurences();
     simplify();
     varorder.reserve(varamount);
     for (size_t var = 0; var < varamount; ++var) {
@@ -384,20 +583,18 @@ SetFormulaHorn::SetFormulaHorn(const std::vector<std::pair<std::vector<int>, int
     }
 }
 
-SetFormulaHorn::SetFormulaHorn(std::vector<SetFormulaHorn *> &formulas) {
-    std::vector<HornConjunctionElement> elements;
+template<bool Dual>
+HornFormula<Dual>::HornFormula(std::vector<HornFormula *> &formulas) {
+    std::vector<HornConjunctionElement<Dual>> elements;
     elements.reserve(formulas.size());
-    for (SetFormulaHorn *f : formulas) {
-        elements.emplace_back(HornConjunctionElement(f));
+    for (HornFormula *f : formulas) {
+        elements.emplace_back(HornConjunctionElement<Dual>(f));
     }
     Cube partial_assignments;
     bool satisfiable = util->simplify_conjunction(elements, partial_assignments);
     varamount = partial_assignments.size();
-    variable_occurences.resize(varamount);
 
     if (!satisfiable) {
-        variable_occurences.clear();
-        variable_occurences.resize(varamount);
         forced_true.clear();
         forced_true.push_back(0);
         forced_false.clear();
@@ -412,7 +609,7 @@ SetFormulaHorn::SetFormulaHorn(std::vector<SetFormulaHorn *> &formulas) {
             }
         }
         int implication_amount = 0;
-        for (HornConjunctionElement elem : elements) {
+        for (HornConjunctionElement<Dual> elem : elements) {
             for (bool val : elem.removed_implications) {
                 if (!val) {
                     implication_amount++;
@@ -424,7 +621,7 @@ SetFormulaHorn::SetFormulaHorn(std::vector<SetFormulaHorn *> &formulas) {
         right_side.reserve(implication_amount);
 
         // iterate over all formulas and insert each simplified clause one by one
-        for (HornConjunctionElement elem : elements) {
+        for (HornConjunctionElement<Dual> elem : elements) {
             // iterate over all implications of the current formula
             for (int i = 0; i < elem.formula->get_size(); ++i) {
                 // implication is removed - jump over it
@@ -438,7 +635,6 @@ SetFormulaHorn::SetFormulaHorn(std::vector<SetFormulaHorn *> &formulas) {
                         continue;
                     }
                     left.push_back(var);
-                    variable_occurences[var].first.push_front(left_vars.size());
                 }
                 left_sizes.push_back(left.size());
                 left_vars.push_back(std::move(left));
@@ -452,33 +648,31 @@ SetFormulaHorn::SetFormulaHorn(std::vector<SetFormulaHorn *> &formulas) {
                 if(partial_assignments[right_var] != 2) {
                     right_side.push_back(-1);
                 } else {
-                    variable_occurences[right_var].second.push_front(right_side.size());
                     right_side.push_back(right_var);
                 }
             } // end iterate over implications of the current formula
         } // end iterate over all formulas
     } // end else block of !satisfiable
+    build_occurences();
     varorder.reserve(varamount);
     for (size_t var = 0; var < varamount; ++var) {
         varorder.push_back(var);
     }
 }
 
-SetFormulaHorn::SetFormulaHorn(const SetFormulaHorn &other, const Action &action, bool progression)
+template<bool Dual>
+HornFormula<Dual>::HornFormula(const HornFormula &other, const Action &action, bool progression)
     : left_vars(other.left_vars), left_sizes(other.left_sizes), right_side(other.right_side),
       forced_true(other.forced_true), forced_false(other.forced_false), varamount(2*action.change.size()) {
-    variable_occurences.resize(action.change.size()*2);
 
     if (progression) {
         for (int var : action.pre) {
-            forced_true.push_back(var);
+            add_unit_clause(var, true);
         }
     } else {
         for (size_t var = 0; var < action.change.size(); ++var) {
-            if (action.change[var] == 1) {
-                forced_true.push_back(var);
-            } else if (action.change[var] == -1) {
-                forced_false.push_back(var);
+            if (action.change[var] != 0) {
+                add_unit_clause(var, action.change[var] == 1);
             }
         }
     }
@@ -494,15 +688,10 @@ SetFormulaHorn::SetFormulaHorn(const SetFormulaHorn &other, const Action &action
             forced_false[i] += action.change.size();
         }
     }
-    for (size_t var = 0; var < other.variable_occurences.size(); ++var) {
-        if (action.change[var] == 0) {
-            variable_occurences[var].first = other.variable_occurences[var].first;
-            variable_occurences[var].second = other.variable_occurences[var].second;
-        } else {
+    for (int var = 0; var < other.varamount; ++var) {
+        if (action.change[var] != 0) {
             //shift vars
-            variable_occurences[var + action.change.size()].first = other.variable_occurences[var].first;
-            variable_occurences[var + action.change.size()].second = other.variable_occurences[var].second;
-            for (int impl : other.variable_occurences[var].first) {
+            for (int impl : other.get_variable_occurence_left(var)) {
                 for (size_t i = 0; i < left_vars[impl].size(); ++i) {
                     if (left_vars[impl][i] == var) {
                         left_vars[impl][i] += action.change.size();
@@ -510,7 +699,7 @@ SetFormulaHorn::SetFormulaHorn(const SetFormulaHorn &other, const Action &action
                     }
                 }
             }
-            for (int impl : other.variable_occurences[var].second) {
+            for (int impl : other.get_variable_occurence_right(var)) {
                 right_side[impl] += action.change.size();
             }
         }
@@ -519,18 +708,17 @@ SetFormulaHorn::SetFormulaHorn(const SetFormulaHorn &other, const Action &action
     // apply actions
     if (progression) {
         for (size_t var = 0; var < action.change.size(); ++var) {
-            if (action.change[var] == 1) {
-                forced_true.push_back(var);
-            } else if (action.change[var] == -1) {
-                forced_false.push_back(var);
+            if (action.change[var] != 0) {
+                add_unit_clause(var, action.change[var] == 1);
             }
         }
     } else {
         for (int var : action.pre) {
-            forced_true.push_back(var);
+            add_unit_clause(var, true);
         }
     }
 
+    build_occurences();
     simplify();
     varorder.clear();
     varorder.resize(varamount);
@@ -540,13 +728,24 @@ SetFormulaHorn::SetFormulaHorn(const SetFormulaHorn &other, const Action &action
 }
 
 
-SetFormulaHorn::SetFormulaHorn(Task *task) {
+template<bool Dual>
+void HornFormula<Dual>::add_unit_clause(int var, bool value) {
+    if (HornPolarity<Dual>::internal(value)) {
+        forced_true.push_back(var);
+    } else {
+        forced_false.push_back(var);
+    }
+}
+
+template<bool Dual>
+HornFormula<Dual>::HornFormula(Task *task) {
     if (util == nullptr) {
-        util = new HornUtil(task);
+        util = new HornUtil<Dual>(task);
     }
 }
 
-SetFormulaHorn::SetFormulaHorn(std::ifstream &input, Task *task) {
+template<bool Dual>
+HornFormula<Dual>::HornFormula(std::istream &input, Task *task) {
     // parsing
     std::string word;
     int clausenum;
@@ -562,57 +761,49 @@ SetFormulaHorn::SetFormulaHorn(std::ifstream &input, Task *task) {
     }
     input >> varamount;
     input >> clausenum;
-    variable_occurences.resize(varamount);
 
-    int count = 0;
     for(int i = 0; i < clausenum; ++i) {
         int var;
         input >> var;
         std::vector<int> left;
         int right = -1;
         while(var != 0) {
-            if (var < 0) {
-                left.push_back(-1-var);
+            if (!HornPolarity<Dual>::internal(var > 0)) {
+                left.push_back(std::abs(var)-1);
             } else {
                 if (right != -1) {
-                    std::cerr << "Invalid Horn formula" << std::endl;
+                    std::cerr << "Invalid " << HornPolarity<Dual>::name() << " formula" << std::endl;
                     exit_with(ExitCode::CRITICAL_ERROR);
                 }
-                right = var-1;
+                right = std::abs(var)-1;
             }
             input >> var;
         }
         if (left.size() == 0) {
             if (right == -1) {
-                std::cerr << "Invalid Horn formula" << std::endl;
+                std::cerr << "Invalid " << HornPolarity<Dual>::name() << " formula" << std::endl;
                 exit_with(ExitCode::CRITICAL_ERROR);
             }
             forced_true.push_back(right);
         } else if (left.size() == 1 && right == -1) {
             forced_false.push_back(left[0]);
         } else {
-            for (int var : left) {
-                variable_occurences[var].first.push_front(count);
-            }
-            if (right != -1) {
-                variable_occurences[var].second.push_front(count);
-            }
             left_sizes.push_back(left.size());
             left_vars.push_back(std::move(left));
             right_side.push_back(right);
-            count++;
         }
     }
     input >> word;
     if(word.compare(";") != 0) {
-        std::cerr << "HornFormula syntax wrong" << std::endl;
+        std::cerr << HornPolarity<Dual>::name() << "Formula syntax wrong" << std::endl;
         exit_with(ExitCode::CRITICAL_ERROR);
     }
 
-    // create util if this is the first horn formula
+    // create util if this is the first formula of this polarity
     if (util == nullptr) {
-        util = new HornUtil(task);
+        util = new HornUtil<Dual>(task);
     }
+    build_occurences();
     simplify();
 
     varorder.reserve(varamount);
@@ -621,17 +812,17 @@ SetFormulaHorn::SetFormulaHorn(std::ifstream &input, Task *task) {
     }
 }
 
-void SetFormulaHorn::simplify() {
+template<bool Dual>
+void HornFormula<Dual>::simplify() {
     // call simplify_conjunction to get a partial assignment and implications to remove
-    std::vector<HornConjunctionElement> tmpvec(1,HornConjunctionElement(this));
+    std::vector<HornConjunctionElement<Dual>> tmpvec(1,HornConjunctionElement<Dual>(this));
     Cube assignments(varamount, 2);
     bool satisfiable = util->simplify_conjunction(tmpvec, assignments);
 
     if(!satisfiable) {
         left_vars.clear();
+        left_sizes.clear();
         right_side.clear();
-        variable_occurences.clear();
-        variable_occurences.resize(varamount);
         forced_true.clear();
         forced_true.push_back(0);
         forced_false.clear();
@@ -647,13 +838,13 @@ void SetFormulaHorn::simplify() {
                 continue;
             }
             // assigned - remove from implications
-            for(int impl : variable_occurences[var].first) {
+            for(int impl : get_variable_occurence_left(var)) {
                 left_sizes[impl]--;
                 left_vars[impl].erase(std::remove(left_vars[impl].begin(),
                                                   left_vars[impl].end(), var),
                                       left_vars[impl].end());
             }
-            for(int impl : variable_occurences[var].second) {
+            for(int impl : get_variable_occurence_right(var)) {
                 right_side[impl] = -1;
             }
             if (assignments[var] == 0) {
@@ -702,64 +893,98 @@ void SetFormulaHorn::simplify() {
         left_sizes.shrink_to_fit();
 
     }
-    variable_occurences.clear();
-    variable_occurences.resize(varamount);
+    build_occurences();
+}
+
+template<bool Dual>
+void HornFormula<Dual>::build_occurences() {
+    left_occurence_start.assign(varamount+1, 0);
+    right_occurence_start.assign(varamount+1, 0);
     for (size_t i = 0; i < left_vars.size(); ++i) {
         for (int var : left_vars[i]) {
-            variable_occurences[var].first.push_front(i);
+            left_occurence_start[var+1]++;
         }
-        int var = right_side[i];
-        if (var != -1) {
-            variable_occurences[var].second.push_front(i);
+        if (right_side[i] != -1) {
+            right_occurence_start[right_side[i]+1]++;
+        }
+    }
+    for (int var = 0; var < varamount; ++var) {
+        left_occurence_start[var+1] += left_occurence_start[var];
+        right_occurence_start[var+1] += right_occurence_start[var];
+    }
+    left_occurences.resize(left_occurence_start.back());
+    right_occurences.resize(right_occurence_start.back());
+    std::vector<int> left_pos(left_occurence_start.begin(), left_occurence_start.end()-1);
+    std::vector<int> right_pos(right_occurence_start.begin(), right_occurence_start.end()-1);
+    for (size_t i = 0; i < left_vars.size(); ++i) {
+        for (int var : left_vars[i]) {
+            left_occurences[left_pos[var]++] = i;
+        }
+        if (right_side[i] != -1) {
+            right_occurences[right_pos[right_side[i]]++] = i;
         }
     }
 }
 
-const std::forward_list<int> &SetFormulaHorn::get_variable_occurence_left(int var) const {
-    return variable_occurences[var].first;
+template<bool Dual>
+OccurenceRange HornFormula<Dual>::get_variable_occurence_left(int var) const {
+    return OccurenceRange{left_occurences.data() + left_occurence_start[var],
+                          left_occurences.data() + left_occurence_start[var+1]};
 }
 
-const std::forward_list<int> &SetFormulaHorn::get_variable_occurence_right(int var) const {
-    return variable_occurences[var].second;
+template<bool Dual>
+OccurenceRange HornFormula<Dual>::get_variable_occurence_right(int var) const {
+    return OccurenceRange{right_occurences.data() + right_occurence_start[var],
+                          right_occurences.data() + right_occurence_start[var+1]};
 }
 
-int SetFormulaHorn::get_size() const {
+template<bool Dual>
+int HornFormula<Dual>::get_size() const {
     return left_vars.size();
 }
 
-int SetFormulaHorn::get_varamount() const {
+template<bool Dual>
+int HornFormula<Dual>::get_varamount() const {
     return varamount;
 }
 
-int SetFormulaHorn::get_left(int index) const{
+template<bool Dual>
+int HornFormula<Dual>::get_left(int index) const{
     return left_sizes[index];
 }
 
-const std::vector<int> &SetFormulaHorn::get_left_sizes() const {
+template<bool Dual>
+const std::vector<int> &HornFormula<Dual>::get_left_sizes() const {
     return left_sizes;
 }
 
-int SetFormulaHorn::get_right(int index) const {
+template<bool Dual>
+int HornFormula<Dual>::get_right(int index) const {
     return right_side[index];
 }
 
-const std::vector<int> &SetFormulaHorn::get_right_sides() const {
+template<bool Dual>
+const std::vector<int> &HornFormula<Dual>::get_right_sides() const {
     return right_side;
 }
 
-const std::vector<int> &SetFormulaHorn::get_forced_true() const {
+template<bool Dual>
+const std::vector<int> &HornFormula<Dual>::get_forced_true() const {
     return forced_true;
 }
 
-const std::vector<int> &SetFormulaHorn::get_forced_false() const {
+template<bool Dual>
+const std::vector<int> &HornFormula<Dual>::get_forced_false() const {
     return forced_false;
 }
 
-const std::vector<int> &SetFormulaHorn::get_left_vars(int index) const {
+template<bool Dual>
+const std::vector<int> &HornFormula<Dual>::get_left_vars(int index) const {
     return left_vars[index];
 }
 
-void SetFormulaHorn::dump() const{
+template<bool Dual>
+void HornFormula<Dual>::dump() const{
     std::cout << "forced true: ";
     for(int i = 0; i < forced_true.size(); ++i) {
         std::cout << forced_true[i] << " ";
@@ -777,13 +1002,13 @@ void SetFormulaHorn::dump() const{
     }
     std::cout << std::endl;
     std::cout << "occurences: ";
-    for(int i = 0; i < variable_occurences.size(); ++i) {
+    for(int i = 0; i < varamount; ++i) {
         std::cout << "[" << i << ":";
-        for(auto elem : variable_occurences[i].first) {
+        for(auto elem : get_variable_occurence_left(i)) {
             std::cout << elem << " ";
         }
         std::cout << "|";
-        for(auto elem : variable_occurences[i].second) {
+        for(auto elem : get_variable_occurence_right(i)) {
             std::cout << elem << " ";
         }
         std::cout << "] ";
@@ -791,11 +1016,12 @@ void SetFormulaHorn::dump() const{
     std::cout << std::endl;
 }
 
-bool SetFormulaHorn::is_subset(std::vector<SetFormula *> &left,
+template<bool Dual>
+bool HornFormula<Dual>::is_subset(std::vector<SetFormula *> &left,
                                std::vector<SetFormula *> &right) {
 
-    std::vector<SetFormulaHorn *> horn_formulas_left;
-    std::vector<SetFormulaHorn *> horn_formulas_right;
+    std::vector<HornFormula *> horn_formulas_left;
+    std::vector<HornFormula *> horn_formulas_right;
     bool valid_horn_formulas = util->get_horn_vector(left,horn_formulas_left)
             && util->get_horn_vector(right, horn_formulas_right);
     if(!valid_horn_formulas) {
@@ -804,13 +1030,14 @@ bool SetFormulaHorn::is_subset(std::vector<SetFormula *> &left,
     return util->conjunction_implies_disjunction(horn_formulas_left, horn_formulas_right);
 }
 
-bool SetFormulaHorn::is_subset_with_progression(std::vector<SetFormula *> &left,
+template<bool Dual>
+bool HornFormula<Dual>::is_subset_with_progression(std::vector<SetFormula *> &left,
                                                 std::vector<SetFormula *> &right,
                                                 std::vector<SetFormula *> &prog,
-                                                std::unordered_set<int> &actions) {
-    std::vector<SetFormulaHorn *> horn_formulas_left;
-    std::vector<SetFormulaHorn *> horn_formulas_right;
-    std::vector<SetFormulaHorn *> horn_formulas_prog;
+                                                const std::unordered_set<int> &actions) {
+    std::vector<HornFormula *> horn_formulas_left;
+    std::vector<HornFormula *> horn_formulas_right;
+    std::vector<HornFormula *> horn_formulas_prog;
     bool valid_horn_formulas = util->get_horn_vector(left,horn_formulas_left)
             && util->get_horn_vector(right, horn_formulas_right)
             && util->get_horn_vector(prog, horn_formulas_prog);
@@ -818,31 +1045,31 @@ bool SetFormulaHorn::is_subset_with_progression(std::vector<SetFormula *> &left,
         return false;
     }
 
-    SetFormulaHorn *prog_singular;
-    SetFormulaHorn prog_dummy(util->task);
+    HornFormula *prog_singular;
+    HornFormula prog_dummy(util->task);
     if (horn_formulas_prog.size() > 1) {
-        prog_dummy = SetFormulaHorn(horn_formulas_prog);
+        prog_dummy = HornFormula(horn_formulas_prog);
         prog_singular = &prog_dummy;
     } else {
         prog_singular = horn_formulas_prog[0];
     }
-    SetFormulaHorn *left_singular = nullptr;
-    SetFormulaHorn left_dummy(util->task);
+    HornFormula *left_singular = nullptr;
+    HornFormula left_dummy(util->task);
     if (!horn_formulas_left.empty()) {
         if (horn_formulas_left.size() > 1) {
-            left_dummy = SetFormulaHorn(horn_formulas_left);
+            left_dummy = HornFormula(horn_formulas_left);
             left_singular = &left_dummy;
         } else {
             left_singular = horn_formulas_left[0];
         }
     }
 
-    std::vector<SetFormulaHorn *> vec;
+    std::vector<HornFormula *> vec;
     if (left_singular) {
         vec.push_back(left_singular);
     }
     for (int a : actions) {
-        SetFormulaHorn prog_applied(*prog_singular, util->task->get_action(a), true);
+        HornFormula prog_applied(*prog_singular, util->task->get_action(a), true);
         vec.push_back(&prog_applied);
         if (!util->conjunction_implies_disjunction(vec, horn_formulas_right)) {
             return false;
@@ -852,13 +1079,14 @@ bool SetFormulaHorn::is_subset_with_progression(std::vector<SetFormula *> &left,
     return true;
 }
 
-bool SetFormulaHorn::is_subset_with_regression(std::vector<SetFormula *> &left,
+template<bool Dual>
+bool HornFormula<Dual>::is_subset_with_regression(std::vector<SetFormula *> &left,
                                                std::vector<SetFormula *> &right,
                                                std::vector<SetFormula *> &reg,
-                                               std::unordered_set<int> &actions) {
-    std::vector<SetFormulaHorn *> horn_formulas_left;
-    std::vector<SetFormulaHorn *> horn_formulas_right;
-    std::vector<SetFormulaHorn *> horn_formulas_reg;
+                                               const std::unordered_set<int> &actions) {
+    std::vector<HornFormula *> horn_formulas_left;
+    std::vector<HornFormula *> horn_formulas_right;
+    std::vector<HornFormula *> horn_formulas_reg;
     bool valid_horn_formulas = util->get_horn_vector(left,horn_formulas_left)
             && util->get_horn_vector(right, horn_formulas_right)
             && util->get_horn_vector(reg, horn_formulas_reg);
@@ -866,31 +1094,31 @@ bool SetFormulaHorn::is_subset_with_regression(std::vector<SetFormula *> &left,
         return false;
     }
 
-    SetFormulaHorn *reg_singular;
-    SetFormulaHorn reg_dummy(util->task);
+    HornFormula *reg_singular;
+    HornFormula reg_dummy(util->task);
     if (horn_formulas_reg.size() > 1) {
-        reg_dummy = SetFormulaHorn(horn_formulas_reg);
+        reg_dummy = HornFormula(horn_formulas_reg);
         reg_singular = &reg_dummy;
     } else {
         reg_singular = horn_formulas_reg[0];
     }
-    SetFormulaHorn *left_singular = nullptr;
-    SetFormulaHorn left_dummy(util->task);
+    HornFormula *left_singular = nullptr;
+    HornFormula left_dummy(util->task);
     if (!horn_formulas_left.empty()) {
         if (horn_formulas_left.size() > 1) {
-            left_dummy = SetFormulaHorn(horn_formulas_left);
+            left_dummy = HornFormula(horn_formulas_left);
             left_singular = &left_dummy;
         } else {
             left_singular = horn_formulas_left[0];
         }
     }
 
-    std::vector<SetFormulaHorn *> vec;
+    std::vector<HornFormula *> vec;
     if (left_singular) {
         vec.push_back(left_singular);
     }
     for (int a : actions) {
-        SetFormulaHorn reg_applied(*reg_singular, util->task->get_action(a), false);
+        HornFormula reg_applied(*reg_singular, util->task->get_action(a), false);
         vec.push_back(&reg_applied);
         if (!util->conjunction_implies_disjunction(vec, horn_formulas_right)) {
             return false;
@@ -900,7 +1128,8 @@ bool SetFormulaHorn::is_subset_with_regression(std::vector<SetFormula *> &left,
     return true;
 }
 
-bool SetFormulaHorn::is_subset_of(SetFormula *superset, bool left_positive, bool right_positive) {
+template<bool Dual>
+bool HornFormula<Dual>::is_subset_of(SetFormula *superset, bool left_positive, bool right_positive) {
     if (left_positive && right_positive) {
         if (superset->supports_cnf_enumeration()) {
             int count = 0;
@@ -935,7 +1164,9 @@ bool SetFormulaHorn::is_subset_of(SetFormula *superset, bool left_positive, bool
             std::vector<bool> mark(varorder.size(),false);
             std::vector<int> old_solution(varorder.size(),2);
 
-            bool solution_found = util->is_restricted_satisfiable(this, old_solution);
+            std::vector<const HornFormula *> formula_vec(1, this);
+            HornPropagator propagator(formula_vec, varamount);
+            bool solution_found = util->is_restricted_satisfiable(propagator, old_solution);
             while(solution_found) {
                 for(size_t i = 0; i < old_solution.size(); ++i) {
                     if(old_solution[i] == 2) {
@@ -944,11 +1175,7 @@ bool SetFormulaHorn::is_subset_of(SetFormula *superset, bool left_positive, bool
                 }
 
                 for (size_t i = 0; i < varorder.size(); ++i) {
-                    if (old_solution[i] == 1) {
-                        model[var_transform[i]] = true;
-                    } else {
-                        model[var_transform[i]] = false;
-                    }
+                    model[var_transform[i]] = HornPolarity<Dual>::internal(old_solution[i] == 1);
                 }
 
                 for (int count = 0; count < (1 << vars_to_fill.size()); ++count) {
@@ -962,10 +1189,10 @@ bool SetFormulaHorn::is_subset_of(SetFormula *superset, bool left_positive, bool
 
                 // get next solution
                 solution_found = false;
-                for(size_t i = varorder.size()-1; i >= 0; --i) {
+                for(int i = varorder.size()-1; i >= 0; --i) {
                     if (!mark[i]) {
                         old_solution[i] = 1 - old_solution[i];
-                        if (util->is_restricted_satisfiable(this, old_solution)) {
+                        if (util->is_restricted_satisfiable(propagator, old_solution)) {
                             solution_found = true;
                             mark[i] = true;
                             for (int j = i+1; j < mark.size(); ++j) {
@@ -994,16 +1221,18 @@ bool SetFormulaHorn::is_subset_of(SetFormula *superset, bool left_positive, bool
         }
     } else if (!left_positive && right_positive) {
         if (superset->supports_implicant_check()) {
+            // the implicants are the negated clauses, translated to the polarity of the formula
+            const bool internal_true = HornPolarity<Dual>::internal(true);
             std::vector<int> vars(1,-1);
             std::vector<bool> implicant;
-            implicant.push_back(true);
+            implicant.push_back(internal_true);
             for (int var : forced_false) {
                 vars[0] = var;
                 if (!superset->is_implicant(vars, implicant)) {
                     return false;
                 }
             }
-            implicant[0] = false;
+            implicant[0] = !internal_true;
             for (int var : forced_true) {
                 vars[0] = var;
                 if (!superset->is_implicant(vars, implicant)) {
@@ -1015,11 +1244,11 @@ bool SetFormulaHorn::is_subset_of(SetFormula *superset, bool left_positive, bool
                 implicant.clear();
                 for (int var : left_vars[i]) {
                     vars.push_back(var);
-                    implicant.push_back(true);
+                    implicant.push_back(internal_true);
                 }
                 if (right_side[i] != -1) {
                     vars.push_back(right_side[i]);
-                    implicant.push_back(false);
+                    implicant.push_back(!internal_true);
                 }
                 if (!superset->is_implicant(vars, implicant)) {
                     return false;
@@ -1038,11 +1267,13 @@ bool SetFormulaHorn::is_subset_of(SetFormula *superset, bool left_positive, bool
 }
 
 
-SetFormulaType SetFormulaHorn::get_formula_type() {
-    return SetFormulaType::HORN;
+template<bool Dual>
+SetFormulaType HornFormula<Dual>::get_formula_type() {
+    return HornPolarity<Dual>::type;
 }
 
-SetFormulaBasic *SetFormulaHorn::get_constant_formula(SetFormulaConstant *c_formula) {
+template<bool Dual>
+SetFormulaBasic *HornFormula<Dual>::get_constant_formula(SetFormulaConstant *c_formula) {
     switch(c_formula->get_constant_type()) {
     case ConstantType::EMPTY:
         return util->emptyformula;
@@ -1061,14 +1292,16 @@ SetFormulaBasic *SetFormulaHorn::get_constant_formula(SetFormulaConstant *c_form
 }
 
 
-const std::vector<int> &SetFormulaHorn::get_varorder() {
+template<bool Dual>
+const std::vector<int> &HornFormula<Dual>::get_varorder() {
     return varorder;
 }
 
-bool SetFormulaHorn::is_contained(const std::vector<bool> &model) const {
+template<bool Dual>
+bool HornFormula<Dual>::is_contained(const std::vector<bool> &model) const {
     Cube cube(varamount, 2);
     for (size_t i = 0; i < model.size(); ++i) {
-        if(model[i]) {
+        if(HornPolarity<Dual>::internal(model[i])) {
             cube[i] = 1;
         } else {
             cube[i] = 0;
@@ -1077,40 +1310,41 @@ bool SetFormulaHorn::is_contained(const std::vector<bool> &model) const {
     return util->is_restricted_satisfiable(this, cube);
 }
 
-bool SetFormulaHorn::is_implicant(const std::vector<int> &varorder, const std::vector<bool> &implicant) {
-    std::vector<std::pair<std::vector<int>,int>> clauses(varorder.size());
+template<bool Dual>
+bool HornFormula<Dual>::is_implicant(const std::vector<int> &varorder, const std::vector<bool> &implicant) {
+    std::vector<std::pair<std::vector<int>,int>> clauses;
+    clauses.reserve(varorder.size());
     for (size_t i = 0; i < varorder.size(); ++i) {
-        if(implicant[i]) {
-            clauses.push_back(std::make_pair(std::vector<int>(),varorder[i]));
-        } else {
-            clauses.push_back(std::make_pair(std::vector<int>(1,varorder[i]),-1));
-        }
+        clauses.push_back(util->unit_clause(varorder[i], implicant[i]));
     }
-    SetFormulaHorn implicant_horn(clauses, util->task->get_number_of_facts());
-    std::vector<SetFormulaHorn *>left,right;
+    HornFormula implicant_horn(clauses, util->task->get_number_of_facts());
+    std::vector<HornFormula *>left,right;
     left.push_back(&implicant_horn);
     right.push_back(this);
     return util->conjunction_implies_disjunction(left, right);
 }
 
-bool SetFormulaHorn::is_entailed(const std::vector<int> &varorder, const std::vector<bool> &clause) {
+template<bool Dual>
+bool HornFormula<Dual>::is_entailed(const std::vector<int> &varorder, const std::vector<bool> &clause) {
+    // the clause is entailed if the formula has no model falsifying it
     Cube cube(varamount, 2);
     for (size_t i = 0; i < clause.size(); ++i) {
-        if(clause[i]) {
+        if(HornPolarity<Dual>::internal(clause[i])) {
             cube[varorder[i]] = 0;
         } else {
             cube[varorder[i]] = 1;
         }
     }
-    return util->is_restricted_satisfiable(this, cube);
+    return !util->is_restricted_satisfiable(this, cube);
 }
 
-bool SetFormulaHorn::get_clause(int i, std::vector<int> &vars, std::vector<bool> &clause) {
+template<bool Dual>
+bool HornFormula<Dual>::get_clause(int i, std::vector<int> &vars, std::vector<bool> &clause) {
     if(i < forced_true.size()) {
         vars.clear();
         clause.clear();
         vars.push_back(forced_true[i]);
-        clause.push_back(true);
+        clause.push_back(HornPolarity<Dual>::internal(true));
         return true;
     }
 
@@ -1119,7 +1353,7 @@ bool SetFormulaHorn::get_clause(int i, std::vector<int> &vars, std::vector<bool>
         vars.clear();
         clause.clear();
         vars.push_back(forced_false[i]);
-        clause.push_back(false);
+        clause.push_back(HornPolarity<Dual>::internal(false));
         return true;
     }
 
@@ -1129,11 +1363,11 @@ bool SetFormulaHorn::get_clause(int i, std::vector<int> &vars, std::vector<bool>
         clause.clear();
         for (int var : left_vars[i]) {
             vars.push_back(var);
-            clause.push_back(false);
+            clause.push_back(HornPolarity<Dual>::internal(false));
         }
         if (right_side[i] != -1) {
             vars.push_back(right_side[i]);
-            clause.push_back(true);
+            clause.push_back(HornPolarity<Dual>::internal(true));
         }
         return true;
 
@@ -1141,7 +1375,13 @@ bool SetFormulaHorn::get_clause(int i, std::vector<int> &vars, std::vector<bool>
     return false;
 }
 
-int SetFormulaHorn::get_model_count() {
-    std::cerr << "Horn Formula does not support model count";
+template<bool Dual>
+int HornFormula<Dual>::get_model_count() {
+    std::cerr << HornPolarity<Dual>::name() << " Formula does not support model count";
     exit_with(ExitCode::CRITICAL_ERROR);
 }
+
+template class HornFormula<false>;
+template class HornFormula<true>;
+template class HornUtil<false>;
+template class HornUtil<true>;
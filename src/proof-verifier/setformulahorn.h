@@ -1,47 +1,149 @@
 #ifndef SETFORMULAHORN_H
 #define SETFORMULAHORN_H
 
-#include <forward_list>
 #include <unordered_set>
 
 #include "setformulabasic.h"
 #include "task.h"
 
-class SetFormulaHorn;
+/*
+ * Horn formulas (each clause has at most one positive literal) and dual Horn
+ * formulas (each clause has at most one negative literal) share one
+ * implementation: a dual Horn formula is stored as the Horn formula over the
+ * negated variables. Propagation, simplification and all subset checks work on
+ * these internal Horn clauses. Only the translation between the clauses and the
+ * states they represent depends on the polarity, which is given by HornPolarity.
+ */
+template<bool Dual>
+struct HornPolarity;
+
+template<>
+struct HornPolarity<false> {
+    static const SetFormulaType type = SetFormulaType::HORN;
+    static const char *name() { return "Horn"; }
+    // the value of a variable in the internal clauses (and vice versa)
+    static bool internal(bool value) { return value; }
+};
+
+template<>
+struct HornPolarity<true> {
+    static const SetFormulaType type = SetFormulaType::DUALHORN;
+    static const char *name() { return "DualHorn"; }
+    static bool internal(bool value) { return !value; }
+};
 
+template<bool Dual>
+class HornFormula;
+
+typedef HornFormula<false> SetFormulaHorn;
+typedef HornFormula<true> SetFormulaDualHorn;
+
+template<bool Dual>
 struct HornConjunctionElement {
-    const SetFormulaHorn *formula;
+    const HornFormula<Dual> *formula;
     std::vector<bool> removed_implications;
 
-    HornConjunctionElement(const SetFormulaHorn *formula);
+    HornConjunctionElement(const HornFormula<Dual> *formula);
 };
 
-typedef std::vector<std::pair<const SetFormulaHorn *,bool>> HornFormulaList;
-typedef std::vector<std::pair<std::forward_list<int>,std::forward_list<int>>> VariableOccurences;
+// the clauses in which a variable occurs, as a range in a flat occurence array
+struct OccurenceRange {
+    const int *first;
+    const int *last;
+    const int *begin() const { return first; }
+    const int *end() const { return last; }
+};
 
+/*
+ * Unit propagation over a fixed conjunction of Horn formulas. The clauses of
+ * all formulas are stored in flat arrays, and for each clause we count how many
+ * of its negative literals are not yet falsified (ie the variable is not yet
+ * set to true). Assignments are recorded on a trail, such that all assignments
+ * made after a push can be undone by pop. This allows to check many partial
+ * assignments against the same conjunction while only propagating the
+ * difference to the assignment at the time of the push.
+ */
+class HornPropagator {
+private:
+    int varamount;
+    std::vector<int> clause_left_start;
+    std::vector<int> clause_left;
+    std::vector<int> clause_right;
+    std::vector<int> left_occurence_start;
+    std::vector<int> left_occurences;
+    std::vector<int> right_occurence_start;
+    std::vector<int> right_occurences;
+
+    std::vector<int> leftcount;
+    // 0 = false, 1 = true, 2 = unassigned
+    std::vector<int> values;
+    std::vector<int> trail;
+    // trail entries before queue_head have been propagated
+    size_t queue_head;
+    bool conflict;
+    std::vector<std::pair<size_t,bool>> levels;
+
+    void enqueue(int var, bool value);
+    // called when only one negative literal of the clause is left
+    void propagate_last_left(int clause);
+public:
+    template<bool Dual>
+    HornPropagator(const std::vector<const HornFormula<Dual> *> &formulas, int varamount);
+
+    int get_varamount() const;
+    int get_value(int var) const;
+    // false if the conjunction (with the current assumptions) is unsatisfiable
+    bool is_satisfiable() const;
+    // add an assumption; it is only propagated by the next call to propagate()
+    void assume(int var, bool value);
+    bool propagate();
+    // remember the current (propagated) assignment
+    void push();
+    // undo all assumptions and propagations since the last push
+    void pop();
+};
+
+template<bool Dual>
 class HornUtil {
-    friend class SetFormulaHorn;
+    friend class HornFormula<Dual>;
 private:
+    typedef HornFormula<Dual> Formula;
     Task *task;
-    SetFormulaHorn *emptyformula;
-    SetFormulaHorn *initformula;
-    SetFormulaHorn *goalformula;
-    SetFormulaHorn *trueformula;
+    Formula *emptyformula;
+    Formula *initformula;
+    Formula *goalformula;
+    Formula *trueformula;
     HornUtil(Task *task);
 
-    void build_actionformulas();
-    bool get_horn_vector(std::vector<SetFormula *> &formulas, std::vector<SetFormulaHorn *> &horn_formulas);
+    // the internal clause stating that var has the given value
+    static std::pair<std::vector<int>,int> unit_clause(int var, bool value);
+    bool get_horn_vector(std::vector<SetFormula *> &formulas, std::vector<Formula *> &horn_formulas);
 
     /*
      * Perform unit propagation through the conjunction of the formulas, returning whether it is satisfiable or not.
      * Partial assignment serves both as input of a partial assignment, and as output indicating which variables
      * are forced true/false by the conjunction.
      */
-    bool simplify_conjunction(std::vector<HornConjunctionElement> &conjuncts, Cube &partial_assignment);
-    bool is_restricted_satisfiable(const SetFormulaHorn *formula, Cube &restriction);
+    bool simplify_conjunction(std::vector<HornConjunctionElement<Dual>> &conjuncts, Cube &partial_assignment);
+    bool is_restricted_satisfiable(const Formula *formula, Cube &restriction);
+    // same as above but reuses the propagation the propagator has already done
+    bool is_restricted_satisfiable(HornPropagator &propagator, Cube &restriction);
+
+    // up to this many clause combinations, the disjunction check tries all of them
+    static const int MAX_ENUMERATED_COMBINATIONS = 64;
+    typedef std::vector<std::pair<int,bool>> Literals;
+    /*
+     * Backtracking search for an assignment that satisfies the propagator and
+     * falsifies all disjuncts that are not yet marked as falsified.
+     * negated_clauses[i] contains for each clause of disjunct i the literals
+     * of its negation.
+     */
+    bool falsify_disjuncts(HornPropagator &propagator,
+                           const std::vector<std::vector<Literals>> &negated_clauses,
+                           std::vector<bool> &falsified);
 
-    bool conjunction_implies_disjunction(std::vector<SetFormulaHorn *> &conjuncts,
-                                         std::vector<SetFormulaHorn *> &disjuncts);
+    bool conjunction_implies_disjunction(std::vector<Formula *> &conjuncts,
+                                         std::vector<Formula *> &disjuncts);
 };
 
 
@@ -54,42 +156,54 @@ private:
  *    - right_side is the positive literal (or -1 if none exists) of clause [i]
  * IMPORTANT: the clauses in left_vars/right_side are expected to contain at least 2 literals!
  *
- * left_sizes and variable_occurences are helper infos for checking satisfiability
+ * left_sizes and the variable occurences are helper infos for checking satisfiability
  *   - left_sizes stores for each clause how many negative literals it contains
- *   - variable occurences stores for each variable, in which clause it appears
- *     (the first unordered_set is for negative occurence, the second for positive)
+ *   - the variable occurences store for each variable, in which clauses it appears
+ *     negatively (left) or positively (right). They are stored in one flat array
+ *     each, where the clauses of var are between occurence_start[var] and
+ *     occurence_start[var+1].
+ * For dual Horn formulas (Dual = true), all of these are stored over the negated
+ * variables, ie forced true means the variable is false in all models.
  */
-class SetFormulaHorn : public SetFormulaBasic
+template<bool Dual>
+class HornFormula : public SetFormulaBasic
 {
-    friend class HornUtil;
+    friend class HornUtil<Dual>;
 private:
     std::vector<std::vector<int>> left_vars;
     std::vector<int> left_sizes;
     std::vector<int> right_side;
-    VariableOccurences variable_occurences;
+    std::vector<int> left_occurence_start;
+    std::vector<int> left_occurences;
+    std::vector<int> right_occurence_start;
+    std::vector<int> right_occurences;
     std::vector<int> forced_true;
     std::vector<int> forced_false;
     int varamount;
     std::vector<int> varorder;
 
-    static HornUtil *util;
+    static HornUtil<Dual> *util;
 
     /*
-     * Private constructors can only be called by SetFormulaHorn or HornUtil,
-     * meaning the static member SetFormulaHorn::util is already initialized
+     * Private constructors can only be called by HornFormula or HornUtil,
+     * meaning the static member HornFormula::util is already initialized
      * and we thus do not need to worry about initializing it.
      */
     // this constructor is used for setting up the formulas in util
-    SetFormulaHorn(const std::vector<std::pair<std::vector<int>,int>> &clauses, int varamount);
+    HornFormula(const std::vector<std::pair<std::vector<int>,int>> &clauses, int varamount);
     // used for getting a simplified conjunction of several (possibly primed) formulas
-    SetFormulaHorn(std::vector<SetFormulaHorn *> &formulas);
-    SetFormulaHorn(const SetFormulaHorn &other, const Action &action, bool progression);
+    HornFormula(std::vector<HornFormula *> &formulas);
+    HornFormula(const HornFormula &other, const Action &action, bool progression);
+    // adds the unit clause stating that var has the given value
+    void add_unit_clause(int var, bool value);
+    // builds the variable occurences from left_vars and right_side
+    void build_occurences();
     void simplify();
 public:
     // TODO: this is currently only used for a dummy initialization
-    SetFormulaHorn(Task *task);
-    SetFormulaHorn(std::ifstream &input, Task *task);
-    virtual ~SetFormulaHorn() {}
+    HornFormula(Task *task);
+    HornFormula(std::istream &input, Task *task);
+    virtual ~HornFormula() {}
 
     //void shift(std::vector<int> &vars);
 
@@ -100,8 +214,8 @@ public:
     const std::vector<int> &get_left_vars(int index) const;
     int get_right(int index) const;
     const std::vector<int> &get_right_sides() const;
-    const std::forward_list<int> &get_variable_occurence_left(int var) const;
-    const std::forward_list<int> &get_variable_occurence_right(int var) const;
+    OccurenceRange get_variable_occurence_left(int var) const;
+    OccurenceRange get_variable_occurence_right(int var) const;
     const std::vector<int> & get_forced_true() const;
     const std::vector<int> & get_forced_false() const;
     const bool is_satisfiable() const;
@@ -112,11 +226,11 @@ public:
     virtual bool is_subset_with_progression(std::vector<SetFormula *> &left,
                                             std::vector<SetFormula *> &right,
                                             std::vector<SetFormula *> &prog,
-                                            std::unordered_set<int> &actions);
+                                            const std::unordered_set<int> &actions);
     virtual bool is_subset_with_regression(std::vector<SetFormula *> &left,
                                            std::vector<SetFormula *> &right,
                                            std::vector<SetFormula *> &reg,
-                                           std::unordered_set<int> &actions);
+                                           const std::unordered_set<int> &actions);
 
     virtual bool is_subset_of(SetFormula *superset, bool left_positive, bool right_positive);
 
@@ -0,0 +1,818 @@
+#include "setformulatwocnf.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+#include "global_funcs.h"
+
+namespace {
+inline Literal make_literal(int var, bool value) {
+    return 2*var + (value ? 0 : 1);
+}
+
+inline int get_var(Literal lit) {
+    return lit >> 1;
+}
+
+inline bool is_positive(Literal lit) {
+    return (lit & 1) == 0;
+}
+}
+
+TwoCNFPropagator::TwoCNFPropagator(const std::vector<const SetFormulaTwoCNF *> &formulas, int varamount)
+    : varamount(varamount), queue_head(0), conflict(false) {
+    for (const SetFormulaTwoCNF *formula : formulas) {
+        this->varamount = std::max(this->varamount, formula->get_varamount());
+    }
+
+    // build the implication graph: (a \lor b) yields \neg a -> b and \neg b -> a
+    edge_start.assign(2*this->varamount+1, 0);
+    for (const SetFormulaTwoCNF *formula : formulas) {
+        for (const std::pair<Literal,Literal> &clause : formula->get_clauses()) {
+            edge_start[(clause.first^1)+1]++;
+            edge_start[(clause.second^1)+1]++;
+        }
+    }
+    for (int lit = 0; lit < 2*this->varamount; ++lit) {
+        edge_start[lit+1] += edge_start[lit];
+    }
+    edges.resize(edge_start.back());
+    std::vector<int> pos(edge_start.begin(), edge_start.end()-1);
+    for (const SetFormulaTwoCNF *formula : formulas) {
+        for (const std::pair<Literal,Literal> &clause : formula->get_clauses()) {
+            edges[pos[clause.first^1]++] = clause.second;
+            edges[pos[clause.second^1]++] = clause.first;
+        }
+    }
+
+    values.assign(this->varamount, 2);
+    conflict = !components_consistent();
+    for (const SetFormulaTwoCNF *formula : formulas) {
+        for (Literal lit : formula->get_units()) {
+            enqueue(lit);
+        }
+    }
+    propagate();
+}
+
+bool TwoCNFPropagator::components_consistent() const {
+    int nodes = 2*varamount;
+    std::vector<int> index(nodes, -1);
+    std::vector<int> lowlink(nodes, -1);
+    std::vector<int> component(nodes, -1);
+    std::vector<int> stack;
+    // node and position of the next edge to visit
+    std::vector<std::pair<int,int>> call_stack;
+    int next_index = 0;
+    int next_component = 0;
+
+    for (int root = 0; root < nodes; ++root) {
+        if (index[root] != -1) {
+            continue;
+        }
+        index[root] = lowlink[root] = next_index++;
+        stack.push_back(root);
+        call_stack.push_back(std::make_pair(root, edge_start[root]));
+        while (!call_stack.empty()) {
+            int node = call_stack.back().first;
+            int edge = call_stack.back().second;
+            if (edge < edge_start[node+1]) {
+                call_stack.back().second++;
+                int succ = edges[edge];
+                if (index[succ] == -1) {
+                    index[succ] = lowlink[succ] = next_index++;
+                    stack.push_back(succ);
+                    call_stack.push_back(std::make_pair(succ, edge_start[succ]));
+                } else if (component[succ] == -1) {
+                    // succ is still on the stack
+                    lowlink[node] = std::min(lowlink[node], index[succ]);
+                }
+                continue;
+            }
+            call_stack.pop_back();
+            if (!call_stack.empty()) {
+                int parent = call_stack.back().first;
+                lowlink[parent] = std::min(lowlink[parent], lowlink[node]);
+            }
+            if (lowlink[node] == index[node]) {
+                int member;
+                do {
+                    member = stack.back();
+                    stack.pop_back();
+                    component[member] = next_component;
+                } while (member != node);
+                next_component++;
+            }
+        }
+    }
+
+    for (int var = 0; var < varamount; ++var) {
+        if (component[2*var] == component[2*var+1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TwoCNFPropagator::enqueue(Literal lit) {
+    int var = get_var(lit);
+    int value = is_positive(lit) ? 1 : 0;
+    if (values[var] == 2) {
+        values[var] = value;
+        trail.push_back(lit);
+    } else if (values[var] != value) {
+        conflict = true;
+    }
+}
+
+int TwoCNFPropagator::get_varamount() const {
+    return varamount;
+}
+
+int TwoCNFPropagator::get_value(int var) const {
+    return values[var];
+}
+
+int TwoCNFPropagator::get_literal_value(Literal lit) const {
+    int value = values[get_var(lit)];
+    if (value == 2 || is_positive(lit)) {
+        return value;
+    }
+    return 1-value;
+}
+
+bool TwoCNFPropagator::is_satisfiable() const {
+    return !conflict;
+}
+
+void TwoCNFPropagator::assume(Literal lit) {
+    enqueue(lit);
+}
+
+bool TwoCNFPropagator::propagate() {
+    while (!conflict && queue_head < trail.size()) {
+        Literal lit = trail[queue_head++];
+        for (int i = edge_start[lit]; i < edge_start[lit+1] && !conflict; ++i) {
+            enqueue(edges[i]);
+        }
+    }
+    return !conflict;
+}
+
+void TwoCNFPropagator::push() {
+    assert(conflict || queue_head == trail.size());
+    levels.push_back(std::make_pair(trail.size(), conflict));
+}
+
+void TwoCNFPropagator::pop() {
+    assert(!levels.empty());
+    size_t mark = levels.back().first;
+    for (size_t pos = mark; pos < trail.size(); ++pos) {
+        values[get_var(trail[pos])] = 2;
+    }
+    trail.resize(mark);
+    queue_head = std::min(queue_head, mark);
+    conflict = levels.back().second;
+    levels.pop_back();
+}
+
+
+TwoCNFUtil::TwoCNFUtil(Task *task)
+    : task(task) {
+    int varamount = task->get_number_of_facts();
+
+    trueformula = new SetFormulaTwoCNF(std::vector<Literal>(),
+                                       std::vector<std::pair<Literal,Literal>>(), varamount);
+    std::vector<Literal> units;
+    units.push_back(make_literal(0, true));
+    units.push_back(make_literal(0, false));
+    emptyformula = new SetFormulaTwoCNF(std::move(units),
+                                        std::vector<std::pair<Literal,Literal>>(), varamount);
+
+    // insert goal
+    units.clear();
+    const Cube &goal = task->get_goal();
+    for(int i = 0; i < goal.size(); ++i) {
+        if(goal.at(i) == 1) {
+            units.push_back(make_literal(i, true));
+        }
+    }
+    goalformula = new SetFormulaTwoCNF(std::move(units),
+                                       std::vector<std::pair<Literal,Literal>>(), varamount);
+
+    // insert initial state
+    units.clear();
+    const Cube &init = task->get_initial_state();
+    for(int i = 0; i < init.size(); ++i) {
+        units.push_back(make_literal(i, init.at(i) == 1));
+    }
+    initformula = new SetFormulaTwoCNF(std::move(units),
+                                       std::vector<std::pair<Literal,Literal>>(), varamount);
+}
+
+bool TwoCNFUtil::get_twocnf_vector(std::vector<SetFormula *> &formulas,
+                                   std::vector<SetFormulaTwoCNF *> &twocnf_formulas) {
+    assert(twocnf_formulas.empty());
+    twocnf_formulas.reserve(formulas.size());
+    for(size_t i = 0; i < formulas.size(); ++i) {
+        if (formulas[i]->get_formula_type() == SetFormulaType::CONSTANT) {
+            SetFormulaConstant *c_formula = static_cast<SetFormulaConstant *>(formulas[i]);
+            switch (c_formula->get_constant_type()) {
+            case ConstantType::EMPTY:
+                twocnf_formulas.push_back(emptyformula);
+                break;
+            case ConstantType::GOAL:
+                twocnf_formulas.push_back(goalformula);
+                break;
+            case ConstantType::INIT:
+                twocnf_formulas.push_back(initformula);
+                break;
+            default:
+                std::cerr << "Unknown constant type " << std::endl;
+                exit_with(ExitCode::CRITICAL_ERROR);
+                break;
+            }
+        } else if(formulas[i]->get_formula_type() == SetFormulaType::TWOCNF) {
+            twocnf_formulas.push_back(static_cast<SetFormulaTwoCNF *>(formulas[i]));
+        } else {
+            std::cerr << "Error: SetFormula of type other than 2CNF not allowed here."
+                      << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TwoCNFUtil::falsify_disjuncts(TwoCNFPropagator &propagator,
+                                   const std::vector<std::vector<Literals>> &negated_clauses,
+                                   std::vector<bool> &falsified) {
+    /*
+     * Pick the open disjunct with the fewest clauses whose negation is still
+     * consistent with the current assignment. Disjuncts that are already
+     * falsified by the assignment are marked without branching.
+     */
+    int chosen = -1;
+    std::vector<int> chosen_candidates;
+    std::vector<int> newly_falsified;
+    std::vector<int> candidates;
+    for (size_t i = 0; i < negated_clauses.size(); ++i) {
+        if (falsified[i]) {
+            continue;
+        }
+        candidates.clear();
+        bool already_falsified = false;
+        for (size_t clause = 0; clause < negated_clauses[i].size(); ++clause) {
+            bool consistent = true;
+            bool holds = true;
+            for (Literal lit : negated_clauses[i][clause]) {
+                int value = propagator.get_literal_value(lit);
+                if (value == 2) {
+                    holds = false;
+                } else if (value == 0) {
+                    consistent = false;
+                    break;
+                }
+            }
+            if (consistent && holds) {
+                already_falsified = true;
+                break;
+            } else if (consistent) {
+                candidates.push_back(clause);
+            }
+        }
+        if (already_falsified) {
+            newly_falsified.push_back(i);
+            falsified[i] = true;
+        } else if (chosen == -1 || candidates.size() < chosen_candidates.size()) {
+            chosen = i;
+            chosen_candidates.swap(candidates);
+        }
+    }
+
+    bool found = false;
+    if (chosen == -1) {
+        // all disjuncts are falsified and the propagator has no conflict
+        found = true;
+    } else {
+        falsified[chosen] = true;
+        for (int clause : chosen_candidates) {
+            propagator.push();
+            for (Literal lit : negated_clauses[chosen][clause]) {
+                propagator.assume(lit);
+            }
+            found = propagator.propagate()
+                    && falsify_disjuncts(propagator, negated_clauses, falsified);
+            propagator.pop();
+            if (found) {
+                break;
+            }
+        }
+        falsified[chosen] = false;
+    }
+    for (int i : newly_falsified) {
+        falsified[i] = false;
+    }
+    return found;
+}
+
+bool TwoCNFUtil::conjunction_implies_disjunction(std::vector<SetFormulaTwoCNF *> &conjuncts,
+                                                 std::vector<SetFormulaTwoCNF *> &disjuncts) {
+    if (conjuncts.empty()) {
+        conjuncts.push_back(trueformula);
+    }
+    int varamount = 0;
+    std::vector<std::vector<Literals>> negated_clauses;
+    negated_clauses.reserve(disjuncts.size());
+    for (SetFormulaTwoCNF *formula : disjuncts) {
+        /*
+         * An empty formula is equivalent to \top
+         * -> return true since everything is a subset of a union containing \top
+         */
+        if (formula->get_units().empty() && formula->get_clauses().empty()) {
+            return true;
+        }
+        // formula not satisfiable -> ignore it
+        std::vector<const SetFormulaTwoCNF *> formula_vec(1, formula);
+        if (!TwoCNFPropagator(formula_vec, 0).is_satisfiable()) {
+            continue;
+        }
+        varamount = std::max(varamount, formula->get_varamount());
+        negated_clauses.push_back(std::vector<Literals>());
+        std::vector<Literals> &negation = negated_clauses.back();
+        negation.reserve(formula->get_units().size() + formula->get_clauses().size());
+        for (Literal lit : formula->get_units()) {
+            negation.push_back(Literals(1, lit^1));
+        }
+        for (const std::pair<Literal,Literal> &clause : formula->get_clauses()) {
+            Literals negated_clause;
+            negated_clause.push_back(clause.first^1);
+            negated_clause.push_back(clause.second^1);
+            negation.push_back(std::move(negated_clause));
+        }
+    }
+
+    std::vector<const SetFormulaTwoCNF *> conjunct_formulas(conjuncts.begin(), conjuncts.end());
+    TwoCNFPropagator conjunction(conjunct_formulas, varamount);
+    if (!conjunction.is_satisfiable()) {
+        return true;
+    }
+    // since propagation is complete, each branch without conflict is a counterexample
+    std::vector<bool> falsified(negated_clauses.size(), false);
+    return !falsify_disjuncts(conjunction, negated_clauses, falsified);
+}
+
+
+TwoCNFUtil *SetFormulaTwoCNF::util = nullptr;
+
+SetFormulaTwoCNF::SetFormulaTwoCNF(std::vector<Literal> &&units,
+                                   std::vector<std::pair<Literal,Literal>> &&clauses, int varamount)
+    : units(std::move(units)), clauses(std::move(clauses)), varamount(varamount) {
+    set_identity_varorder();
+}
+
+SetFormulaTwoCNF::SetFormulaTwoCNF(std::vector<SetFormulaTwoCNF *> &formulas)
+    : varamount(0) {
+    size_t unit_amount = 0;
+    size_t clause_amount = 0;
+    for (SetFormulaTwoCNF *formula : formulas) {
+        unit_amount += formula->units.size();
+        clause_amount += formula->clauses.size();
+        varamount = std::max(varamount, formula->varamount);
+    }
+    units.reserve(unit_amount);
+    clauses.reserve(clause_amount);
+    for (SetFormulaTwoCNF *formula : formulas) {
+        units.insert(units.end(), formula->units.begin(), formula->units.end());
+        clauses.insert(clauses.end(), formula->clauses.begin(), formula->clauses.end());
+    }
+    set_identity_varorder();
+}
+
+SetFormulaTwoCNF::SetFormulaTwoCNF(const SetFormulaTwoCNF &other, const Action &action, bool progression)
+    : units(other.units), clauses(other.clauses), varamount(2*action.change.size()) {
+
+    if (progression) {
+        for (int var : action.pre) {
+            units.push_back(make_literal(var, true));
+        }
+    } else {
+        for (size_t var = 0; var < action.change.size(); ++var) {
+            if (action.change[var] != 0) {
+                units.push_back(make_literal(var, action.change[var] == 1));
+            }
+        }
+    }
+
+    // shift
+    int shift = 2*action.change.size();
+    auto shift_literal = [&](Literal &lit) {
+        if (action.change[get_var(lit)] != 0) {
+            lit += shift;
+        }
+    };
+    for (Literal &lit : units) {
+        shift_literal(lit);
+    }
+    for (std::pair<Literal,Literal> &clause : clauses) {
+        shift_literal(clause.first);
+        shift_literal(clause.second);
+    }
+
+    // apply actions
+    if (progression) {
+        for (size_t var = 0; var < action.change.size(); ++var) {
+            if (action.change[var] != 0) {
+                units.push_back(make_literal(var, action.change[var] == 1));
+            }
+        }
+    } else {
+        for (int var : action.pre) {
+            units.push_back(make_literal(var, true));
+        }
+    }
+    set_identity_varorder();
+}
+
+SetFormulaTwoCNF::SetFormulaTwoCNF(Task *task) {
+    if (util == nullptr) {
+        util = new TwoCNFUtil(task);
+    }
+}
+
+SetFormulaTwoCNF::SetFormulaTwoCNF(std::istream &input, Task *task) {
+    // parsing
+    std::string word;
+    int clausenum;
+    input >> word;
+    if (word.compare("p") != 0) {
+        std::cerr << "Invalid DIMACS format" << std::endl;
+        exit_with(ExitCode::CRITICAL_ERROR);
+    }
+    input >> word;
+    if (word.compare("cnf") != 0) {
+        std::cerr << "DIMACS format" << word << "not recognized" << std::endl;
+        exit_with(ExitCode::CRITICAL_ERROR);
+    }
+    input >> varamount;
+    input >> clausenum;
+
+    std::vector<Literal> clause;
+    for(int i = 0; i < clausenum; ++i) {
+        clause.clear();
+        int var;
+        input >> var;
+        while(var != 0) {
+            Literal lit = make_literal(std::abs(var)-1, var > 0);
+            if (std::find(clause.begin(), clause.end(), lit) == clause.end()) {
+                clause.push_back(lit);
+            }
+            input >> var;
+        }
+        if (clause.empty() || clause.size() > 2) {
+            std::cerr << "Invalid 2CNF formula" << std::endl;
+            exit_with(ExitCode::CRITICAL_ERROR);
+        } else if (clause.size() == 1) {
+            units.push_back(clause[0]);
+        } else if (clause[0] != (clause[1]^1)) {
+            // tautologies are dropped
+            clauses.push_back(std::make_pair(clause[0], clause[1]));
+        }
+    }
+    input >> word;
+    if(word.compare(";") != 0) {
+        std::cerr << "2CNF formula syntax wrong" << std::endl;
+        exit_with(ExitCode::CRITICAL_ERROR);
+    }
+
+    // create util if this is the first 2CNF formula
+    if (util == nullptr) {
+        util = new TwoCNFUtil(task);
+    }
+    set_identity_varorder();
+}
+
+void SetFormulaTwoCNF::set_identity_varorder() {
+    varorder.resize(varamount);
+    for (int var = 0; var < varamount; ++var) {
+        varorder[var] = var;
+    }
+}
+
+int SetFormulaTwoCNF::get_varamount() const {
+    return varamount;
+}
+
+const std::vector<Literal> &SetFormulaTwoCNF::get_units() const {
+    return units;
+}
+
+const std::vector<std::pair<Literal,Literal>> &SetFormulaTwoCNF::get_clauses() const {
+    return clauses;
+}
+
+void SetFormulaTwoCNF::dump() const {
+    std::cout << "units: ";
+    for (Literal lit : units) {
+        std::cout << (is_positive(lit) ? "" : "-") << get_var(lit) << " ";
+    }
+    std::cout << std::endl << "clauses: ";
+    for (const std::pair<Literal,Literal> &clause : clauses) {
+        std::cout << (is_positive(clause.first) ? "" : "-") << get_var(clause.first) << ","
+                  << (is_positive(clause.second) ? "" : "-") << get_var(clause.second) << " ";
+    }
+    std::cout << std::endl;
+}
+
+bool SetFormulaTwoCNF::is_subset(std::vector<SetFormula *> &left,
+                                 std::vector<SetFormula *> &right) {
+    std::vector<SetFormulaTwoCNF *> twocnf_formulas_left;
+    std::vector<SetFormulaTwoCNF *> twocnf_formulas_right;
+    bool valid_twocnf_formulas = util->get_twocnf_vector(left, twocnf_formulas_left)
+            && util->get_twocnf_vector(right, twocnf_formulas_right);
+    if(!valid_twocnf_formulas) {
+        return false;
+    }
+    return util->conjunction_implies_disjunction(twocnf_formulas_left, twocnf_formulas_right);
+}
+
+bool SetFormulaTwoCNF::check_subset_with_action(std::vector<SetFormula *> &left,
+                                                std::vector<SetFormula *> &right,
+                                                std::vector<SetFormula *> &sets,
+                                                const std::unordered_set<int> &actions,
+                                                bool progression) {
+    std::vector<SetFormulaTwoCNF *> twocnf_formulas_left;
+    std::vector<SetFormulaTwoCNF *> twocnf_formulas_right;
+    std::vector<SetFormulaTwoCNF *> twocnf_formulas_sets;
+    bool valid_twocnf_formulas = util->get_twocnf_vector(left, twocnf_formulas_left)
+            && util->get_twocnf_vector(right, twocnf_formulas_right)
+            && util->get_twocnf_vector(sets, twocnf_formulas_sets);
+    if (!valid_twocnf_formulas) {
+        return false;
+    }
+
+    // the conjunction of 2CNF formulas is again a 2CNF formula
+    SetFormulaTwoCNF sets_conjunction(twocnf_formulas_sets);
+    std::vector<SetFormulaTwoCNF *> vec(twocnf_formulas_left);
+    for (int a : actions) {
+        SetFormulaTwoCNF applied(sets_conjunction, util->task->get_action(a), progression);
+        vec.push_back(&applied);
+        if (!util->conjunction_implies_disjunction(vec, twocnf_formulas_right)) {
+            return false;
+        }
+        vec.pop_back();
+    }
+    return true;
+}
+
+bool SetFormulaTwoCNF::is_subset_with_progression(std::vector<SetFormula *> &left,
+                                                  std::vector<SetFormula *> &right,
+                                                  std::vector<SetFormula *> &prog,
+                                                  const std::unordered_set<int> &actions) {
+    return check_subset_with_action(left, right, prog, actions, true);
+}
+
+bool SetFormulaTwoCNF::is_subset_with_regression(std::vector<SetFormula *> &left,
+                                                 std::vector<SetFormula *> &right,
+                                                 std::vector<SetFormula *> &reg,
+                                                 const std::unordered_set<int> &actions) {
+    return check_subset_with_action(left, right, reg, actions, false);
+}
+
+/*
+ * Enumerates all models of the propagator by assigning the variables in order.
+ * Since propagation is complete for 2CNF, at least one value of each variable
+ * is consistent, so the search never runs into a dead end.
+ */
+bool SetFormulaTwoCNF::enumerate_models(TwoCNFPropagator &propagator, int var, SetFormula *superset,
+                                        const std::vector<int> &var_transform,
+                                        const std::vector<int> &vars_to_fill,
+                                        std::vector<bool> &model) {
+    if (var == varamount) {
+        for (int count = 0; count < (1 << vars_to_fill.size()); ++count) {
+            for (size_t i = 0; i < vars_to_fill.size(); ++i) {
+                model[vars_to_fill[i]] = ((count >> i) % 2 == 1);
+            }
+            if (!superset->is_contained(model)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (propagator.get_value(var) != 2) {
+        model[var_transform[var]] = (propagator.get_value(var) == 1);
+        return enumerate_models(propagator, var+1, superset, var_transform, vars_to_fill, model);
+    }
+    for (int value = 0; value < 2; ++value) {
+        propagator.push();
+        propagator.assume(make_literal(var, value == 1));
+        bool consistent = propagator.propagate();
+        model[var_transform[var]] = (value == 1);
+        bool contained = !consistent || enumerate_models(propagator, var+1, superset,
+                                                         var_transform, vars_to_fill, model);
+        propagator.pop();
+        if (!contained) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SetFormulaTwoCNF::is_subset_of(SetFormula *superset, bool left_positive, bool right_positive) {
+    if (left_positive && right_positive) {
+        if (superset->supports_cnf_enumeration()) {
+            int count = 0;
+            std::vector<int> varorder;
+            std::vector<bool> clause;
+            while (superset->get_clause(count, varorder, clause)) {
+                if (!is_entailed(varorder, clause)) {
+                    return false;
+                }
+                count++;
+            }
+            return true;
+        } else if (superset->get_formula_type() == SetFormulaType::EXPLICIT) {
+            const std::vector<int> &sup_varorder = superset->get_varorder();
+            std::vector<bool> model(sup_varorder.size());
+            std::vector<int> var_transform(varorder.size(), -1);
+            std::vector<int> vars_to_fill;
+            for (size_t i = 0; i < varorder.size(); ++i) {
+                auto pos_it = std::find(sup_varorder.begin(), sup_varorder.end(), varorder[i]);
+                if (pos_it == sup_varorder.end()) {
+                    std::cerr << "mixed representation subset check not possible" << std::endl;
+                    return false;
+                }
+                var_transform[i] = std::distance(sup_varorder.begin(), pos_it);
+            }
+            for (size_t i = 0; i < sup_varorder.size(); ++i) {
+                if(sup_varorder[i] >= varorder.size()) {
+                    vars_to_fill.push_back(i);
+                }
+            }
+
+            std::vector<const SetFormulaTwoCNF *> formula_vec(1, this);
+            TwoCNFPropagator propagator(formula_vec, varamount);
+            if (!propagator.is_satisfiable()) {
+                return true;
+            }
+            return enumerate_models(propagator, 0, superset, var_transform, vars_to_fill, model);
+        } else {
+            std::cerr << "mixed representation subset check not possible" << std::endl;
+            return false;
+        }
+    } else if (left_positive && !right_positive) {
+        if (superset->supports_dnf_enumeration()) {
+            return superset->is_subset_of(this, true, false);
+        } else if (superset->get_formula_type() == SetFormulaType::EXPLICIT) {
+            return superset->is_subset_of(this, true, false);
+        } else {
+            std::cerr << "mixed representation subset check not possible" << std::endl;
+            return false;
+        }
+    } else if (!left_positive && right_positive) {
+        // the negation of the formula is the union of the negated clauses
+        if (superset->supports_implicant_check()) {
+            std::vector<int> vars(1,-1);
+            std::vector<bool> implicant(1);
+            for (Literal lit : units) {
+                vars[0] = get_var(lit);
+                implicant[0] = !is_positive(lit);
+                if (!superset->is_implicant(vars, implicant)) {
+                    return false;
+                }
+            }
+            vars.resize(2);
+            implicant.resize(2);
+            for (const std::pair<Literal,Literal> &clause : clauses) {
+                vars[0] = get_var(clause.first);
+                implicant[0] = !is_positive(clause.first);
+                vars[1] = get_var(clause.second);
+                implicant[1] = !is_positive(clause.second);
+                if (!superset->is_implicant(vars, implicant)) {
+                    return false;
+                }
+            }
+            return true;
+        } else if (superset->supports_cnf_enumeration()) {
+            return superset->is_subset_of(this, false, true);
+        } else {
+            std::cerr << "mixed representation subset check not possible" << std::endl;
+            return false;
+        }
+    } else { // both negative
+        return superset->is_subset_of(this, true, true);
+    }
+}
+
+SetFormulaType SetFormulaTwoCNF::get_formula_type() {
+    return SetFormulaType::TWOCNF;
+}
+
+SetFormulaBasic *SetFormulaTwoCNF::get_constant_formula(SetFormulaConstant *c_formula) {
+    switch(c_formula->get_constant_type()) {
+    case ConstantType::EMPTY:
+        return util->emptyformula;
+        break;
+    case ConstantType::INIT:
+        return util->initformula;
+        break;
+    case ConstantType::GOAL:
+        return util->goalformula;
+        break;
+    default:
+        std::cerr << "Unknown Constant type: " << std::endl;
+        return nullptr;
+        break;
+    }
+}
+
+const std::vector<int> &SetFormulaTwoCNF::get_varorder() {
+    return varorder;
+}
+
+bool SetFormulaTwoCNF::is_contained(const std::vector<bool> &model) const {
+    auto holds = [&](Literal lit) {
+        return model[get_var(lit)] == is_positive(lit);
+    };
+    for (Literal lit : units) {
+        if (!holds(lit)) {
+            return false;
+        }
+    }
+    for (const std::pair<Literal,Literal> &clause : clauses) {
+        if (!holds(clause.first) && !holds(clause.second)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SetFormulaTwoCNF::is_implicant(const std::vector<int> &varorder, const std::vector<bool> &implicant) {
+    // the cube implies the formula iff it contains a literal of each clause (or is contradictory)
+    int size = varamount;
+    for (int var : varorder) {
+        size = std::max(size, var+1);
+    }
+    std::vector<int> cube(size, 2);
+    for (size_t i = 0; i < varorder.size(); ++i) {
+        int value = implicant[i] ? 1 : 0;
+        if (cube[varorder[i]] == 1-value) {
+            return true;
+        }
+        cube[varorder[i]] = value;
+    }
+    auto holds = [&](Literal lit) {
+        return cube[get_var(lit)] == (is_positive(lit) ? 1 : 0);
+    };
+    for (Literal lit : units) {
+        if (!holds(lit)) {
+            return false;
+        }
+    }
+    for (const std::pair<Literal,Literal> &clause : clauses) {
+        if (!holds(clause.first) && !holds(clause.second)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SetFormulaTwoCNF::is_entailed(const std::vector<int> &varorder, const std::vector<bool> &clause) {
+    // the clause is entailed if the formula has no model falsifying it
+    int size = varamount;
+    for (int var : varorder) {
+        size = std::max(size, var+1);
+    }
+    std::vector<const SetFormulaTwoCNF *> formula_vec(1, this);
+    TwoCNFPropagator propagator(formula_vec, size);
+    for (size_t i = 0; i < clause.size(); ++i) {
+        propagator.assume(make_literal(varorder[i], !clause[i]));
+    }
+    return !propagator.propagate();
+}
+
+bool SetFormulaTwoCNF::get_clause(int i, std::vector<int> &vars, std::vector<bool> &clause) {
+    vars.clear();
+    clause.clear();
+    if (i < units.size()) {
+        vars.push_back(get_var(units[i]));
+        clause.push_back(is_positive(units[i]));
+        return true;
+    }
+
+    i -= units.size();
+    if (i < clauses.size()) {
+        vars.push_back(get_var(clauses[i].first));
+        clause.push_back(is_positive(clauses[i].first));
+        vars.push_back(get_var(clauses[i].second));
+        clause.push_back(is_positive(clauses[i].second));
+        return true;
+    }
+    return false;
+}
+
+int SetFormulaTwoCNF::get_model_count() {
+    std::cerr << "2CNF Formula does not support model count";
+    exit_with(ExitCode::CRITICAL_ERROR);
+}
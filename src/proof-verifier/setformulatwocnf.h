@@ -0,0 +1,176 @@
+#ifndef SETFORMULATWOCNF_H
+#define SETFORMULATWOCNF_H
+
+#include <unordered_set>
+
+#include "setformulabasic.h"
+#include "task.h"
+
+class SetFormulaTwoCNF;
+
+/*
+ * Literals are encoded as 2*var for the positive and 2*var+1 for the negative
+ * literal of var, such that lit^1 is the negation of lit.
+ */
+typedef int Literal;
+
+/*
+ * Unit propagation over the implication graph of a conjunction of 2CNF
+ * formulas. A clause (a \lor b) results in the edges \neg a -> b and
+ * \neg b -> a; the edges of each literal are stored in one flat array.
+ * Satisfiability of the conjunction is determined by the strongly connected
+ * components of the graph: it is unsatisfiable iff a literal and its negation
+ * lie in the same component, or if propagating the unit clauses fails.
+ * For satisfiable 2CNF formulas, unit propagation is complete: a set of
+ * assumptions is consistent with the formula iff propagating them does not
+ * lead to a conflict. Like HornPropagator, all assumptions and propagations
+ * made after a push can be undone by pop.
+ */
+class TwoCNFPropagator {
+private:
+    int varamount;
+    std::vector<int> edge_start;
+    std::vector<Literal> edges;
+
+    // 0 = false, 1 = true, 2 = unassigned
+    std::vector<int> values;
+    std::vector<Literal> trail;
+    // trail entries before queue_head have been propagated
+    size_t queue_head;
+    bool conflict;
+    std::vector<std::pair<size_t,bool>> levels;
+
+    // Tarjan's algorithm; true if no literal is in the same component as its negation
+    bool components_consistent() const;
+    void enqueue(Literal lit);
+public:
+    TwoCNFPropagator(const std::vector<const SetFormulaTwoCNF *> &formulas, int varamount);
+
+    int get_varamount() const;
+    int get_value(int var) const;
+    // 0 = false, 1 = true, 2 = unassigned
+    int get_literal_value(Literal lit) const;
+    // false if the conjunction (with the current assumptions) is unsatisfiable
+    bool is_satisfiable() const;
+    // add an assumption; it is only propagated by the next call to propagate()
+    void assume(Literal lit);
+    bool propagate();
+    // remember the current (propagated) assignment
+    void push();
+    // undo all assumptions and propagations since the last push
+    void pop();
+};
+
+class TwoCNFUtil {
+    friend class SetFormulaTwoCNF;
+private:
+    Task *task;
+    SetFormulaTwoCNF *emptyformula;
+    SetFormulaTwoCNF *initformula;
+    SetFormulaTwoCNF *goalformula;
+    SetFormulaTwoCNF *trueformula;
+    TwoCNFUtil(Task *task);
+
+    bool get_twocnf_vector(std::vector<SetFormula *> &formulas,
+                           std::vector<SetFormulaTwoCNF *> &twocnf_formulas);
+
+    typedef std::vector<Literal> Literals;
+    /*
+     * Backtracking search for an assignment that satisfies the propagator and
+     * falsifies all disjuncts that are not yet marked as falsified.
+     * negated_clauses[i] contains for each clause of disjunct i its negation.
+     */
+    bool falsify_disjuncts(TwoCNFPropagator &propagator,
+                           const std::vector<std::vector<Literals>> &negated_clauses,
+                           std::vector<bool> &falsified);
+
+    bool conjunction_implies_disjunction(std::vector<SetFormulaTwoCNF *> &conjuncts,
+                                         std::vector<SetFormulaTwoCNF *> &disjuncts);
+};
+
+/*
+ * A 2CNF formula consists of the following parts:
+ *  - units: the literals of all unit clauses
+ *  - clauses: all clauses with two literals
+ * Which combinations of literals are possible is decided on the implication
+ * graph built by TwoCNFPropagator.
+ */
+class SetFormulaTwoCNF : public SetFormulaBasic
+{
+    friend class TwoCNFUtil;
+private:
+    std::vector<Literal> units;
+    std::vector<std::pair<Literal,Literal>> clauses;
+    int varamount;
+    std::vector<int> varorder;
+
+    static TwoCNFUtil *util;
+
+    /*
+     * Private constructors can only be called by SetFormulaTwoCNF or TwoCNFUtil,
+     * meaning the static member SetFormulaTwoCNF::util is already initialized.
+     */
+    SetFormulaTwoCNF(std::vector<Literal> &&units,
+                     std::vector<std::pair<Literal,Literal>> &&clauses, int varamount);
+    // the conjunction of several formulas
+    SetFormulaTwoCNF(std::vector<SetFormulaTwoCNF *> &formulas);
+    /*
+     * Progression/regression over one action. Variables changed by the action
+     * are shifted to varamount + var and stand for their value before (for
+     * progression) or after (for regression) applying the action.
+     */
+    SetFormulaTwoCNF(const SetFormulaTwoCNF &other, const Action &action, bool progression);
+    void set_identity_varorder();
+    bool check_subset_with_action(std::vector<SetFormula *> &left,
+                                  std::vector<SetFormula *> &right,
+                                  std::vector<SetFormula *> &sets,
+                                  const std::unordered_set<int> &actions,
+                                  bool progression);
+    bool enumerate_models(TwoCNFPropagator &propagator, int var, SetFormula *superset,
+                          const std::vector<int> &var_transform,
+                          const std::vector<int> &vars_to_fill,
+                          std::vector<bool> &model);
+public:
+    // TODO: this is currently only used for a dummy initialization
+    SetFormulaTwoCNF(Task *task);
+    SetFormulaTwoCNF(std::istream &input, Task *task);
+    virtual ~SetFormulaTwoCNF() {}
+
+    int get_varamount() const;
+    const std::vector<Literal> &get_units() const;
+    const std::vector<std::pair<Literal,Literal>> &get_clauses() const;
+    void dump() const;
+
+    virtual bool is_subset(std::vector<SetFormula *> &left,
+                           std::vector<SetFormula *> &right);
+    virtual bool is_subset_with_progression(std::vector<SetFormula *> &left,
+                                            std::vector<SetFormula *> &right,
+                                            std::vector<SetFormula *> &prog,
+                                            const std::unordered_set<int> &actions);
+    virtual bool is_subset_with_regression(std::vector<SetFormula *> &left,
+                                           std::vector<SetFormula *> &right,
+                                           std::vector<SetFormula *> &reg,
+                                           const std::unordered_set<int> &actions);
+
+    virtual bool is_subset_of(SetFormula *superset, bool left_positive, bool right_positive);
+
+    virtual SetFormulaType get_formula_type();
+    virtual SetFormulaBasic *get_constant_formula(SetFormulaConstant *c_formula);
+    virtual const std::vector<int> &get_varorder();
+
+    virtual bool supports_implicant_check() { return true; }
+    virtual bool supports_clausal_entailment_check() { return true; }
+    virtual bool supports_dnf_enumeration() { return false; }
+    virtual bool supports_cnf_enumeration() { return true; }
+    virtual bool supports_model_enumeration() { return true; }
+    virtual bool supports_model_counting() { return false; }
+
+    // expects the model in the varorder of the formula;
+    virtual bool is_contained(const std::vector<bool> &model) const;
+    virtual bool is_implicant(const std::vector<int> &varorder, const std::vector<bool> &implicant);
+    virtual bool is_entailed(const std::vector<int> &varorder, const std::vector<bool> &clause);
+    virtual bool get_clause(int i, std::vector<int> &vars, std::vector<bool> &clause);
+    virtual int get_model_count();
+};
+
+#endif // SETFORMULATWOCNF_H
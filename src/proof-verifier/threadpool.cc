@@ -0,0 +1,54 @@
+#include "threadpool.h"
+
+#include "global_funcs.h"
+
+ThreadPool::ThreadPool(int amount)
+    : stopped(false) {
+    for(int i = 0; i < amount; ++i) {
+        workers.push_back(std::thread(&ThreadPool::work, this));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex);
+        stopped = true;
+        jobs.clear();
+    }
+    jobs_cv.notify_all();
+    for(std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::work() {
+    mark_worker_thread();
+    while(true) {
+        std::packaged_task<bool()> job;
+        {
+            std::unique_lock<std::mutex> lock(jobs_mutex);
+            jobs_cv.wait(lock, [this] { return stopped || !jobs.empty(); });
+            if(jobs.empty()) {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        job();
+    }
+}
+
+std::future<bool> ThreadPool::submit(std::function<bool()> job) {
+    std::packaged_task<bool()> task(job);
+    std::future<bool> result = task.get_future();
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex);
+        jobs.push_back(std::move(task));
+    }
+    jobs_cv.notify_one();
+    return result;
+}
+
+int ThreadPool::size() const {
+    return workers.size();
+}
@@ -0,0 +1,37 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * A fixed number of worker threads executing subset checks in FIFO order.
+ * The jobs must not touch any state that is modified by the main thread
+ * (in particular the global Cudd manager, which is not thread-safe).
+ * Calls to exit_with in a job are rethrown as WorkerExit by its future.
+ * Jobs that have not been started when the pool is destroyed are dropped.
+ */
+class ThreadPool
+{
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::packaged_task<bool()>> jobs;
+    std::mutex jobs_mutex;
+    std::condition_variable jobs_cv;
+    bool stopped;
+
+    void work();
+public:
+    ThreadPool(int amount);
+    ~ThreadPool();
+
+    std::future<bool> submit(std::function<bool()> job);
+    int size() const;
+};
+
+#endif // THREADPOOL_H
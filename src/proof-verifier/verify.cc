@@ -11,10 +11,11 @@
 #include "task.h"
 #include "timer.h"
 #include "proofchecker.h"
+#include "batchverifier.h"
+#include "binaryproof.h"
 #include "setformula.h"
-#include "setformulacompound.h"
 #include "setformulahorn.h"
-#include "setformuladualhorn.h"
+#include "setformulatwocnf.h"
 #include "setformulabdd.h"
 #include "setformulaexplicit.h"
 
@@ -34,8 +35,7 @@ void read_in_expression(std::ifstream &in, ProofChecker &proofchecker, Task *tas
     } else if(type == "d") {
         expression = std::unique_ptr<SetFormula>(new SetFormulaDualHorn(in, task));
     } else if(type == "t") {
-        std::cerr << "not implemented yet" << std::endl;
-        exit_with(ExitCode::CRITICAL_ERROR);
+        expression = std::unique_ptr<SetFormula>(new SetFormulaTwoCNF(in, task));
     } else if(type == "e") {
         expression = std::unique_ptr<SetFormula>(new SetFormulaExplicit(in, task));
     } else if(type == "c") {
@@ -43,27 +43,35 @@ void read_in_expression(std::ifstream &in, ProofChecker &proofchecker, Task *tas
     } else if(type == "n") {
         FormulaIndex subformulaindex;
         in >> subformulaindex;
-        expression = std::unique_ptr<SetFormula>(new SetFormulaNegation(subformulaindex));
+        proofchecker.add_compound_formula(SetFormulaType::NEGATION, subformulaindex,
+                                          ProofChecker::INDEXNONE, expression_index);
+        return;
     } else if(type == "i") {
         FormulaIndex left, right;
         in >> left;
         in >> right;
-        expression = std::unique_ptr<SetFormula>(new SetFormulaIntersection(left, right));
+        proofchecker.add_compound_formula(SetFormulaType::INTERSECTION, left, right, expression_index);
+        return;
     } else if(type == "u") {
         FormulaIndex left, right;
         in >> left;
         in >> right;
-        expression = std::unique_ptr<SetFormula>(new SetFormulaUnion(left, right));
+        proofchecker.add_compound_formula(SetFormulaType::UNION, left, right, expression_index);
+        return;
     } else if(type == "p") {
         FormulaIndex subformulaindex, actionsetindex;
         in >> subformulaindex;
         in >> actionsetindex;
-        expression = std::unique_ptr<SetFormula>(new SetFormulaProgression(subformulaindex, actionsetindex));
+        proofchecker.add_compound_formula(SetFormulaType::PROGRESSION, subformulaindex,
+                                          actionsetindex, expression_index);
+        return;
     } else if(type == "r") {
         FormulaIndex subformulaindex, actionsetindex;
         in >> subformulaindex;
         in >> actionsetindex;
-        expression = std::unique_ptr<SetFormula>(new SetFormulaRegression(subformulaindex, actionsetindex));
+        proofchecker.add_compound_formula(SetFormulaType::REGRESSION, subformulaindex,
+                                          actionsetindex, expression_index);
+        return;
     } else {
         std::cerr << "unknown expression type " << type << std::endl;
         exit_with(ExitCode::CRITICAL_ERROR);
@@ -203,86 +211,94 @@ void read_and_check_knowledge(std::ifstream &in, ProofChecker &proofchecker) {
     }
 }
 
-int main(int argc, char** argv) {
-    if(argc < 3 || argc > 5) {
-        std::cout << "Usage: verify <task-file> <certificate-file> [--timeout=x] [--discard_formulas]" << std::endl;
-        std::cout << "timeout is an optional parameter in seconds" << std::endl;
-        exit(0);
+void print_result_and_exit(ProofChecker &proofchecker) {
+    // is_unsolvability_proven() waits for pending checks, so we ask it before measuring time
+    bool proven = proofchecker.is_unsolvability_proven();
+    std::cout << "Verify total time: " << timer() << std::endl;
+    std::cout << "Verify memory: " << get_peak_memory_in_kb() << "KB" << std::endl;
+    if(proven) {
+        std::cout << "unsolvability proven" << std::endl;
+        exit_with(ExitCode::CERTIFICATE_VALID);
+    } else {
+        std::cout << "unsolvability NOT proven" << std::endl;
+        exit_with(ExitCode::CERTIFICATE_NOT_VALID);
     }
-    register_event_handlers();
-    initialize_timer();
-    std::string task_file = argv[1];
-    std::string certificate_file = argv[2];
+}
 
-    // expand environment variables
-    size_t found = task_file.find('$');
-    while(found != std::string::npos) {
-        size_t end = task_file.find('/');
-        std::string envvar;
-        if(end == std::string::npos) {
-            envvar = task_file.substr(found+1);
-        } else {
-            envvar = task_file.substr(found+1,end-found-1);
-        }
-        // to upper case
-        for(size_t i = 0; i < envvar.size(); i++) {
-            envvar.at(i) = toupper(envvar.at(i));
-        }
-        std::string expanded = std::getenv(envvar.c_str());
-        task_file.replace(found,envvar.length()+1,expanded);
-        found = task_file.find('$');
-    }
-    found = certificate_file.find('$');
+void print_usage_and_exit() {
+    std::cout << "Usage: verify <task-file> <certificate-file> [--timeout=x] [--discard_formulas] [--threads=n] [--reorder_bdds]" << std::endl;
+    std::cout << "       verify --batch [--timeout=x] [--discard_formulas] [--threads=n] [--reorder_bdds]" << std::endl;
+    std::cout << "timeout is an optional parameter in seconds" << std::endl;
+    std::cout << "threads is the amount of worker threads for checking basic statements" << std::endl;
+    std::cout << "with --batch, jobs \"<task-file> <certificate-file>\" are read from stdin (one per line)" << std::endl;
+    exit(0);
+}
+
+void expand_environment_variables(std::string &file) {
+    size_t found = file.find('$');
     while(found != std::string::npos) {
-        size_t end = certificate_file.find('/');
+        size_t end = file.find('/');
         std::string envvar;
         if(end == std::string::npos) {
-            envvar = certificate_file.substr(found+1);
+            envvar = file.substr(found+1);
         } else {
-            envvar = certificate_file.substr(found+1,end-found-1);
+            envvar = file.substr(found+1,end-found-1);
         }
         // to upper case
         for(size_t i = 0; i < envvar.size(); i++) {
             envvar.at(i) = toupper(envvar.at(i));
         }
         std::string expanded = std::getenv(envvar.c_str());
-        certificate_file.replace(found,envvar.length()+1,expanded);
-        found = certificate_file.find('$');
+        file.replace(found,envvar.length()+1,expanded);
+        found = file.find('$');
     }
+}
 
-    int x = std::numeric_limits<int>::max();
-    bool discard_formulas = false;
-    for(int i = 3; i < argc; ++i) {
-        std::string arg = argv[i];
-        if (arg.compare("--discard_formulas") == 0) {
-            discard_formulas = true;
-            std::cout << "discarding formulas when not needed anymore" << std::endl;
-        } else if (arg.substr(0,10).compare("--timeout=") == 0) {
-            std::istringstream ss(arg.substr(10));
-            if (!(ss >> x) || x < 0) {
-                std::cout << "Usage: verify <task-file> <certificate-file> [--timeout=x] [--discard_formulas]" << std::endl;
-                std::cout << "timeout is an optional parameter in seconds" << std::endl;
-                exit(0);
-            }
-            std::cout << "using timeout of " << x << " seconds" << std::endl;
-        } else {
-            std::cout << "Usage: verify <task-file> <certificate-file> [--timeout=x] [--discard_formulas]" << std::endl;
-            std::cout << "timeout is an optional parameter in seconds" << std::endl;
-            exit(0);
-        }
-    }
-    set_timeout(x);
-    set_discard_formulas(discard_formulas);
-    Task* task = new Task(task_file);
-
+// sets up the Cudd manager for the task
+void prepare_task(Task *task, bool reorder_bdds) {
     manager = Cudd(task->get_number_of_facts()*2);
     manager.setTimeoutHandler(exit_timeout);
     manager.InstallOutOfMemoryHandler(exit_oom);
     manager.UnregisterOutOfMemoryCallback();
+    if (reorder_bdds) {
+        BDDFile::enable_reordering(task);
+    }
     std::cout << "Amount of Actions: " << task->get_number_of_actions() << std::endl;
+}
+
+// additionally builds the action formulas of all formalisms, which are shared by all batch jobs
+void precompile_task(Task *task, bool reorder_bdds) {
+    prepare_task(task, reorder_bdds);
+    // the dummy formulas initialize the util of their formalism
+    SetFormulaHorn horn(task);
+    SetFormulaDualHorn dualhorn(task);
+    SetFormulaTwoCNF twocnf(task);
+    SetFormulaExplicit explicit_formula(task);
+    if (reorder_bdds) {
+        // all BDD files are loaded into the identity order
+        std::vector<int> varorder(task->get_number_of_facts());
+        for(size_t i = 0; i < varorder.size(); ++i) {
+            varorder[i] = i;
+        }
+        BDDFile::precompile_util(task, varorder);
+    }
+}
 
-    ProofChecker proofchecker;
-    if (discard_formulas) {
+void verify_certificate(Task *task, const std::string &certificate_file,
+                        int threads, bool discard_formulas) {
+    ProofChecker proofchecker(threads);
+    if (BinaryProofReader::is_binary_proof(certificate_file)) {
+        std::cout << "reading binary proof" << std::endl;
+        BinaryProofReader reader(certificate_file);
+        if (discard_formulas) {
+            std::vector<KnowledgeIndex> last_occ;
+            reader.read_last_occ(last_occ);
+            proofchecker.set_last_occ(last_occ);
+        }
+        reader.check_proof(proofchecker, task);
+        print_result_and_exit(proofchecker);
+    }
+    if (discard_formulas && !proofchecker.read_last_occ_trailer(certificate_file)) {
         proofchecker.first_pass(certificate_file);
     }
 
@@ -315,13 +331,66 @@ int main(int argc, char** argv) {
         }
     }
 
-    std::cout << "Verify total time: " << timer() << std::endl;
-    std::cout << "Verify memory: " << get_peak_memory_in_kb() << "KB" << std::endl;
-    if(proofchecker.is_unsolvability_proven()) {
-        std::cout << "unsolvability proven" << std::endl;
-        exit_with(ExitCode::CERTIFICATE_VALID);
-    } else {
-        std::cout << "unsolvability NOT proven" << std::endl;
-        exit_with(ExitCode::CERTIFICATE_NOT_VALID);
+    print_result_and_exit(proofchecker);
+}
+
+int main(int argc, char** argv) {
+    bool batch = argc > 1 && std::string(argv[1]).compare("--batch") == 0;
+    int first_option = batch ? 2 : 3;
+    if(argc < first_option || argc > first_option + 4) {
+        print_usage_and_exit();
     }
+    register_event_handlers();
+    initialize_timer();
+
+    int x = std::numeric_limits<int>::max();
+    bool discard_formulas = false;
+    int threads = 1;
+    bool reorder_bdds = false;
+    for(int i = first_option; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.compare("--discard_formulas") == 0) {
+            discard_formulas = true;
+            std::cout << "discarding formulas when not needed anymore" << std::endl;
+        } else if (arg.compare("--reorder_bdds") == 0) {
+            reorder_bdds = true;
+            std::cout << "using dynamic variable reordering for BDDs" << std::endl;
+        } else if (arg.substr(0,10).compare("--timeout=") == 0) {
+            std::istringstream ss(arg.substr(10));
+            if (!(ss >> x) || x < 0) {
+                print_usage_and_exit();
+            }
+            std::cout << "using timeout of " << x << " seconds" << std::endl;
+        } else if (arg.substr(0,10).compare("--threads=") == 0) {
+            std::istringstream ss(arg.substr(10));
+            if (!(ss >> threads) || threads < 1) {
+                print_usage_and_exit();
+            }
+            std::cout << "using " << threads << " worker threads" << std::endl;
+        } else {
+            print_usage_and_exit();
+        }
+    }
+    set_timeout(x);
+    set_discard_formulas(discard_formulas);
+
+    if (batch) {
+        BatchVerifier verifier(
+            [reorder_bdds](Task *task) {
+                precompile_task(task, reorder_bdds);
+            },
+            [threads, discard_formulas](Task *task, const std::string &certificate_file) {
+                verify_certificate(task, certificate_file, threads, discard_formulas);
+            });
+        verifier.run(std::cin);
+        return 0;
+    }
+
+    std::string task_file = argv[1];
+    std::string certificate_file = argv[2];
+    expand_environment_variables(task_file);
+    expand_environment_variables(certificate_file);
+    Task* task = new Task(task_file);
+    prepare_task(task, reorder_bdds);
+    verify_certificate(task, certificate_file, threads, discard_formulas);
 }
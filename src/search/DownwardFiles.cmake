@@ -79,6 +79,9 @@ fast_downward_plugin(
         state_registry
         task_id
         task_proxy
+        unsolvability/binary_proof_buffer
+        unsolvability/last_occ_tracker
+        unsolvability/text_proof_buffer
         unsolvability/unsolvabilitymanager
 
     DEPENDS CAUSAL_GRAPH INT_HASH_SET INT_PACKER ORDERED_SET SEGMENTED_VECTOR SUBSCRIBER SUCCESSOR_GENERATOR TASK_PROPERTIES
@@ -319,7 +319,7 @@ std::pair<int,int> HMHeuristic::get_set_and_deadknowledge_id(
     }
 
     int setid = unsolvmanager.get_new_setid();
-    std::ofstream &certstream = unsolvmanager.get_stream();
+    std::ostream &certstream = unsolvmanager.get_stream();
     certstream << "e " << setid << " h p cnf " << strips_varamount << " " << clauseamount << " ";
     certstream << mutexes << tuples.str() << ";\n";
 
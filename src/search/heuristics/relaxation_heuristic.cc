@@ -379,7 +379,7 @@ std::pair<int,int> RelaxationHeuristic::get_set_and_deadknowledge_id(
     if(ids.first == -1) {
         int setid = unsolvmanager.get_new_setid();
 
-        std::ofstream &certstream = unsolvmanager.get_stream();
+        std::ostream &certstream = unsolvmanager.get_stream();
         certstream << "e " << setid << " b " << bdd_filename << " " << bddindex << " ;\n";
         int progid = unsolvmanager.get_new_setid();
         certstream << "e " << progid << " p " << setid << " 0" << "\n";
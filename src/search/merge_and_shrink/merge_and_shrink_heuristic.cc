@@ -192,7 +192,7 @@ std::pair<int,int> MergeAndShrinkHeuristic::get_set_and_deadknowledge_id(
 
         setid = unsolvmanager.get_new_setid();
 
-        std::ofstream &certstream = unsolvmanager.get_stream();
+        std::ostream &certstream = unsolvmanager.get_stream();
 
         certstream << "e " << setid << " b " << bdd_filename << " 0 ;\n";
         int progid = unsolvmanager.get_new_setid();
@@ -188,6 +188,37 @@ void SearchEngine::add_unsolvability_options(OptionParser &parser) {
         "The directory in which the unsolvability verification should be written."
         "Defaults to current directory if none is set.",
         ".");
+    vector<string> proof_formats;
+    proof_formats.push_back("TEXT");
+    proof_formats.push_back("BINARY");
+    parser.add_enum_option(
+        "unsolv_proof_format", proof_formats,
+        "format of the proof file: TEXT writes proof.txt, BINARY writes the "
+        "compact encoding proof.bin (only used for PROOF and PROOF_DISCARD)",
+        "TEXT");
+    vector<string> bdd_formats;
+    bdd_formats.push_back("TEXT");
+    bdd_formats.push_back("BINARY");
+    parser.add_enum_option(
+        "unsolv_bdd_format", bdd_formats,
+        "DDDMP mode of the dumped BDD files (the verifiers detect it "
+        "automatically). CERTIFICATE_FASTDUMP writes the states by hand and "
+        "thus always uses TEXT for states.bdd",
+        "TEXT");
+    parser.add_option<int>(
+        "unsolv_state_group_size",
+        "CERTIFICATE only: number of closed states (in expansion order) that "
+        "share one BDD in states.bdd. The hints then refer to these groups. "
+        "1 writes one BDD per state.",
+        "1",
+        Bounds("1", "infinity"));
+    parser.add_option<int>(
+        "unsolv_proof_threads",
+        "PROOF only: number of threads used for building the BDDs and explicit "
+        "sets of the dead ends and expanded states when writing the proof. "
+        "Each thread uses its own CUDD manager.",
+        "1",
+        Bounds("1", "infinity"));
 }
 
 void print_initial_evaluator_values(const EvaluationContext &eval_context) {
@@ -11,17 +11,25 @@
 #include "../task_utils/successor_generator.h"
 
 #include "../utils/logging.h"
+#include "../utils/memory.h"
 
 #include "../unsolvability/unsolvabilitymanager.h"
 
 #include <cassert>
+#include <cstdio>
 #include <cstdlib>
+#include <functional>
+#include <map>
 #include <memory>
 #include <optional.hh>
 #include <set>
 #include <fstream>
+#include <sstream>
 #include <stdlib.h>
+#include <thread>
+#include <unordered_map>
 #include <math.h>
+#include <algorithm>
 #include <array>
 #include <regex>
 
@@ -38,7 +46,10 @@ EagerSearch::EagerSearch(const Options &opts)
       preferred_operator_evaluators(opts.get_list<shared_ptr<Evaluator>>("preferred")),
       lazy_evaluator(opts.get<shared_ptr<Evaluator>>("lazy_evaluator", nullptr)),
       pruning_method(opts.get<shared_ptr<PruningMethod>>("pruning")),
-      unsolvability_directory(opts.get<std::string>("unsolv_directory")) {
+      unsolvability_directory(opts.get<std::string>("unsolv_directory")),
+      unsolv_proof_format(static_cast<ProofFormat>(opts.get<int>("unsolv_proof_format"))),
+      unsolv_state_group_size(opts.get<int>("unsolv_state_group_size")),
+      unsolv_proof_threads(opts.get<int>("unsolv_proof_threads")) {
     if (lazy_evaluator && !lazy_evaluator->does_cache_estimates()) {
         cerr << "lazy_evaluator must cache its estimates" << endl;
         utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
@@ -76,6 +87,10 @@ EagerSearch::EagerSearch(const Options &opts)
         } else if (unsolv_type == UnsolvabilityVerificationType::PROOF) {
             CuddManager::set_compact_proof(true);
         }
+        // 1 = BINARY
+        if (opts.get<int>("unsolv_bdd_format") == 1) {
+            CuddManager::set_binary_dump(true);
+        }
     }
 }
 
@@ -153,7 +168,10 @@ void EagerSearch::initialize() {
 
     pruning_method->initialize(task);
 
-    if(unsolv_type == UnsolvabilityVerificationType::CERTIFICATE ||
+    if(uses_state_groups()) {
+        // the hints are rewritten per group in write_grouped_states
+        unsolvability_certificate_hints.open(unsolvability_directory + "state_hints.txt");
+    } else if(unsolv_type == UnsolvabilityVerificationType::CERTIFICATE ||
             unsolv_type == UnsolvabilityVerificationType::CERTIFICATE_FASTDUMP) {
         unsolvability_certificate_hints.open(unsolvability_directory + "hints.txt");
     }
@@ -487,6 +505,116 @@ void dump_statebdd(const GlobalState &s, std::ofstream &statebdd_file,
     statebdd_file << ".end\n";
 }
 
+bool EagerSearch::uses_state_groups() const {
+    return unsolv_type == UnsolvabilityVerificationType::CERTIFICATE
+            && unsolv_state_group_size > 1;
+}
+
+/*
+  Groups the closed states into BDDs of unsolv_state_group_size states each
+  (in the order in which they were expanded) and rewrites the per-state hints
+  from state_hints.txt into hints.txt, which then has the form
+    grouped hints
+    <group> <#actions> (<action> <#targets> <target>*)*
+    ...
+    end hints
+  A group is identified by the id of its first state. The successors of all
+  states in the group under an action should be contained in the union of the
+  targets; if they are not (-1 or pruned operators), the verifier falls back
+  to checking self- or r-inductivity for this action.
+*/
+void EagerSearch::write_grouped_states(const std::string &statebdd_file,
+                                       std::vector<int> &varorder) {
+    std::string state_hints_filename = unsolvability_directory + "state_hints.txt";
+    std::vector<int> state_group(state_registry.size(), -1);
+
+    // first pass: assign groups in expansion order
+    std::ifstream state_hints(state_hints_filename);
+    std::string line;
+    std::vector<int> group_ids;
+    int members = 0;
+    while (std::getline(state_hints, line) && line != "end hints") {
+        int stateid = std::stoi(line.substr(0, line.find(' ')));
+        if (state_group[stateid] != -1) {
+            // state was reopened and expanded again
+            continue;
+        }
+        if (members == 0) {
+            group_ids.push_back(stateid);
+        }
+        state_group[stateid] = group_ids.back();
+        members = (members + 1) % unsolv_state_group_size;
+    }
+    state_hints.close();
+
+    // second pass: merge the hints of each group
+    state_hints.open(state_hints_filename);
+    std::ofstream group_hints(unsolvability_directory + "hints.txt");
+    group_hints << "grouped hints\n";
+    std::vector<bool> written(state_registry.size(), false);
+    std::map<int, std::set<int>> action_targets;
+    int current_group = -1;
+    auto write_group = [&]() {
+        if (current_group == -1) {
+            return;
+        }
+        group_hints << current_group << " " << action_targets.size();
+        for (const auto &entry : action_targets) {
+            group_hints << " " << entry.first << " " << entry.second.size();
+            for (int target : entry.second) {
+                group_hints << " " << target;
+            }
+        }
+        group_hints << "\n";
+        action_targets.clear();
+    };
+    while (std::getline(state_hints, line) && line != "end hints") {
+        std::istringstream hint_line(line);
+        int stateid, amount;
+        hint_line >> stateid >> amount;
+        if (written[stateid]) {
+            continue;
+        }
+        written[stateid] = true;
+        if (state_group[stateid] != current_group) {
+            write_group();
+            current_group = state_group[stateid];
+        }
+        for (int i = 0; i < amount; ++i) {
+            int action, target;
+            hint_line >> action >> target;
+            // closed states are represented by their group
+            if (target >= 0 && target < static_cast<int>(state_group.size())
+                    && state_group[target] != -1) {
+                target = state_group[target];
+            }
+            action_targets[action].insert(target);
+        }
+    }
+    write_group();
+    group_hints << "end hints";
+    group_hints.close();
+    state_hints.close();
+    std::remove(state_hints_filename.c_str());
+
+    CuddManager cudd_manager(task, varorder);
+    std::vector<CuddBDD> groupbdds;
+    groupbdds.reserve(group_ids.size());
+    std::unordered_map<int, int> group_position;
+    for (size_t i = 0; i < group_ids.size(); ++i) {
+        group_position[group_ids[i]] = i;
+        groupbdds.push_back(CuddBDD(&cudd_manager, false));
+    }
+    for (const StateID id : state_registry) {
+        int group = state_group[id.get_value()];
+        if (group != -1) {
+            const GlobalState &state = state_registry.lookup_state(id);
+            groupbdds[group_position[group]].lor(CuddBDD(&cudd_manager, state));
+        }
+    }
+    cudd_manager.dumpBDDs_certificate(groupbdds, group_ids, statebdd_file);
+}
+
 void EagerSearch::write_unsolvability_certificate() {
     if (unsolv_type == UnsolvabilityVerificationType::CERTIFICATE_NOHINTS) {
         unsolvability_certificate_hints.open(unsolvability_directory + "hints.txt");
@@ -516,16 +644,36 @@ void EagerSearch::write_unsolvability_certificate() {
     }
 
     std::string statebdd_file = unsolvability_directory + "states.bdd";
-    if (unsolv_type == UnsolvabilityVerificationType::CERTIFICATE_FASTDUMP) {
+    if (uses_state_groups()) {
+        write_grouped_states(statebdd_file, varorder);
+    } else if (unsolv_type == UnsolvabilityVerificationType::CERTIFICATE_FASTDUMP) {
+        /*
+          The closed states are dumped in expansion order, which is the order
+          of the hints. This allows the verifier to stream the certificate
+          (see verify --stream) and release the bdd of a state soon after
+          the hints using it have been checked.
+        */
+        std::vector<StateID> state_ids;
+        state_ids.reserve(state_registry.size());
+        for (const StateID id : state_registry) {
+            state_ids.push_back(id);
+        }
+        std::vector<bool> dumped(state_registry.size(), false);
+        std::ifstream hints(unsolvability_directory + "hints.txt");
         std::ofstream stream;
         stream.open(statebdd_file);
-        for(const StateID id : state_registry) {
-            // dump bdds of closed states
-            const GlobalState &state = state_registry.lookup_state(id);
-            if(search_space.get_node(state).is_closed()) {
-                dump_statebdd(state, stream, varamount, fact_to_var);
+        std::string line;
+        while (std::getline(hints, line) && line != "end hints") {
+            int stateid = std::stoi(line.substr(0, line.find(' ')));
+            if (dumped[stateid]) {
+                // state was reopened and expanded again
+                continue;
             }
+            dumped[stateid] = true;
+            const GlobalState &state = state_registry.lookup_state(state_ids[stateid]);
+            dump_statebdd(state, stream, varamount, fact_to_var);
         }
+        hints.close();
         stream.close();
     } else {
         std::vector<CuddBDD> statebdds(0);
@@ -551,8 +699,9 @@ void EagerSearch::write_unsolvability_certificate() {
     cert_file.open(unsolvability_directory + "certificate.txt");
     cert_file << "certificate-type:disjunctive:1\n";
     cert_file << "bdd-files:2\n";
-    cert_file << unsolvability_directory << "states.bdd\n";
+    // the dead end bdds are hint targets throughout, so they are read first when streaming
     cert_file << unsolvability_directory << "h_cert.bdd\n";
+    cert_file << unsolvability_directory << "states.bdd\n";
     cert_file << "hints:" << unsolvability_directory << "hints.txt\n";
     cert_file.close();
 
@@ -569,8 +718,8 @@ void EagerSearch::write_unsolvability_certificate() {
 void EagerSearch::write_unsolvability_proof() {
     double writing_start = utils::g_timer();
 
-    UnsolvabilityManager unsolvmgr(unsolvability_directory, task);
-    std::ofstream &certstream = unsolvmgr.get_stream();
+    UnsolvabilityManager unsolvmgr(unsolvability_directory, task, unsolv_proof_format);
+    std::ostream &certstream = unsolvmgr.get_stream();
     std::vector<int> varorder(task_proxy.get_variables().size());
     for(size_t i = 0; i < varorder.size(); ++i) {
         varorder[i] = i;
@@ -611,110 +760,128 @@ void EagerSearch::write_unsolvability_proof() {
         return;
     }
 
-    struct MergeTreeEntry {
-        int de_pos_begin;
-        int setid;
-        int k_set_dead;
-        int depth;
-    };
-
     CuddManager manager(task);
-    std::vector<StateID> dead_ends;
-    int dead_end_amount = statistics.get_dead_ends();
-    dead_ends.reserve(dead_end_amount);
-
-    std::vector<MergeTreeEntry> merge_tree;
-    if (dead_end_amount > 0) {
-        merge_tree.resize(ceil(log2(dead_end_amount+1)));
-    }
-    // mt_pos is the index of the first unused entry of merge_tree
-    int mt_pos = 0;
-
-    CuddBDD expanded = CuddBDD(&manager, false);
-    CuddBDD dead = CuddBDD(&manager, false);
 
     int fact_amount = 0;
     for(size_t i = 0; i < varorder.size(); ++i) {
         fact_amount += task_proxy.get_variables()[varorder[i]].get_domain_size();
     }
 
+    /*
+      The heuristics and the search space are not thread-safe, so we first
+      sequentially collect the dead ends and expanded states and let the
+      heuristic prove each dead end.
+     */
+    struct DeadEndProof {
+        StateID id;
+        std::pair<int,int> dead_superset;
+        int setid;
+        int k_subset;
+        int k_dead;
+    };
+    std::vector<DeadEndProof> dead_ends;
+    std::vector<StateID> expanded_states;
+    dead_ends.reserve(statistics.get_dead_ends());
+    expanded_states.reserve(statistics.get_expanded());
     for(const StateID id : state_registry) {
         const GlobalState &state = state_registry.lookup_state(id);
-        CuddBDD statebdd = CuddBDD(&manager, state);
         if (search_space.get_node(state).is_dead_end()) {
-
-            dead.lor(statebdd);
-            dead_ends.push_back(id);
-
             EvaluationContext eval_context(state,
                                            0,
                                            false, &statistics);
             std::pair<int,int> dead_superset =
                     open_list->get_set_and_deadknowledge_id(eval_context, unsolvmgr);
+            dead_ends.push_back({id, dead_superset, -1, -1, -1});
+        } else if(search_space.get_node(state).is_closed()) {
+            expanded_states.push_back(id);
+        }
+    }
+    for (DeadEndProof &dead_end : dead_ends) {
+        dead_end.setid = unsolvmgr.get_new_setid();
+        dead_end.k_subset = unsolvmgr.get_new_knowledgeid();
+        dead_end.k_dead = unsolvmgr.get_new_knowledgeid();
+    }
 
-            // prove that an explicit set only containing dead end is dead
-            int expl_state_setid = unsolvmgr.get_new_setid();
-            certstream << "e " << expl_state_setid << " e ";
-            certstream << fact_amount << " ";
-            for (int i = 0; i < fact_amount; ++i) {
-                certstream << i << " ";
-            }
-            certstream << ": ";
-            unsolvmgr.dump_state(state);
-            certstream << " ;\n";
-            int k_expl_state_subset = unsolvmgr.get_new_knowledgeid();
-            certstream << "k " << k_expl_state_subset << " s " << expl_state_setid << " "
-                       << dead_superset.first << " b4\n";
-            int k_expl_state_dead = unsolvmgr.get_new_knowledgeid();
-            certstream << "k " << k_expl_state_dead << " d " << expl_state_setid
-                       << " d3 " << k_expl_state_subset << " " << dead_superset.second << "\n";
-
-            merge_tree[mt_pos].de_pos_begin = dead_ends.size()-1;
-            merge_tree[mt_pos].setid = expl_state_setid;
-            merge_tree[mt_pos].k_set_dead = k_expl_state_dead;
-            merge_tree[mt_pos].depth = 0;
-            mt_pos++;
-
-            // merge the last 2 sets to a new one if they have the same depth in the merge tree
-            while(mt_pos > 1 && merge_tree[mt_pos-1].depth == merge_tree[mt_pos-2].depth) {
-                MergeTreeEntry &mte_left = merge_tree[mt_pos-2];
-                MergeTreeEntry &mte_right = merge_tree[mt_pos-1];
-
-                // show that implicit union between the two sets is dead
-                int impl_union = unsolvmgr.get_new_setid();
-                certstream << "e " << impl_union << " u "
-                           << mte_left.setid << " " << mte_right.setid << "\n";
-                int k_impl_union_dead = unsolvmgr.get_new_knowledgeid();
-                certstream << "k " << k_impl_union_dead << " d " << impl_union
-                           << " d2 " << mte_left.k_set_dead << " " << mte_right.k_set_dead << "\n";
-
-
-                // build new explicit union and show that it is dead
-                /*int union_setid = unsolvmgr.get_new_setid();
-                certstream << "e " << union_setid << " e ";
-                for(int i = mte_left.de_pos_begin;
-                    i < mte_left.de_pos_begin + 2*(1 << mte_left.depth); ++i) {
-                    unsolvmgr.dump_state(state_registry.lookup_state(dead_ends[i]));
-                    certstream << " ";
-                }
-                certstream << ";\n";
-                int k_union_subset = unsolvmgr.get_new_knowledgeid();
-                certstream << "k " << k_union_subset << " s "
-                           << union_setid << " " << impl_union << " b1\n";
-                int k_union_dead = unsolvmgr.get_new_knowledgeid();
-                certstream << "k " << k_union_dead << " d " << union_setid << " d3 "
-                           << k_union_subset << " " << k_impl_union_dead << "\n";*/
-
-                // the left entry represents the merged entry while the right entry will be considered deleted
-                mte_left.depth++;
-                mte_left.setid = impl_union;
-                mte_left.k_set_dead = k_impl_union_dead;
-                mt_pos--;
-            }
+    /*
+      The dead ends and expanded states are partitioned into consecutive
+      blocks. For each block we build the BDD unions in a separate CUDD manager
+      and write the proof that each dead end (as explicit set) is dead into a
+      buffer. The buffers are then written in order and the BDDs transferred
+      to the main manager.
+     */
+    struct ProofPartition {
+        // declared first such that the BDDs are destroyed before their manager
+        std::unique_ptr<CuddManager> manager;
+        std::unique_ptr<CuddBDD> dead;
+        std::unique_ptr<CuddBDD> expanded;
+        std::string dead_end_proofs;
+        std::string dead_end_states;
+    };
+    int partition_amount = std::max(1, std::min<int>(unsolv_proof_threads,
+            std::max(dead_ends.size(), expanded_states.size())));
+    std::vector<ProofPartition> partitions(partition_amount);
+
+    std::ostringstream explicit_header;
+    explicit_header << fact_amount << " ";
+    for (int i = 0; i < fact_amount; ++i) {
+        explicit_header << i << " ";
+    }
+    explicit_header << ": ";
+    const std::string explicit_vars = explicit_header.str();
+
+    auto build_partition = [&](int p) {
+        ProofPartition &partition = partitions[p];
+        partition.manager = utils::make_unique_ptr<CuddManager>(task);
+        partition.dead = utils::make_unique_ptr<CuddBDD>(partition.manager.get(), false);
+        partition.expanded = utils::make_unique_ptr<CuddBDD>(partition.manager.get(), false);
+        std::ostringstream proofs;
+        std::ostringstream states;
+
+        size_t begin = dead_ends.size() * p / partition_amount;
+        size_t end = dead_ends.size() * (p+1) / partition_amount;
+        for (size_t i = begin; i < end; ++i) {
+            const DeadEndProof &dead_end = dead_ends[i];
+            const GlobalState &state = state_registry.lookup_state(dead_end.id);
+            partition.dead->lor(CuddBDD(partition.manager.get(), state));
 
-        } else if(search_space.get_node(state).is_closed()) {
-            expanded.lor(statebdd);
+            // prove that an explicit set only containing dead end is dead
+            proofs << "e " << dead_end.setid << " e " << explicit_vars;
+            unsolvmgr.dump_state(state, proofs);
+            proofs << " ;\n";
+            proofs << "k " << dead_end.k_subset << " s " << dead_end.setid << " "
+                   << dead_end.dead_superset.first << " b4\n";
+            proofs << "k " << dead_end.k_dead << " d " << dead_end.setid
+                   << " d3 " << dead_end.k_subset << " " << dead_end.dead_superset.second << "\n";
+
+            unsolvmgr.dump_state(state, states);
+            states << " ";
+        }
+        partition.dead_end_proofs = proofs.str();
+        partition.dead_end_states = states.str();
+
+        begin = expanded_states.size() * p / partition_amount;
+        end = expanded_states.size() * (p+1) / partition_amount;
+        for (size_t i = begin; i < end; ++i) {
+            const GlobalState &state = state_registry.lookup_state(expanded_states[i]);
+            partition.expanded->lor(CuddBDD(partition.manager.get(), state));
         }
+    };
+    std::vector<std::thread> workers;
+    for (int p = 1; p < partition_amount; ++p) {
+        workers.emplace_back(build_partition, p);
+    }
+    build_partition(0);
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    CuddBDD expanded = CuddBDD(&manager, false);
+    CuddBDD dead = CuddBDD(&manager, false);
+    for (ProofPartition &partition : partitions) {
+        certstream << partition.dead_end_proofs;
+        partition.dead_end_proofs.clear();
+        dead.lor(CuddBDD(&manager, *partition.dead));
+        expanded.lor(CuddBDD(&manager, *partition.expanded));
     }
 
     std::vector<CuddBDD> bdds;
@@ -726,66 +893,46 @@ void EagerSearch::write_unsolvability_proof() {
         de_setid = unsolvmgr.get_emptysetid();
         k_de_dead = unsolvmgr.get_k_empty_dead();
     } else {
-        // if the merge tree is not a complete binary tree, we first need to shrink it up to size 1
-        // TODO: this is copy paste from above...
-        while(mt_pos > 1) {
-            MergeTreeEntry &mte_left = merge_tree[mt_pos-2];
-            MergeTreeEntry &mte_right = merge_tree[mt_pos-1];
-
-            // show that implicit union between the two sets is dead
+        /*
+          Show that the implicit union over all dead ends is dead by merging
+          the explicit sets along a balanced binary tree.
+          Returns the setid of the union and the knowledge id showing it is dead.
+         */
+        std::function<std::pair<int,int>(size_t, size_t)> merge_dead_ends =
+                [&](size_t begin, size_t end) -> std::pair<int,int> {
+            if (end - begin == 1) {
+                return std::make_pair(dead_ends[begin].setid, dead_ends[begin].k_dead);
+            }
+            size_t middle = begin + (end - begin) / 2;
+            std::pair<int,int> left = merge_dead_ends(begin, middle);
+            std::pair<int,int> right = merge_dead_ends(middle, end);
             int impl_union = unsolvmgr.get_new_setid();
             certstream << "e " << impl_union << " u "
-                       << mte_left.setid << " " << mte_right.setid << "\n";
+                       << left.first << " " << right.first << "\n";
             int k_impl_union_dead = unsolvmgr.get_new_knowledgeid();
             certstream << "k " << k_impl_union_dead << " d " << impl_union
-                       << " d2 " << mte_left.k_set_dead << " " << mte_right.k_set_dead << "\n";
-
-            // build new explicit union and show that it is dead
-            /*int union_setid = unsolvmgr.get_new_setid();
-            certstream << "e " << union_setid << " e ";
-            for(size_t i = mte_left.de_pos_begin; i < dead_ends.size(); ++i) {
-                unsolvmgr.dump_state(state_registry.lookup_state(dead_ends[i]));
-                certstream << " ";
-            }
-            certstream << ";\n";
-            int k_union_subset = unsolvmgr.get_new_knowledgeid();
-            certstream << "k " << k_union_subset << " s "
-                       << union_setid << " " << impl_union << " b1\n";
-            int k_union_dead = unsolvmgr.get_new_knowledgeid();
-            certstream << "k " << k_union_dead << " d " << union_setid << " d3 "
-                       << k_union_subset << " " << k_impl_union_dead << "\n";*/
-
-            mt_pos--;
-            merge_tree[mt_pos-1].depth++;
-            merge_tree[mt_pos-1].setid = impl_union;
-            merge_tree[mt_pos-1].k_set_dead = k_impl_union_dead;
-        }
+                       << " d2 " << left.second << " " << right.second << "\n";
+            return std::make_pair(impl_union, k_impl_union_dead);
+        };
+        std::pair<int,int> dead_end_union = merge_dead_ends(0, dead_ends.size());
         bdds.push_back(dead);
 
         // build an explicit set containing all dead ends
         int all_de_explicit = unsolvmgr.get_new_setid();
-        certstream << "e " << all_de_explicit << " e ";
-        certstream << fact_amount << " ";
-        for (int i = 0; i < fact_amount; ++i) {
-            certstream << i << " ";
-        }
-        certstream << ": ";
-        for(const StateID id : state_registry) {
-            const GlobalState &state = state_registry.lookup_state(id);
-            if (search_space.get_node(state).is_dead_end()) {
-                unsolvmgr.dump_state(state);
-                certstream << " ";
-            }
+        certstream << "e " << all_de_explicit << " e " << explicit_vars;
+        for (ProofPartition &partition : partitions) {
+            certstream << partition.dead_end_states;
+            partition.dead_end_states.clear();
         }
         certstream << ";\n";
 
         // show that all_de_explicit is a subset to the union of all dead ends and thus dead
         int k_all_de_explicit_subset = unsolvmgr.get_new_knowledgeid();
         certstream << "k " << k_all_de_explicit_subset << " s "
-                   << all_de_explicit << " " << merge_tree[0].setid << " b1\n";
+                   << all_de_explicit << " " << dead_end_union.first << " b1\n";
         int k_all_de_explicit_dead = unsolvmgr.get_new_knowledgeid();
         certstream << "k " << k_all_de_explicit_dead << " d " << all_de_explicit
-                   << " d3 " << k_all_de_explicit_subset << " " << merge_tree[0].k_set_dead << "\n";
+                   << " d3 " << k_all_de_explicit_subset << " " << dead_end_union.second << "\n";
 
         // show that the bdd containing all dead ends is a subset to the explicit set containing all dead ends
         int bdd_dead_setid = unsolvmgr.get_new_setid();
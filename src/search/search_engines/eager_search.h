@@ -5,6 +5,7 @@
 #include "../search_engine.h"
 
 #include "../unsolvability/cudd_interface.h"
+#include "../unsolvability/unsolvabilitymanager.h"
 
 #include <memory>
 #include <vector>
@@ -46,6 +47,14 @@ class EagerSearch : public SearchEngine {
 
     std::string unsolvability_directory;
     std::ofstream unsolvability_certificate_hints;
+    const ProofFormat unsolv_proof_format;
+    // amount of closed states sharing one BDD in the certificate (1 = one BDD per state)
+    const int unsolv_state_group_size;
+    // amount of threads for writing the dead end part of the proof
+    const int unsolv_proof_threads;
+
+    bool uses_state_groups() const;
+    void write_grouped_states(const std::string &statebdd_file, std::vector<int> &varorder);
 
 protected:
     virtual void initialize() override;
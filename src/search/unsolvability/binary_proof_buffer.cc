@@ -0,0 +1,192 @@
+#include "binary_proof_buffer.h"
+
+#include "../utils/system.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+static const char HEADER_MAGIC[] = "UPRF";
+static const char FOOTER_MAGIC[] = "UPRE";
+static const unsigned char FORMAT_VERSION = 1;
+
+using namespace proof_parsing;
+
+BinaryProofBuffer::BinaryProofBuffer(const string &filename)
+    : out(filename, ios::binary), finished(false) {
+    out.write(HEADER_MAGIC, 4);
+    write_byte(FORMAT_VERSION);
+}
+
+BinaryProofBuffer::~BinaryProofBuffer() {
+    finish();
+}
+
+void BinaryProofBuffer::write_byte(unsigned char byte) {
+    out.put(byte);
+}
+
+void BinaryProofBuffer::write_varint(int value) {
+    assert(value >= 0);
+    unsigned int v = value;
+    while (v >= 0x80) {
+        write_byte((v & 0x7f) | 0x80);
+        v >>= 7;
+    }
+    write_byte(v);
+}
+
+BinaryProofBuffer::int_type BinaryProofBuffer::overflow(int_type c) {
+    if (traits_type::eq_int_type(c, traits_type::eof())) {
+        return traits_type::not_eof(c);
+    }
+    char ch = traits_type::to_char_type(c);
+    if (ch == '\n') {
+        encode_line();
+    } else {
+        line.push_back(ch);
+    }
+    return c;
+}
+
+streamsize BinaryProofBuffer::xsputn(const char *s, streamsize n) {
+    const char *end = s + n;
+    while (s != end) {
+        const char *newline = static_cast<const char *>(memchr(s, '\n', end - s));
+        if (!newline) {
+            line.append(s, end);
+            break;
+        }
+        line.append(s, newline);
+        encode_line();
+        s = newline + 1;
+    }
+    return n;
+}
+
+void BinaryProofBuffer::encode_line() {
+    const char *pos = line.c_str();
+    skip_spaces(pos);
+    if (*pos == 'e' && pos[1] == ' ') {
+        encode_expression(pos + 1);
+    } else if (*pos == 'k' && pos[1] == ' ') {
+        encode_knowledge(pos + 1);
+    } else if (*pos == 'a' && pos[1] == ' ') {
+        encode_actionset(pos + 1);
+    } else if (*pos != '#' && *pos != '\0') {
+        cerr << "Binary proof: unknown start of line: " << line << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+    line.clear();
+}
+
+void BinaryProofBuffer::encode_expression(const char *pos) {
+    int setid = parse_int(pos);
+    string type = parse_word(pos);
+    write_byte('e');
+    write_varint(setid);
+    write_byte(type[0]);
+    if (type == "n" || type == "p" || type == "r") {
+        int subset = parse_int(pos);
+        write_varint(subset);
+        if (type != "n") {
+            write_varint(parse_int(pos));
+        }
+        last_occ_tracker.add_compound_set(setid, subset);
+    } else if (type == "i" || type == "u") {
+        int left = parse_int(pos);
+        int right = parse_int(pos);
+        write_varint(left);
+        write_varint(right);
+        last_occ_tracker.add_compound_set(setid, left, right);
+    } else {
+        last_occ_tracker.add_basic_set(setid, type == "c");
+        skip_spaces(pos);
+        size_t length = line.c_str() + line.size() - pos;
+        write_varint(length);
+        out.write(pos, length);
+    }
+}
+
+void BinaryProofBuffer::encode_actionset(const char *pos) {
+    int actionsetid = parse_int(pos);
+    string type = parse_word(pos);
+    write_byte('a');
+    write_varint(actionsetid);
+    write_byte(type[0]);
+    if (type == "b") {
+        int amount = parse_int(pos);
+        write_varint(amount);
+        for (int i = 0; i < amount; ++i) {
+            write_varint(parse_int(pos));
+        }
+    } else if (type == "u") {
+        write_varint(parse_int(pos));
+        write_varint(parse_int(pos));
+    }
+}
+
+void BinaryProofBuffer::encode_knowledge(const char *pos) {
+    int kid = parse_int(pos);
+    string kind = parse_word(pos);
+    write_byte('k');
+    write_varint(kid);
+    write_byte(kind[0]);
+    int first = -1;
+    int second = -1;
+    if (kind == "s") {
+        first = parse_int(pos);
+        second = parse_int(pos);
+        write_varint(first);
+        write_varint(second);
+    } else if (kind == "d") {
+        first = parse_int(pos);
+        write_varint(first);
+    }
+    string rule = parse_word(pos);
+    write_byte(rule[0]);
+    write_byte(atoi(rule.c_str() + 1));
+
+    // basic statements B1-B4 need the actual representation of both sets
+    if (kind == "s" && rule[0] == 'b' && rule != "b5") {
+        last_occ_tracker.add_basic_statement(kid, first, second);
+    }
+
+    vector<int> premises;
+    skip_spaces(pos);
+    while (*pos != '\0') {
+        premises.push_back(parse_int(pos));
+        skip_spaces(pos);
+    }
+    write_byte(premises.size());
+    for (int premise : premises) {
+        write_varint(premise);
+    }
+}
+
+void BinaryProofBuffer::finish() {
+    if (finished) {
+        return;
+    }
+    if (!line.empty()) {
+        encode_line();
+    }
+    write_byte('x');
+    uint64_t footer_pos = out.tellp();
+
+    vector<int> last_occ = last_occ_tracker.get_last_occ();
+    write_varint(last_occ.size());
+    for (int kid : last_occ) {
+        write_varint(kid + 1);
+    }
+    for (int i = 0; i < 8; ++i) {
+        write_byte((footer_pos >> (8 * i)) & 0xff);
+    }
+    out.write(FOOTER_MAGIC, 4);
+    out.close();
+    finished = true;
+}
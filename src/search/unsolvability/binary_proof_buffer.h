@@ -0,0 +1,45 @@
+#ifndef UNSOLVABILITY_BINARY_PROOF_BUFFER_H
+#define UNSOLVABILITY_BINARY_PROOF_BUFFER_H
+
+#include "last_occ_tracker.h"
+
+#include <fstream>
+#include <streambuf>
+#include <string>
+
+/*
+  Stream buffer translating the textual proof lines written to
+  UnsolvabilityManager::get_stream() into the binary proof format read by
+  the proof verifier (see BinaryProofReader in src/proof-verifier):
+    - "e", "a" and "k" lines become records with a one byte opcode, one byte
+      type and varint indices; basic sets keep their textual description
+    - comment lines are dropped
+    - a footer stores for each set expression the last knowledge which needs
+      its actual representation, such that the verifier does not need an
+      additional pass over the proof when discarding formulas
+*/
+class BinaryProofBuffer : public std::streambuf {
+    std::ofstream out;
+    std::string line;
+    bool finished;
+
+    LastOccTracker last_occ_tracker;
+
+    void write_byte(unsigned char byte);
+    void write_varint(int value);
+    void encode_line();
+    void encode_expression(const char *pos);
+    void encode_actionset(const char *pos);
+    void encode_knowledge(const char *pos);
+protected:
+    virtual int_type overflow(int_type c) override;
+    virtual std::streamsize xsputn(const char *s, std::streamsize n) override;
+public:
+    explicit BinaryProofBuffer(const std::string &filename);
+    virtual ~BinaryProofBuffer() override;
+
+    // writes the footer; no further lines can be written afterwards
+    void finish();
+};
+
+#endif
@@ -5,6 +5,7 @@
 
 #ifdef USE_CUDD
 #include "dddmp.h"
+#include "../../verifier-common/bdddump.h"
 
 using utils::ExitCode;
 
@@ -13,6 +14,7 @@ void exit_oom(size_t size) {
 }
 
 bool CuddManager::compact_proof = true;
+bool CuddManager::binary_dump = false;
 
 CuddBDD::CuddBDD() : manager(NULL), bdd(NULL) {}
 
@@ -77,6 +79,13 @@ CuddBDD::CuddBDD(const CuddBDD &from) {
     Cudd_Ref(bdd);
 }
 
+CuddBDD::CuddBDD(CuddManager *manager, const CuddBDD &from)
+    : manager(manager) {
+    assert(manager->fact_to_var == from.manager->fact_to_var);
+    bdd = Cudd_bddTransfer(from.manager->ddmgr, manager->ddmgr, from.bdd);
+    Cudd_Ref(bdd);
+}
+
 CuddBDD CuddBDD::operator=(const CuddBDD& right) {
     if (this == &right) {
         return *this;
@@ -209,6 +218,11 @@ const std::vector<std::vector<int> > *CuddManager::get_fact_to_var() const {
     return &fact_to_var;
 }
 
+// the dump format is shared with the verifiers (see verifier-common/bdddump.h)
+void CuddManager::store_bdd_array(int size, DdNode **bdd_arr, FILE *fp) const {
+    store_bdd_dump(ddmgr, size, bdd_arr, binary_dump, fp);
+}
+
 void CuddManager::dumpBDDs_certificate(std::vector<CuddBDD> &bdds, std::vector<int> &indices, const std::string &filename) const {
     int size = bdds.size();
     std::ofstream filestream;
@@ -223,9 +237,11 @@ void CuddManager::dumpBDDs_certificate(std::vector<CuddBDD> &bdds, std::vector<i
         filestream << "\n";
         filestream.close();
         FILE *fp;
-        fp = fopen(filename.c_str(), "a");
-        Dddmp_cuddBddArrayStore(ddmgr, NULL, size, &bdd_arr[0], NULL,
-                                NULL, NULL, DDDMP_MODE_TEXT, DDDMP_VARIDS, NULL, fp);
+        // not opened in append mode since store_bdd_array needs to seek
+        fp = fopen(filename.c_str(), "r+");
+        fseek(fp, 0, SEEK_END);
+        store_bdd_array(size, &bdd_arr[0], fp);
+        fclose(fp);
     }
     filestream.close();
 }
@@ -242,7 +258,9 @@ void CuddManager::dumpBDDs(std::vector<CuddBDD> &bdds, const std::string filenam
     stream.close();
 
     FILE *fp;
-    fp = fopen(filename.c_str(), "a");
+    // not opened in append mode since store_bdd_array needs to seek
+    fp = fopen(filename.c_str(), "r+");
+    fseek(fp, 0, SEEK_END);
 
     if (compact_proof) {
         int size = bdds.size();
@@ -252,21 +270,24 @@ void CuddManager::dumpBDDs(std::vector<CuddBDD> &bdds, const std::string filenam
             bdd_arr[i] = bdds[i].bdd;
         }
         fprintf (fp, "\n");
-        Dddmp_cuddBddArrayStore(ddmgr, NULL, size, &bdd_arr[0], NULL,
-                                    NULL, NULL, DDDMP_MODE_TEXT, DDDMP_VARIDS, NULL, fp);
+        store_bdd_array(size, &bdd_arr[0], fp);
     } else {
         DdNode** bdd_arr = new DdNode*[1];
         for (size_t i = 0; i < bdds.size(); ++i) {
             fprintf (fp, "%d\n",(int)i);
             bdd_arr[0] = bdds[i].bdd;
-            Dddmp_cuddBddArrayStore(ddmgr, NULL, 1, &bdd_arr[0], NULL,
-                                    NULL, NULL, DDDMP_MODE_TEXT, DDDMP_VARIDS, NULL, fp);
+            store_bdd_array(1, &bdd_arr[0], fp);
         }
     }
+    fclose(fp);
 }
 
 void CuddManager::set_compact_proof(bool val) {
     compact_proof = val;
 }
 
+void CuddManager::set_binary_dump(bool val) {
+    binary_dump = val;
+}
+
 #endif
@@ -54,6 +54,8 @@ public:
                         const std::vector<std::pair<int,int>> &pos_facts,
                         const std::vector<std::pair<int,int>> &neg_facts))
     CUDD_METHOD(CuddBDD(const CuddBDD& from))
+    // copies a BDD from another manager (with the same variable order)
+    CUDD_METHOD(CuddBDD(CuddManager *manager, const CuddBDD& from))
     CUDD_METHOD(~CuddBDD())
     CUDD_METHOD(CuddBDD operator=(const CuddBDD& right))
     CUDD_METHOD(void land(int var, int val, bool neg = false))
@@ -80,6 +82,7 @@ class CuddManager {
 private:
 #ifdef USE_CUDD
     static bool compact_proof;
+    static bool binary_dump;
     DdManager* ddmgr;
     std::vector<int> var_order;
     std::vector<std::vector<int>> fact_to_var;
@@ -89,6 +92,8 @@ private:
     // Use task_proxy to access task information.
     TaskProxy task_proxy;
     int bdd_varamount;
+
+    void store_bdd_array(int size, DdNode **bdd_arr, FILE *fp) const;
 #endif
 public:
     // uses default var order
@@ -98,6 +103,8 @@ public:
     CUDD_METHOD(void dumpBDDs_certificate(std::vector<CuddBDD> &bdds, std::vector<int> &indices, const std::string &filename) const)
     CUDD_METHOD(void dumpBDDs(std::vector<CuddBDD> &bdds, const std::string filename) const)
     CUDD_METHOD(static void set_compact_proof(bool val))
+    // dump BDDs in the binary DDDMP format instead of the text format
+    CUDD_METHOD(static void set_binary_dump(bool val))
 };
 
 #endif
@@ -0,0 +1,122 @@
+#include "last_occ_tracker.h"
+
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+
+namespace proof_parsing {
+void skip_spaces(const char *&pos) {
+    while (*pos == ' ') {
+        ++pos;
+    }
+}
+
+int parse_int(const char *&pos) {
+    skip_spaces(pos);
+    char *end;
+    long value = strtol(pos, &end, 10);
+    if (end == pos) {
+        cerr << "Proof: expected a number at \"" << pos << "\"" << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+    pos = end;
+    return static_cast<int>(value);
+}
+
+string parse_word(const char *&pos) {
+    skip_spaces(pos);
+    const char *begin = pos;
+    while (*pos != ' ' && *pos != '\0') {
+        ++pos;
+    }
+    return string(begin, pos);
+}
+}
+
+using namespace proof_parsing;
+
+void LastOccTracker::register_set(int setid) {
+    if (setid >= static_cast<int>(last_occ.size())) {
+        last_occ.resize(setid + 1, -1);
+        is_constant.resize(setid + 1, false);
+    }
+}
+
+void LastOccTracker::add_basic_set(int setid, bool constant) {
+    register_set(setid);
+    is_constant[setid] = constant;
+}
+
+void LastOccTracker::add_compound_set(int setid, int subset1, int subset2) {
+    register_set(setid);
+    compound_sets.push_back({{setid, subset1, subset2}});
+}
+
+void LastOccTracker::add_basic_statement(int kid, int setid1, int setid2) {
+    register_set(max(setid1, setid2));
+    last_occ[setid1] = kid;
+    last_occ[setid2] = kid;
+}
+
+void LastOccTracker::observe_line(const string &line) {
+    const char *pos = line.c_str();
+    skip_spaces(pos);
+    if (*pos == 'e' && pos[1] == ' ') {
+        ++pos;
+        int setid = parse_int(pos);
+        string type = parse_word(pos);
+        if (type == "n" || type == "p" || type == "r") {
+            add_compound_set(setid, parse_int(pos));
+        } else if (type == "i" || type == "u") {
+            int left = parse_int(pos);
+            int right = parse_int(pos);
+            add_compound_set(setid, left, right);
+        } else {
+            add_basic_set(setid, type == "c");
+        }
+    } else if (*pos == 'k' && pos[1] == ' ') {
+        ++pos;
+        int kid = parse_int(pos);
+        if (parse_word(pos) != "s") {
+            return;
+        }
+        int setid1 = parse_int(pos);
+        int setid2 = parse_int(pos);
+        string rule = parse_word(pos);
+        if (rule == "b1" || rule == "b2" || rule == "b3" || rule == "b4") {
+            add_basic_statement(kid, setid1, setid2);
+        }
+    }
+}
+
+vector<int> LastOccTracker::get_last_occ() const {
+    vector<int> result(last_occ);
+    /*
+      Subsets are needed as long as the compound set is needed. Since compound
+      sets are declared after their subsets, going backwards over the
+      declarations propagates the last occurence top down.
+    */
+    for (auto it = compound_sets.rbegin(); it != compound_sets.rend(); ++it) {
+        int cset = (*it)[0];
+        for (int i = 1; i < 3; ++i) {
+            int subset = (*it)[i];
+            if (subset >= 0) {
+                if (subset >= static_cast<int>(result.size())) {
+                    result.resize(subset + 1, -1);
+                }
+                result[subset] = max(result[subset], result[cset]);
+            }
+        }
+    }
+    // constant sets are never discarded
+    for (size_t i = 0; i < is_constant.size(); ++i) {
+        if (is_constant[i]) {
+            result[i] = -1;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,43 @@
+#ifndef UNSOLVABILITY_LAST_OCC_TRACKER_H
+#define UNSOLVABILITY_LAST_OCC_TRACKER_H
+
+#include <array>
+#include <string>
+#include <vector>
+
+/*
+  Computes while writing the proof for each set expression the last
+  knowledge which needs its actual representation. This is the same
+  information the proof verifier otherwise gathers in an additional pass
+  over the proof when discarding formulas (ProofChecker::first_pass).
+
+  Only basic statements B1-B4 need the actual representation of a set.
+  A set is additionally needed as long as any compound set containing it
+  is needed; this is resolved in get_last_occ().
+*/
+class LastOccTracker {
+    std::vector<int> last_occ;
+    std::vector<bool> is_constant;
+    // compound set id and up to two subset ids (-1 if unused), in declaration order
+    std::vector<std::array<int, 3>> compound_sets;
+
+    void register_set(int setid);
+public:
+    void add_basic_set(int setid, bool constant);
+    void add_compound_set(int setid, int subset1, int subset2 = -1);
+    void add_basic_statement(int kid, int setid1, int setid2);
+
+    // parses a line of the textual proof format and records what it declares
+    void observe_line(const std::string &line);
+
+    // -1 means that the set should never be discarded
+    std::vector<int> get_last_occ() const;
+};
+
+namespace proof_parsing {
+void skip_spaces(const char *&pos);
+int parse_int(const char *&pos);
+std::string parse_word(const char *&pos);
+}
+
+#endif
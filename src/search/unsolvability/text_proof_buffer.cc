@@ -0,0 +1,75 @@
+#include "text_proof_buffer.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+TextProofBuffer::TextProofBuffer(const string &filename)
+    : out(filename), written(0), finished(false) {
+}
+
+TextProofBuffer::~TextProofBuffer() {
+    finish();
+}
+
+void TextProofBuffer::end_line() {
+    last_occ_tracker.observe_line(line);
+    line.clear();
+}
+
+TextProofBuffer::int_type TextProofBuffer::overflow(int_type c) {
+    if (traits_type::eq_int_type(c, traits_type::eof())) {
+        return traits_type::not_eof(c);
+    }
+    char ch = traits_type::to_char_type(c);
+    out.put(ch);
+    ++written;
+    if (ch == '\n') {
+        end_line();
+    } else {
+        line.push_back(ch);
+    }
+    return c;
+}
+
+streamsize TextProofBuffer::xsputn(const char *s, streamsize n) {
+    out.write(s, n);
+    written += n;
+    const char *end = s + n;
+    while (s != end) {
+        const char *newline = static_cast<const char *>(memchr(s, '\n', end - s));
+        if (!newline) {
+            line.append(s, end);
+            break;
+        }
+        line.append(s, newline);
+        end_line();
+        s = newline + 1;
+    }
+    return n;
+}
+
+void TextProofBuffer::finish() {
+    if (finished) {
+        return;
+    }
+    if (!line.empty()) {
+        out.put('\n');
+        ++written;
+        end_line();
+    }
+    uint64_t trailer_pos = written;
+    vector<int> last_occ = last_occ_tracker.get_last_occ();
+    out << "#last_occ " << last_occ.size();
+    for (int kid : last_occ) {
+        out << " " << kid;
+    }
+    char offset[32];
+    snprintf(offset, sizeof(offset), "%020llu",
+             static_cast<unsigned long long>(trailer_pos));
+    out << "\n#last_occ_offset " << offset << "\n";
+    out.close();
+    finished = true;
+}
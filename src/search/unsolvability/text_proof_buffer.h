@@ -0,0 +1,41 @@
+#ifndef UNSOLVABILITY_TEXT_PROOF_BUFFER_H
+#define UNSOLVABILITY_TEXT_PROOF_BUFFER_H
+
+#include "last_occ_tracker.h"
+
+#include <cstdint>
+#include <fstream>
+#include <streambuf>
+#include <string>
+
+/*
+  Stream buffer writing the textual proof unchanged to a file while keeping
+  track of the last use of each set expression. On finish() this is written
+  as a trailer consisting of two comment lines:
+    #last_occ <n> <last_occ of set 0> ... <last_occ of set n-1>
+    #last_occ_offset <byte offset of the #last_occ line, 20 digits>
+  The verifier finds the trailer by reading the fixed size last line and can
+  then discard formulas without an additional pass over the proof. Since the
+  trailer consists of comments, it is ignored by verifiers not knowing it.
+*/
+class TextProofBuffer : public std::streambuf {
+    std::ofstream out;
+    std::string line;
+    uint64_t written;
+    bool finished;
+
+    LastOccTracker last_occ_tracker;
+
+    void end_line();
+protected:
+    virtual int_type overflow(int_type c) override;
+    virtual std::streamsize xsputn(const char *s, std::streamsize n) override;
+public:
+    explicit TextProofBuffer(const std::string &filename);
+    virtual ~TextProofBuffer() override;
+
+    // writes the trailer; no further lines can be written afterwards
+    void finish();
+};
+
+#endif
@@ -1,27 +1,47 @@
 #include "unsolvabilitymanager.h"
 
+#include "binary_proof_buffer.h"
+#include "text_proof_buffer.h"
+
 #include "../utils/system.h"
 #include "../task_proxy.h"
 
 
 UnsolvabilityManager::UnsolvabilityManager(
-        std::string directory, std::shared_ptr<AbstractTask> task)
+        std::string directory, std::shared_ptr<AbstractTask> task, ProofFormat format)
     : task(task), task_proxy(*task), setcount(0), knowledgecount(0), directory(directory) {
-    certstream.open(directory + "proof.txt");
+    if (format == ProofFormat::BINARY) {
+        binary_buffer.reset(new BinaryProofBuffer(directory + "proof.bin"));
+        certstream.reset(new std::ostream(binary_buffer.get()));
+    } else {
+        text_buffer.reset(new TextProofBuffer(directory + "proof.txt"));
+        certstream.reset(new std::ostream(text_buffer.get()));
+    }
 
     emptysetid = setcount++;
-    certstream << "e " << emptysetid << " c e\n";
+    *certstream << "e " << emptysetid << " c e\n";
     goalsetid = setcount++;
-    certstream << "e " << goalsetid << " c g\n";
+    *certstream << "e " << goalsetid << " c g\n";
     initsetid = setcount++;
-    certstream << "e " << initsetid << " c i\n";
+    *certstream << "e " << initsetid << " c i\n";
     k_empty_dead = knowledgecount++;
-    certstream << "k " << k_empty_dead << " d " << emptysetid << " d1\n";
-    certstream << "a 0 a\n";
+    *certstream << "k " << k_empty_dead << " d " << emptysetid << " d1\n";
+    *certstream << "a 0 a\n";
 
     hex = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e' , 'f'};
 }
 
+UnsolvabilityManager::~UnsolvabilityManager() {
+    certstream->flush();
+    // the stream needs to be destroyed before the buffer it writes to
+    certstream.reset();
+    if (binary_buffer) {
+        binary_buffer->finish();
+    } else {
+        text_buffer->finish();
+    }
+}
+
 int UnsolvabilityManager::get_new_setid() {
     return setcount++;
 }
@@ -42,8 +62,8 @@ int UnsolvabilityManager::get_k_empty_dead() {
     return k_empty_dead;
 }
 
-std::ofstream &UnsolvabilityManager::get_stream() {
-    return certstream;
+std::ostream &UnsolvabilityManager::get_stream() {
+    return *certstream;
 }
 
 std::string &UnsolvabilityManager::get_directory() {
@@ -52,6 +72,10 @@ std::string &UnsolvabilityManager::get_directory() {
 
 
 void UnsolvabilityManager::dump_state(const GlobalState &state) {
+    dump_state(state, *certstream);
+}
+
+void UnsolvabilityManager::dump_state(const GlobalState &state, std::ostream &out) const {
     int c = 0;
     int count = 3;
     for(size_t i = 0; i < task_proxy.get_variables().size(); ++i) {
@@ -61,13 +85,13 @@ void UnsolvabilityManager::dump_state(const GlobalState &state) {
             }
             count--;
             if(count==-1) {
-                certstream << hex[c];
+                out << hex[c];
                 c = 0;
                 count = 3;
             }
         }
     }
     if(count != 3) {
-        certstream << hex[c];
+        out << hex[c];
     }
 }
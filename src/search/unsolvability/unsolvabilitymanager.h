@@ -6,7 +6,15 @@
 #include "../task_proxy.h"
 
 #include <fstream>
+#include <memory>
 
+class BinaryProofBuffer;
+class TextProofBuffer;
+
+enum class ProofFormat {
+    TEXT,
+    BINARY
+};
 
 class UnsolvabilityManager
 {
@@ -22,13 +30,17 @@ private:
     int initsetid;
     int k_empty_dead;
 
-    std::ofstream certstream;
+    std::unique_ptr<BinaryProofBuffer> binary_buffer;
+    std::unique_ptr<TextProofBuffer> text_buffer;
+    std::unique_ptr<std::ostream> certstream;
 
     std::string directory;
     std::vector<char> hex;
 
 public:
-    UnsolvabilityManager(std::string directory, std::shared_ptr<AbstractTask> task);
+    UnsolvabilityManager(std::string directory, std::shared_ptr<AbstractTask> task,
+                         ProofFormat format = ProofFormat::TEXT);
+    ~UnsolvabilityManager();
 
     int get_new_setid();
     int get_new_knowledgeid();
@@ -38,11 +50,13 @@ public:
     int get_initsetid();
     int get_k_empty_dead();
 
-    std::ofstream &get_stream();
+    std::ostream &get_stream();
 
     std::string &get_directory();
 
     void dump_state(const GlobalState &state);
+    // writes the state to out instead of the proof (can be called concurrently)
+    void dump_state(const GlobalState &state, std::ostream &out) const;
 };
 
 #endif // UNSOLVABILITYMANAGER_H
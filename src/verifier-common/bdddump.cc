@@ -0,0 +1,77 @@
+#include "bdddump.h"
+
+#include <cctype>
+#include <cstdlib>
+
+#include "dddmp.h"
+
+void store_bdd_dump(DdManager *manager, int size, DdNode **bdds, bool binary, FILE *fp) {
+    if (!binary) {
+        Dddmp_cuddBddArrayStore(manager, NULL, size, bdds, NULL,
+                                NULL, NULL, DDDMP_MODE_TEXT, DDDMP_VARIDS, NULL, fp);
+        return;
+    }
+    // the size is only known after dumping, so we fill it in afterwards
+    long size_pos = ftell(fp);
+    fprintf(fp, "bin %020ld\n", 0L);
+    long start = ftell(fp);
+    Dddmp_cuddBddArrayStore(manager, NULL, size, bdds, NULL,
+                            NULL, NULL, DDDMP_MODE_BINARY, DDDMP_VARIDS, NULL, fp);
+    long end = ftell(fp);
+    fseek(fp, size_pos, SEEK_SET);
+    fprintf(fp, "bin %020ld\n", end - start);
+    fseek(fp, end, SEEK_SET);
+}
+
+bool read_binary_dump_header(FILE *fp, long &size) {
+    int c;
+    do {
+        c = fgetc(fp);
+    } while (isspace(c));
+    ungetc(c, fp);
+    if (c != 'b') {
+        return false;
+    }
+    if (fscanf(fp, "bin %ld", &size) != 1 || fgetc(fp) != '\n' || size < 0) {
+        size = -1;
+    }
+    return true;
+}
+
+std::vector<int> interleaved_compose(const std::vector<int> &positions) {
+    std::vector<int> compose(positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        compose[positions[i]] = 2*i;
+    }
+    return compose;
+}
+
+std::vector<DdNode *> load_bdd_dump(DdManager *manager, FILE *fp, long binary_size,
+                                    std::vector<int> &compose) {
+    bool binary = (binary_size >= 0);
+    long dump_end = binary ? ftell(fp) + binary_size : -1;
+    DdNode **roots = NULL;
+    /* read in the BDDs into an array of DdNodes. The parameters are as follows:
+     *  - manager
+     *  - how to match roots: we want them to be matched by id
+     *  - root names: only needed when you want to match roots by name
+     *  - how to match variables: since we want to permute the BDDs in order to
+     *    allow primed variables in between the original one, we take COMPOSEIDS
+     *  - varnames: needed if you want to match vars according to names
+     *  - varmatchauxids: needed if you want to match vars according to auxidc
+     *  - varcomposeids: the variable permutation if you want to permute the BDDs
+     *  - mode: if the file was dumped in text or in binary mode
+     *  - filename: needed if you don't directly pass the FILE *
+     *  - FILE*
+     *  - Pointer to array where the DdNodes should be saved to
+     */
+    int amount = Dddmp_cuddBddArrayLoad(manager, DDDMP_ROOT_MATCHLIST, NULL,
+        DDDMP_VAR_COMPOSEIDS, NULL, NULL, compose.data(),
+        binary ? DDDMP_MODE_BINARY : DDDMP_MODE_TEXT, NULL, fp, &roots);
+    if (binary) {
+        fseek(fp, dump_end, SEEK_SET);
+    }
+    std::vector<DdNode *> bdds(roots, roots + (amount > 0 ? amount : 0));
+    free(roots);
+    return bdds;
+}
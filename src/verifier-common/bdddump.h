@@ -0,0 +1,48 @@
+#ifndef BDDDUMP_H
+#define BDDDUMP_H
+
+#include <cstdio>
+#include <vector>
+
+#include "cudd.h"
+
+/*
+ * DDDMP I/O shared by the planner and both verifiers.
+ *
+ * The planner dumps BDDs over the unprimed variables only, either in text
+ * mode (ending with the ".end" line) or in binary mode. Binary dumps are
+ * preceded by a line "bin <size in bytes>", which lets readers detect the
+ * mode and find the end of the dump without decoding it.
+ *
+ * The verifiers place the primed copy of a variable directly after the
+ * variable itself (see BDDTransitionRelation), so dumps are loaded with a
+ * compose array moving each dump variable to an even BDD variable.
+ */
+
+// stores the bdds at the current position of fp, which must be seekable for binary dumps
+void store_bdd_dump(DdManager *manager, int size, DdNode **bdds, bool binary, FILE *fp);
+
+/*
+ * Skips whitespace and reads the "bin <size>" line if there is one. Returns
+ * false for text dumps; for binary dumps, size is set to the size of the
+ * dump (or to -1 if the line is malformed).
+ */
+bool read_binary_dump_header(FILE *fp, long &size);
+
+/*
+ * Returns the compose array moving dump variable positions[i] to the BDD
+ * variable 2*i. With positions being the identity, the variable order of
+ * the dump is kept.
+ */
+std::vector<int> interleaved_compose(const std::vector<int> &positions);
+
+/*
+ * Loads the dump at the current position of fp and returns its roots, which
+ * are referenced. For binary dumps, binary_size is the size read by
+ * read_binary_dump_header and fp is positioned after the dump afterwards;
+ * for text dumps, it is negative.
+ */
+std::vector<DdNode *> load_bdd_dump(DdManager *manager, FILE *fp, long binary_size,
+                                    std::vector<int> &compose);
+
+#endif // BDDDUMP_H
@@ -0,0 +1,342 @@
+#include "bddtransitionrelation.h"
+
+#include <algorithm>
+#include <cassert>
+
+BDDTransitionRelation::BDDTransitionRelation()
+    : manager(nullptr), node_threshold(DEFAULT_NODE_THRESHOLD), clusters_built(false),
+      precondition_tree_built(false) {
+}
+
+BDDTransitionRelation::BDDTransitionRelation(Cudd &manager, const std::vector<int> &varorder,
+                                             int node_threshold)
+    : manager(&manager), varorder(varorder), node_threshold(node_threshold),
+      clusters_built(false), precondition_tree_built(false) {
+}
+
+BDD BDDTransitionRelation::var(int global_var, bool primed) const {
+    return manager->bddVar(2*varorder[global_var] + (primed ? 1 : 0));
+}
+
+void BDDTransitionRelation::add_action(const std::vector<int> &pre,
+                                       const std::vector<int> &change) {
+    assert(!clusters_built && !precondition_tree_built);
+    BDD pre_bdd = manager->bddOne();
+    for (int v : pre) {
+        pre_bdd *= var(v, false);
+    }
+    action_pre.push_back(pre_bdd);
+    std::vector<int> pre_vars(pre);
+    std::sort(pre_vars.begin(), pre_vars.end(), [this](int v1, int v2) {
+        return varorder[v1] < varorder[v2];
+    });
+    pre_vars.erase(std::unique(pre_vars.begin(), pre_vars.end()), pre_vars.end());
+    action_pre_vars.push_back(std::move(pre_vars));
+    std::vector<std::pair<int, bool>> eff;
+    for (size_t v = 0; v < change.size(); ++v) {
+        if (change[v] != 0) {
+            eff.push_back(std::make_pair(v, change[v] == 1));
+        }
+    }
+    action_eff.push_back(std::move(eff));
+    action_frames.emplace_back();
+}
+
+int BDDTransitionRelation::get_number_of_actions() const {
+    return action_pre.size();
+}
+
+// cluster_vars must be sorted and contain all variables changed by the action
+BDD BDDTransitionRelation::action_relation(int action,
+                                           const std::vector<int> &cluster_vars) const {
+    BDD relation = action_pre[action];
+    const std::vector<std::pair<int, bool>> &eff = action_eff[action];
+    size_t eff_pos = 0;
+    for (int v : cluster_vars) {
+        if (eff_pos < eff.size() && eff[eff_pos].first == v) {
+            relation *= eff[eff_pos].second ? var(v, true) : !var(v, true);
+            eff_pos++;
+        } else {
+            relation *= var(v, true).Xnor(var(v, false));
+        }
+    }
+    assert(eff_pos == eff.size());
+    return relation;
+}
+
+void BDDTransitionRelation::initialize_cluster(Cluster &cluster, int action) const {
+    cluster.actions.assign(1, action);
+    cluster.vars.clear();
+    for (const std::pair<int, bool> &e : action_eff[action]) {
+        cluster.vars.push_back(e.first);
+    }
+    cluster.relation = action_relation(action, cluster.vars);
+}
+
+void BDDTransitionRelation::finalize_cluster(Cluster &cluster) const {
+    cluster.cube = manager->bddOne();
+    cluster.primed_cube = manager->bddOne();
+    cluster.unprimed_vars.clear();
+    cluster.primed_vars.clear();
+    for (int v : cluster.vars) {
+        cluster.cube *= var(v, false);
+        cluster.primed_cube *= var(v, true);
+        cluster.unprimed_vars.push_back(var(v, false));
+        cluster.primed_vars.push_back(var(v, true));
+    }
+}
+
+void BDDTransitionRelation::build_clusters() {
+    std::vector<int> order(get_number_of_actions());
+    for (size_t a = 0; a < order.size(); ++a) {
+        order[a] = a;
+    }
+    // actions changing similar variables end up next to each other
+    std::stable_sort(order.begin(), order.end(), [this](int a1, int a2) {
+        return action_eff[a1] < action_eff[a2];
+    });
+
+    Cluster current;
+    bool has_current = false;
+    for (int a : order) {
+        if (!has_current) {
+            initialize_cluster(current, a);
+            has_current = true;
+            continue;
+        }
+        std::vector<int> vars;
+        std::vector<int> action_vars;
+        for (const std::pair<int, bool> &e : action_eff[a]) {
+            action_vars.push_back(e.first);
+        }
+        std::set_union(current.vars.begin(), current.vars.end(),
+                       action_vars.begin(), action_vars.end(), std::back_inserter(vars));
+
+        // extend the frame of the cluster to the new variables
+        BDD relation = current.relation;
+        std::vector<int> new_vars;
+        std::set_difference(vars.begin(), vars.end(), current.vars.begin(), current.vars.end(),
+                            std::back_inserter(new_vars));
+        for (int v : new_vars) {
+            relation *= var(v, true).Xnor(var(v, false));
+        }
+        relation += action_relation(a, vars);
+
+        if (relation.nodeCount() > node_threshold) {
+            finalize_cluster(current);
+            clusters.push_back(std::move(current));
+            current = Cluster();
+            initialize_cluster(current, a);
+        } else {
+            current.actions.push_back(a);
+            current.vars = std::move(vars);
+            current.relation = relation;
+        }
+    }
+    if (has_current) {
+        finalize_cluster(current);
+        clusters.push_back(std::move(current));
+    }
+    action_cluster.resize(get_number_of_actions());
+    for (size_t i = 0; i < clusters.size(); ++i) {
+        for (int a : clusters[i].actions) {
+            action_cluster[a] = i;
+        }
+    }
+    clusters_built = true;
+}
+
+BDD BDDTransitionRelation::cluster_image(const BDD &set, const Cluster &cluster) const {
+    BDD res = set.AndAbstract(cluster.relation, cluster.cube);
+    return res.SwapVariables(cluster.primed_vars, cluster.unprimed_vars);
+}
+
+BDD BDDTransitionRelation::cluster_preimage(const BDD &set, const Cluster &cluster) const {
+    BDD primed_set = set.SwapVariables(cluster.unprimed_vars, cluster.primed_vars);
+    return primed_set.AndAbstract(cluster.relation, cluster.primed_cube);
+}
+
+const BDDTransitionRelation::Cluster &BDDTransitionRelation::get_action_frame(int action) {
+    std::unique_ptr<Cluster> &frame = action_frames[action];
+    if (!frame) {
+        frame.reset(new Cluster());
+        initialize_cluster(*frame, action);
+        finalize_cluster(*frame);
+    }
+    return *frame;
+}
+
+BDD BDDTransitionRelation::image(const BDD &set, int action) {
+    return cluster_image(set, get_action_frame(action));
+}
+
+BDD BDDTransitionRelation::preimage(const BDD &set, int action) {
+    return cluster_preimage(set, get_action_frame(action));
+}
+
+bool BDDTransitionRelation::check_all(const BDD &set, const ImageCheck &check,
+                                      const std::unordered_set<int> *actions, bool forward) {
+    if (!clusters_built) {
+        build_clusters();
+    }
+    if (!actions) {
+        for (const Cluster &cluster : clusters) {
+            BDD res = forward ? cluster_image(set, cluster) : cluster_preimage(set, cluster);
+            if (!check(res, cluster.actions)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // use the cluster relation for clusters whose actions are all contained in actions
+    std::vector<int> contained(clusters.size(), 0);
+    for (int a : *actions) {
+        contained[action_cluster[a]]++;
+    }
+    for (size_t i = 0; i < clusters.size(); ++i) {
+        if (contained[i] > 0 && contained[i] == static_cast<int>(clusters[i].actions.size())) {
+            BDD res = forward ? cluster_image(set, clusters[i]) : cluster_preimage(set, clusters[i]);
+            if (!check(res, clusters[i].actions)) {
+                return false;
+            }
+        }
+    }
+    std::vector<int> single_action(1);
+    for (int a : *actions) {
+        const Cluster &cluster = clusters[action_cluster[a]];
+        if (contained[action_cluster[a]] == static_cast<int>(cluster.actions.size())) {
+            continue;
+        }
+        single_action[0] = a;
+        BDD res = forward ? image(set, a) : preimage(set, a);
+        if (!check(res, single_action)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BDDTransitionRelation::check_images(const BDD &set, const ImageCheck &check,
+                                         const std::unordered_set<int> *actions) {
+    return check_all(set, check, actions, true);
+}
+
+bool BDDTransitionRelation::check_preimages(const BDD &set, const ImageCheck &check,
+                                            const std::unordered_set<int> *actions) {
+    return check_all(set, check, actions, false);
+}
+
+int BDDTransitionRelation::build_precondition_node(std::vector<std::pair<int, size_t>> &entries) {
+    int index = precondition_tree.size();
+    precondition_tree.emplace_back();
+    PreconditionNode node;
+    node.var = -1;
+    // test the untested precondition variable with the lowest level first
+    for (const std::pair<int, size_t> &entry : entries) {
+        const std::vector<int> &pre_vars = action_pre_vars[entry.first];
+        if (entry.second == pre_vars.size()) {
+            node.actions.push_back(entry.first);
+        } else if (node.var == -1 || varorder[pre_vars[entry.second]] < varorder[node.var]) {
+            node.var = pre_vars[entry.second];
+        }
+    }
+    std::vector<std::pair<int, size_t>> requires_entries;
+    std::vector<std::pair<int, size_t>> dont_care_entries;
+    for (const std::pair<int, size_t> &entry : entries) {
+        const std::vector<int> &pre_vars = action_pre_vars[entry.first];
+        if (entry.second == pre_vars.size()) {
+            continue;
+        } else if (pre_vars[entry.second] == node.var) {
+            requires_entries.push_back(std::make_pair(entry.first, entry.second+1));
+        } else {
+            dont_care_entries.push_back(entry);
+        }
+    }
+    entries.clear();
+    entries.shrink_to_fit();
+    node.requires = requires_entries.empty() ? -1 : build_precondition_node(requires_entries);
+    node.dont_care = dont_care_entries.empty() ? -1 : build_precondition_node(dont_care_entries);
+    precondition_tree[index] = std::move(node);
+    return index;
+}
+
+void BDDTransitionRelation::collect_applicable(int node, const BDD &set,
+                                               std::vector<int> &applicable) const {
+    const PreconditionNode &current = precondition_tree[node];
+    applicable.insert(applicable.end(), current.actions.begin(), current.actions.end());
+    if (current.dont_care != -1) {
+        collect_applicable(current.dont_care, set, applicable);
+    }
+    if (current.requires != -1) {
+        BDD cofactor = set.Cofactor(var(current.var, false));
+        if (!cofactor.IsZero()) {
+            collect_applicable(current.requires, cofactor, applicable);
+        }
+    }
+}
+
+// cube contains the value of each BDD variable (0 = false, 1 = true, 2 = don't care)
+void BDDTransitionRelation::collect_applicable(int node, const std::vector<int> &cube,
+                                               std::vector<int> &applicable) const {
+    const PreconditionNode &current = precondition_tree[node];
+    applicable.insert(applicable.end(), current.actions.begin(), current.actions.end());
+    if (current.dont_care != -1) {
+        collect_applicable(current.dont_care, cube, applicable);
+    }
+    if (current.requires != -1 && cube[2*varorder[current.var]] != 0) {
+        collect_applicable(current.requires, cube, applicable);
+    }
+}
+
+std::vector<int> BDDTransitionRelation::get_applicable_actions(const BDD &set) {
+    if (!precondition_tree_built) {
+        std::vector<std::pair<int, size_t>> entries;
+        entries.reserve(get_number_of_actions());
+        for (int a = 0; a < get_number_of_actions(); ++a) {
+            entries.push_back(std::make_pair(a, 0));
+        }
+        if (!entries.empty()) {
+            build_precondition_node(entries);
+        }
+        precondition_tree_built = true;
+    }
+    std::vector<int> applicable;
+    if (precondition_tree.empty() || set.IsZero()) {
+        return applicable;
+    }
+    if (set.IsCube()) {
+        std::vector<int> cube(manager->ReadSize());
+        Cudd_BddToCubeArray(manager->getManager(), set.getNode(), cube.data());
+        collect_applicable(0, cube, applicable);
+    } else {
+        collect_applicable(0, set, applicable);
+    }
+    std::sort(applicable.begin(), applicable.end());
+    return applicable;
+}
+
+bool BDDTransitionRelation::check_applicable_images(const BDD &set, const ImageCheck &check) {
+    if (!clusters_built) {
+        build_clusters();
+    }
+    std::vector<int> applicable = get_applicable_actions(set);
+    std::stable_sort(applicable.begin(), applicable.end(), [this](int a1, int a2) {
+        return action_cluster[a1] < action_cluster[a2];
+    });
+    std::vector<int> cluster_actions;
+    size_t pos = 0;
+    while (pos < applicable.size()) {
+        int cluster = action_cluster[applicable[pos]];
+        cluster_actions.clear();
+        while (pos < applicable.size() && action_cluster[applicable[pos]] == cluster) {
+            cluster_actions.push_back(applicable[pos]);
+            pos++;
+        }
+        // the inapplicable actions of the cluster do not contribute to the image
+        if (!check(cluster_image(set, clusters[cluster]), cluster_actions)) {
+            return false;
+        }
+    }
+    return true;
+}
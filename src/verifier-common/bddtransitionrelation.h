@@ -0,0 +1,137 @@
+#ifndef BDDTRANSITIONRELATION_H
+#define BDDTRANSITIONRELATION_H
+
+#include <functional>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "cuddObj.hh"
+
+/*
+ * Image computation over a partitioned transition relation, shared by the
+ * certificate and the proof verifier.
+ *
+ * Both verifiers place the primed copy of a variable directly after the
+ * variable itself: global variable v corresponds to BDD variable
+ * 2*varorder[v], its primed version to 2*varorder[v]+1.
+ *
+ * Actions are grouped into clusters. A cluster stores one relation
+ * T(x,x') over the union V of the variables changed by its actions; for
+ * actions not changing some v in V it contains the frame x'_v <-> x_v.
+ * The image of a set S under all actions of a cluster is then a single
+ * relational product (exists x_V. S and T) followed by renaming x'_V to x_V,
+ * instead of one permutation per action. Actions are sorted by the variables
+ * they change and greedily added to the current cluster until its relation
+ * exceeds node_threshold nodes.
+ *
+ * Single actions are needed for action sets not covering whole clusters and
+ * for the per-action checks of the certificate verifier. Their frames
+ * (relation, cube and the variable pairs to swap) are built on first use and
+ * cached, so no check needs to set up anything over all facts.
+ *
+ * For checks that look at each action separately, get_applicable_actions
+ * filters out actions whose precondition is disjoint from the set. It uses a
+ * decision tree over the preconditions (like the successor generator of the
+ * planner): each node tests one variable; actions requiring it are below the
+ * requires child, all other actions below the dont_care child. For cubes
+ * (such as single states), a branch is skipped if the cube sets the variable
+ * to false; for other sets, the set is cofactored along the requires branch
+ * and the branch is skipped once the cofactor is empty.
+ */
+class BDDTransitionRelation {
+public:
+    /*
+     * Called with the (pre)image of a set under the actions in the given
+     * vector; returning false stops the iteration.
+     */
+    typedef std::function<bool(const BDD &, const std::vector<int> &)> ImageCheck;
+private:
+    struct Cluster {
+        std::vector<int> actions;
+        // changed global variables, sorted
+        std::vector<int> vars;
+        BDD relation;
+        BDD cube;
+        BDD primed_cube;
+        std::vector<BDD> unprimed_vars;
+        std::vector<BDD> primed_vars;
+    };
+
+    Cudd *manager;
+    std::vector<int> varorder;
+    int node_threshold;
+    std::vector<BDD> action_pre;
+    // changed global variables and their new value
+    std::vector<std::vector<std::pair<int, bool>>> action_eff;
+    std::vector<Cluster> clusters;
+    // index of the cluster containing each action
+    std::vector<int> action_cluster;
+    bool clusters_built;
+    // frames of single actions, built on demand
+    std::vector<std::unique_ptr<Cluster>> action_frames;
+
+    struct PreconditionNode {
+        // -1 for nodes without children
+        int var;
+        int requires;
+        int dont_care;
+        // actions whose precondition is fully tested on the path to this node
+        std::vector<int> actions;
+    };
+    // precondition variables of each action, sorted by their BDD level
+    std::vector<std::vector<int>> action_pre_vars;
+    std::vector<PreconditionNode> precondition_tree;
+    bool precondition_tree_built;
+
+    BDD var(int global_var, bool primed) const;
+    BDD action_relation(int action, const std::vector<int> &cluster_vars) const;
+    void initialize_cluster(Cluster &cluster, int action) const;
+    void finalize_cluster(Cluster &cluster) const;
+    void build_clusters();
+    const Cluster &get_action_frame(int action);
+    BDD cluster_image(const BDD &set, const Cluster &cluster) const;
+    BDD cluster_preimage(const BDD &set, const Cluster &cluster) const;
+    bool check_all(const BDD &set, const ImageCheck &check,
+                   const std::unordered_set<int> *actions, bool forward);
+    // entries are pairs of actions and the position of the next untested precondition
+    int build_precondition_node(std::vector<std::pair<int, size_t>> &entries);
+    void collect_applicable(int node, const BDD &set, std::vector<int> &applicable) const;
+    void collect_applicable(int node, const std::vector<int> &cube,
+                            std::vector<int> &applicable) const;
+public:
+    static const int DEFAULT_NODE_THRESHOLD = 5000;
+
+    BDDTransitionRelation();
+    BDDTransitionRelation(Cudd &manager, const std::vector<int> &varorder,
+                          int node_threshold = DEFAULT_NODE_THRESHOLD);
+
+    // actions must be added in the order of their ids
+    void add_action(const std::vector<int> &pre, const std::vector<int> &change);
+    int get_number_of_actions() const;
+
+    BDD image(const BDD &set, int action);
+    BDD preimage(const BDD &set, int action);
+
+    /*
+     * Calls check for the images (preimages) of set under all actions
+     * (only those contained in actions if it is not null). Actions sharing
+     * a cluster are passed together; for clusters only partially contained
+     * in actions, check is called for each contained action separately.
+     * Returns false iff some call returned false.
+     */
+    bool check_images(const BDD &set, const ImageCheck &check,
+                      const std::unordered_set<int> *actions = nullptr);
+    bool check_preimages(const BDD &set, const ImageCheck &check,
+                         const std::unordered_set<int> *actions = nullptr);
+
+    // the (sorted) actions whose precondition is not disjoint from set
+    std::vector<int> get_applicable_actions(const BDD &set);
+    /*
+     * Like check_images, but check is only called for clusters containing
+     * some action applicable in set and only gets the applicable actions.
+     */
+    bool check_applicable_images(const BDD &set, const ImageCheck &check);
+};
+
+#endif // BDDTRANSITIONRELATION_H